@@ -32,7 +32,22 @@
 #include "search/search.h"
 #include "hash-table/hash-table.h"
 #include "hash-table/hash-table-gen.h"
+#include "hash-table/hash-table-open.h"
+#include "hash-table/hash-table-concurrent.h"
+#include "hash-table/hash-table-perfect.h"
+#include "filter/bloom-filter.h"
+#include "filter/cuckoo-filter.h"
+#include "sketch/hyperloglog.h"
+#include "sketch/count-min.h"
+#include "sketch/space-saving.h"
 #include "set/set.h"
+#include "set/roaring.h"
+#include "set/sorted-set.h"
+#include "set/thread-pool.h"
+#include "set/set-disjoint.h"
+#include "set/set-disjoint-concurrent.h"
 #include "graph/graph.h"
+#include "graph/graph-csr.h"
+#include "graph/graph-queue.h"
 
 #endif
@@ -0,0 +1,95 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * False positive rate, memory and throughput of the Bloom and cuckoo
+ * filters, from sizes fitting in the cache to sizes that do not. Lookups
+ * are random keys, half of them added. Build with CFLAGS=-mavx2 for the
+ * vector bit tests of the Bloom filter.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bloom-filter.h"
+#include "cuckoo-filter.h"
+
+#define N_LOOKUPS (1 << 22)
+#define SIZES 3
+
+static const int sizes[SIZES] = {1 << 14, 1 << 18, 1 << 22};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *filter, int size, size_t bytes, double add, double lookup, long positives, long present) {
+    printf("%s;%d;%.1f;%.3f;%.1f;%.1f\n", filter, size, 8.0 * bytes / size,
+           100.0 * (positives - present) / (N_LOOKUPS - present),
+           add * 1e9 / size, lookup * 1e9 / N_LOOKUPS);
+}
+
+// even keys are added, so odd lookups are the negatives
+static void benchmark_size(int size, const int *lookups, long present) {
+    double start = now_seconds();
+    BloomFilter *bloom = bloom_filter_create(size, BLOOM_FILTER_BITS_PER_KEY);
+    for (int i = 0; i < size; i++) {
+        bloom_filter_add(bloom, 2 * i);
+    }
+    double add = now_seconds() - start;
+    long positives = 0;
+    start = now_seconds();
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        positives += bloom_filter_contains(bloom, lookups[i]);
+    }
+    report("bloom", size, bloom_filter_bytes(bloom), add, now_seconds() - start, positives, present);
+    bloom_filter_free(bloom);
+
+    start = now_seconds();
+    CuckooFilter *cuckoo = cuckoo_filter_create(size);
+    for (int i = 0; i < size; i++) {
+        cuckoo_filter_add(cuckoo, 2 * i);
+    }
+    add = now_seconds() - start;
+    positives = 0;
+    start = now_seconds();
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        positives += cuckoo_filter_contains(cuckoo, lookups[i]);
+    }
+    report("cuckoo", size, cuckoo_filter_bytes(cuckoo), add, now_seconds() - start, positives, present);
+    cuckoo_filter_free(cuckoo);
+}
+
+int main(void) {
+    int *lookups = (int*) malloc(N_LOOKUPS * sizeof(int));
+    srand(42);
+#ifdef __AVX2__
+    printf("== %d lookups, AVX2 bit tests\n", N_LOOKUPS);
+#else
+    printf("== %d lookups, scalar bit tests\n", N_LOOKUPS);
+#endif
+    printf("Filter;Size;BitsPerKey;FalsePositives(%%);Add(ns);Contains(ns)\n");
+    for (int s = 0; s < SIZES; s++) {
+        long present = 0;
+        for (int i = 0; i < N_LOOKUPS; i++) {
+            lookups[i] = rand() % (2 * sizes[s]);
+            present += lookups[i] % 2 == 0;
+        }
+        benchmark_size(sizes[s], lookups, present);
+    }
+    free(lookups);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "bloom-filter.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define BLOCK_WORDS 8    // 32-bit words of a block, one bit set per word
+#define BLOCK_BYTES (BLOCK_WORDS * sizeof(uint32_t))
+#define CACHE_LINE 64
+
+// odd multipliers picking the bit of each word of the block
+#define SALTS 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, \
+              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+
+struct BloomFilter {
+    size_t capacity;
+    size_t size;      // keys added
+    size_t n_blocks;
+    uint32_t *blocks; // n_blocks * BLOCK_WORDS words, aligned to a cache line
+};
+
+// an independent hash from the one indexing hash tables, which may be the
+// same mixer over the same keys
+static inline uint64_t bloom_filter__hash(int key) {
+    return hash_mix64((uint32_t) key ^ 0x9e3779b97f4a7c15ULL);
+}
+
+static inline uint32_t* bloom_filter__block(const BloomFilter *f, uint64_t h) {
+    return f->blocks + hash_range((uint32_t)(h >> 32), (uint32_t) f->n_blocks) * BLOCK_WORDS;
+}
+
+// blocks aligned to a cache line, so that no block straddles two lines
+static uint32_t* bloom_filter__alloc_blocks(size_t n_blocks) {
+    void *blocks = NULL;
+    if (posix_memalign(&blocks, CACHE_LINE, n_blocks * BLOCK_BYTES) != 0) {
+        blocks = NULL;
+    }
+    check_alloc(blocks);
+    return (uint32_t*) blocks;
+}
+
+BloomFilter* bloom_filter_create(size_t capacity, size_t bits_per_key) {
+    BloomFilter *f = (BloomFilter*) malloc(sizeof(BloomFilter));
+    check_alloc(f);
+    f->capacity = capacity;
+    f->size = 0;
+    f->n_blocks = (capacity * bits_per_key + BLOCK_BYTES * 8 - 1) / (BLOCK_BYTES * 8);
+    f->n_blocks = f->n_blocks > 0 ? f->n_blocks : 1;
+    if (f->n_blocks > UINT32_MAX) {
+        printf("bloom_filter: capacity %zu too large\n", capacity);
+        exit(EXIT_FAILURE);
+    }
+    f->blocks = bloom_filter__alloc_blocks(f->n_blocks);
+    memset(f->blocks, 0, f->n_blocks * BLOCK_BYTES);
+    return f;
+}
+
+BloomFilter* bloom_filter_copy(BloomFilter *f) {
+    BloomFilter *copy = (BloomFilter*) malloc(sizeof(BloomFilter));
+    check_alloc(copy);
+    *copy = *f;
+    copy->blocks = bloom_filter__alloc_blocks(f->n_blocks);
+    memcpy(copy->blocks, f->blocks, f->n_blocks * BLOCK_BYTES);
+    return copy;
+}
+
+#ifdef __AVX2__
+// one bit per 32-bit lane, chosen by the top 5 bits of h * salt
+static inline __m256i bloom_filter__mask(uint32_t h) {
+    const __m256i salts = _mm256_setr_epi32(SALTS);
+    __m256i shifts = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(h), salts), 27);
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), shifts);
+}
+
+void bloom_filter_add(BloomFilter *f, int key) {
+    uint64_t h = bloom_filter__hash(key);
+    __m256i *block = (__m256i*) bloom_filter__block(f, h);
+    _mm256_store_si256(block, _mm256_or_si256(_mm256_load_si256(block), bloom_filter__mask((uint32_t) h)));
+    f->size++;
+}
+
+bool bloom_filter_contains(BloomFilter *f, int key) {
+    uint64_t h = bloom_filter__hash(key);
+    const __m256i *block = (const __m256i*) bloom_filter__block(f, h);
+    return _mm256_testc_si256(_mm256_load_si256(block), bloom_filter__mask((uint32_t) h));
+}
+#else
+static const uint32_t salts[BLOCK_WORDS] = {SALTS};
+
+void bloom_filter_add(BloomFilter *f, int key) {
+    uint64_t h = bloom_filter__hash(key);
+    uint32_t *block = bloom_filter__block(f, h);
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        block[i] |= (uint32_t) 1 << (((uint32_t) h * salts[i]) >> 27);
+    }
+    f->size++;
+}
+
+bool bloom_filter_contains(BloomFilter *f, int key) {
+    uint64_t h = bloom_filter__hash(key);
+    const uint32_t *block = bloom_filter__block(f, h);
+    uint32_t missing = 0; // no early exit, the loop is vectorized
+    for (int i = 0; i < BLOCK_WORDS; i++) {
+        missing |= ~block[i] & ((uint32_t) 1 << (((uint32_t) h * salts[i]) >> 27));
+    }
+    return missing == 0;
+}
+#endif
+
+size_t bloom_filter_size(BloomFilter *f) {
+    return f->size;
+}
+
+size_t bloom_filter_capacity(BloomFilter *f) {
+    return f->capacity;
+}
+
+size_t bloom_filter_bytes(BloomFilter *f) {
+    return sizeof(BloomFilter) + f->n_blocks * BLOCK_BYTES;
+}
+
+void bloom_filter_free(BloomFilter *f) {
+    free(f->blocks);
+    free(f);
+}
@@ -0,0 +1,108 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef BLOOM_FILTER_H
+#define BLOOM_FILTER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Bits of memory per key of a Bloom filter created for a capacity.
+ *
+ * 12 bits per key give about 0.5% of false positives at full capacity,
+ * 16 bits about 0.1%.
+ */
+#ifndef BLOOM_FILTER_BITS_PER_KEY
+#define BLOOM_FILTER_BITS_PER_KEY 12
+#endif
+
+/**
+ * @brief A blocked Bloom filter of integer keys.
+ *
+ * A Bloom filter answers whether a key may be in a set: a negative answer
+ * is always right, a positive one is wrong with a small probability (a
+ * false positive) that grows with the number of keys added.
+ *
+ * This one is split-block: the bits are grouped in blocks of 256 bits, and
+ * each key sets or tests one bit in each of the 8 words of a single block.
+ * A lookup touches one cache line, and with AVX2 its 8 bit tests are a
+ * single vector operation (build with -mavx2 or -march=native).
+ *
+ * Keys cannot be removed, see CuckooFilter for a filter supporting removals.
+ */
+typedef struct BloomFilter BloomFilter;
+
+/**
+ * @brief Create an empty Bloom filter
+ * @param capacity number of keys expected
+ * @param bits_per_key memory per key, as BLOOM_FILTER_BITS_PER_KEY
+ * @return pointer to the newly created filter
+ * @ingroup DataStructureMethods
+ */
+BloomFilter* bloom_filter_create(size_t capacity, size_t bits_per_key);
+
+/**
+ * @brief Create a copy of the filter
+ * @param f filter pointer
+ * @return pointer to the newly created filter
+ * @ingroup DataStructureMethods
+ */
+BloomFilter* bloom_filter_copy(BloomFilter *f);
+
+/**
+ * @brief Add a key to the filter
+ * @param f filter pointer
+ * @param key integer key
+ * @ingroup DataStructureMethods
+ */
+void bloom_filter_add(BloomFilter *f, int key);
+
+/**
+ * @brief Check if a key may have been added to the filter
+ * @param f filter pointer
+ * @param key integer key
+ * @return false if the key was never added, true if it probably was
+ * @ingroup DataStructureMethods
+ */
+bool bloom_filter_contains(BloomFilter *f, int key);
+
+/**
+ * @brief Get the number of keys added to the filter, repeated ones included
+ * @param f filter pointer
+ * @ingroup DataStructureMethods
+ */
+size_t bloom_filter_size(BloomFilter *f);
+
+/**
+ * @brief Get the number of keys the filter was created for
+ * @param f filter pointer
+ * @ingroup DataStructureMethods
+ */
+size_t bloom_filter_capacity(BloomFilter *f);
+
+/**
+ * @brief Get the memory used by the filter
+ * @param f filter pointer
+ * @return bytes of the filter and its blocks
+ * @ingroup DataStructureMethods
+ */
+size_t bloom_filter_bytes(BloomFilter *f);
+
+/**
+ * @brief Free memory of the filter
+ * @param f filter pointer
+ * @ingroup DataStructureMethods
+ */
+void bloom_filter_free(BloomFilter *f);
+
+#endif /* BLOOM_FILTER_H */
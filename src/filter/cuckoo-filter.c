@@ -0,0 +1,195 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "cuckoo-filter.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+#define BUCKET_SLOTS 4        // fingerprints of a bucket, read as one 64-bit word
+#define MAX_LOAD 0.95         // buckets are sized to be at most this full at capacity
+#define LANES 0x0001000100010001ULL
+#define HIGH_BITS 0x8000800080008000ULL
+
+struct CuckooFilter {
+    size_t capacity;
+    size_t size;
+    size_t mask;          // n_buckets - 1, a power of two
+    uint16_t *slots;      // n_buckets * BUCKET_SLOTS fingerprints, 0 for empty
+    bool has_victim;      // fingerprint left without a slot by the last insert
+    uint16_t victim;
+    size_t victim_index;
+    uint64_t random;      // xorshift state choosing the fingerprints to relocate
+};
+
+static inline uint64_t cuckoo_filter__hash(int key) {
+    return hash_mix64((uint32_t) key ^ 0xc2b2ae3d27d4eb4fULL);
+}
+
+// 16 high bits of the hash, never 0 which marks the empty slots
+static inline uint16_t cuckoo_filter__fingerprint(uint64_t h) {
+    uint16_t fp = (uint16_t)(h >> 48);
+    return fp != 0 ? fp : 1;
+}
+
+// the other bucket of fp: an involution, so it is also the way back
+static inline size_t cuckoo_filter__alt(const CuckooFilter *f, size_t index, uint16_t fp) {
+    return (index ^ (size_t) hash_mix64(fp)) & f->mask;
+}
+
+// the 4 fingerprints of a bucket as one word, to be compared at once
+static inline uint64_t cuckoo_filter__bucket(const CuckooFilter *f, size_t index) {
+    uint64_t word;
+    memcpy(&word, f->slots + index * BUCKET_SLOTS, sizeof(word));
+    return word;
+}
+
+// whether any 16-bit lane of word equals fp
+static inline bool cuckoo_filter__has(uint64_t word, uint16_t fp) {
+    uint64_t x = word ^ (fp * LANES);
+    return ((x - LANES) & ~x & HIGH_BITS) != 0;
+}
+
+static bool cuckoo_filter__put(CuckooFilter *f, size_t index, uint16_t fp) {
+    uint16_t *bucket = f->slots + index * BUCKET_SLOTS;
+    for (int i = 0; i < BUCKET_SLOTS; i++) {
+        if (bucket[i] == 0) {
+            bucket[i] = fp;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool cuckoo_filter__delete(CuckooFilter *f, size_t index, uint16_t fp) {
+    uint16_t *bucket = f->slots + index * BUCKET_SLOTS;
+    for (int i = 0; i < BUCKET_SLOTS; i++) {
+        if (bucket[i] == fp) {
+            bucket[i] = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+// place fp in one of its buckets, relocating other fingerprints if both are
+// full; the fingerprint left without a slot after the last kick is the victim
+static void cuckoo_filter__insert(CuckooFilter *f, size_t index, uint16_t fp) {
+    size_t alt = cuckoo_filter__alt(f, index, fp);
+    if (cuckoo_filter__put(f, index, fp) || cuckoo_filter__put(f, alt, fp)) {
+        return;
+    }
+    index = f->random & 1 ? alt : index;
+    for (int kick = 0; kick < CUCKOO_FILTER_MAX_KICKS; kick++) {
+        f->random ^= f->random << 13;
+        f->random ^= f->random >> 7;
+        f->random ^= f->random << 17;
+        uint16_t *slot = &f->slots[index * BUCKET_SLOTS + f->random % BUCKET_SLOTS];
+        uint16_t kicked = *slot;
+        *slot = fp;
+        fp = kicked;
+        index = cuckoo_filter__alt(f, index, fp);
+        if (cuckoo_filter__put(f, index, fp)) {
+            return;
+        }
+    }
+    f->has_victim = true;
+    f->victim = fp;
+    f->victim_index = index;
+}
+
+CuckooFilter* cuckoo_filter_create(size_t capacity) {
+    CuckooFilter *f = (CuckooFilter*) malloc(sizeof(CuckooFilter));
+    check_alloc(f);
+    size_t n_buckets = hash_round_pow2((size_t) (capacity / (BUCKET_SLOTS * MAX_LOAD)) + 1);
+    f->capacity = capacity;
+    f->size = 0;
+    f->mask = n_buckets - 1;
+    f->slots = (uint16_t*) calloc(n_buckets * BUCKET_SLOTS, sizeof(uint16_t));
+    check_alloc(f->slots);
+    f->has_victim = false;
+    f->victim = 0;
+    f->victim_index = 0;
+    f->random = 0x2545f4914f6cdd1dULL;
+    return f;
+}
+
+CuckooFilter* cuckoo_filter_copy(CuckooFilter *f) {
+    CuckooFilter *copy = (CuckooFilter*) malloc(sizeof(CuckooFilter));
+    check_alloc(copy);
+    *copy = *f;
+    size_t n_slots = (f->mask + 1) * BUCKET_SLOTS;
+    copy->slots = (uint16_t*) malloc(n_slots * sizeof(uint16_t));
+    check_alloc(copy->slots);
+    memcpy(copy->slots, f->slots, n_slots * sizeof(uint16_t));
+    return copy;
+}
+
+bool cuckoo_filter_add(CuckooFilter *f, int key) {
+    if (f->has_victim) {
+        return false;
+    }
+    uint64_t h = cuckoo_filter__hash(key);
+    cuckoo_filter__insert(f, (size_t) h & f->mask, cuckoo_filter__fingerprint(h));
+    f->size++;
+    return true;
+}
+
+bool cuckoo_filter_remove(CuckooFilter *f, int key) {
+    uint64_t h = cuckoo_filter__hash(key);
+    uint16_t fp = cuckoo_filter__fingerprint(h);
+    size_t index = (size_t) h & f->mask;
+    size_t alt = cuckoo_filter__alt(f, index, fp);
+    bool removed;
+    if (f->has_victim && f->victim == fp && (f->victim_index == index || f->victim_index == alt)) {
+        f->has_victim = false;
+        removed = true;
+    } else {
+        removed = cuckoo_filter__delete(f, index, fp) || cuckoo_filter__delete(f, alt, fp);
+        if (removed && f->has_victim) {
+            // a slot was freed: try to place the victim again
+            f->has_victim = false;
+            cuckoo_filter__insert(f, f->victim_index, f->victim);
+        }
+    }
+    f->size -= removed;
+    return removed;
+}
+
+bool cuckoo_filter_contains(CuckooFilter *f, int key) {
+    uint64_t h = cuckoo_filter__hash(key);
+    uint16_t fp = cuckoo_filter__fingerprint(h);
+    size_t index = (size_t) h & f->mask;
+    size_t alt = cuckoo_filter__alt(f, index, fp);
+    return cuckoo_filter__has(cuckoo_filter__bucket(f, index), fp)
+        || cuckoo_filter__has(cuckoo_filter__bucket(f, alt), fp)
+        || (f->has_victim && f->victim == fp && (f->victim_index == index || f->victim_index == alt));
+}
+
+size_t cuckoo_filter_size(CuckooFilter *f) {
+    return f->size;
+}
+
+size_t cuckoo_filter_capacity(CuckooFilter *f) {
+    return f->capacity;
+}
+
+size_t cuckoo_filter_bytes(CuckooFilter *f) {
+    return sizeof(CuckooFilter) + (f->mask + 1) * BUCKET_SLOTS * sizeof(uint16_t);
+}
+
+void cuckoo_filter_free(CuckooFilter *f) {
+    free(f->slots);
+    free(f);
+}
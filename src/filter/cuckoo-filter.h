@@ -0,0 +1,122 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef CUCKOO_FILTER_H
+#define CUCKOO_FILTER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Relocations tried by an insert before the filter is declared full.
+ */
+#ifndef CUCKOO_FILTER_MAX_KICKS
+#define CUCKOO_FILTER_MAX_KICKS 500
+#endif
+
+/**
+ * @brief A cuckoo filter of integer keys, supporting removals.
+ *
+ * Like a Bloom filter, it answers whether a key may be in a set with no
+ * false negative and a small rate of false positives, but keys can also be
+ * removed. It stores a 16-bit fingerprint of each key in one of two
+ * buckets of 4 fingerprints; the second bucket is computed from the first
+ * one and the fingerprint, so an insert can relocate fingerprints between
+ * their two buckets to make room, as in cuckoo hashing.
+ *
+ * False positives are about 0.01%. The number of buckets is a power of
+ * two holding the capacity at most 95% full, so the filter takes from 17
+ * to 34 bits per key of capacity. An insert fails when no relocation frees
+ * a slot: the filter must then be rebuilt larger.
+ *
+ * @see Fan et al., Cuckoo Filter: Practically Better Than Bloom, CoNEXT 2014
+ */
+typedef struct CuckooFilter CuckooFilter;
+
+/**
+ * @brief Create an empty cuckoo filter
+ * @param capacity number of keys expected, the filter may hold a few more
+ * @return pointer to the newly created filter
+ * @ingroup DataStructureMethods
+ */
+CuckooFilter* cuckoo_filter_create(size_t capacity);
+
+/**
+ * @brief Create a copy of the filter
+ * @param f filter pointer
+ * @return pointer to the newly created filter
+ * @ingroup DataStructureMethods
+ */
+CuckooFilter* cuckoo_filter_copy(CuckooFilter *f);
+
+/**
+ * @brief Add a key to the filter
+ *
+ * A key added twice is stored twice, and must be removed twice.
+ * @param f filter pointer
+ * @param key integer key
+ * @return false if the filter is full, the key was then not added
+ * @ingroup DataStructureMethods
+ */
+bool cuckoo_filter_add(CuckooFilter *f, int key);
+
+/**
+ * @brief Remove a key added to the filter
+ *
+ * Removing a key never added may remove another key with the same
+ * fingerprint, causing a false negative.
+ * @param f filter pointer
+ * @param key integer key
+ * @return true if a fingerprint of the key was found and removed
+ * @ingroup DataStructureMethods
+ */
+bool cuckoo_filter_remove(CuckooFilter *f, int key);
+
+/**
+ * @brief Check if a key may be in the filter
+ * @param f filter pointer
+ * @param key integer key
+ * @return false if the key is not in the filter, true if it probably is
+ * @ingroup DataStructureMethods
+ */
+bool cuckoo_filter_contains(CuckooFilter *f, int key);
+
+/**
+ * @brief Get the number of keys in the filter
+ * @param f filter pointer
+ * @ingroup DataStructureMethods
+ */
+size_t cuckoo_filter_size(CuckooFilter *f);
+
+/**
+ * @brief Get the number of keys the filter was created for
+ * @param f filter pointer
+ * @ingroup DataStructureMethods
+ */
+size_t cuckoo_filter_capacity(CuckooFilter *f);
+
+/**
+ * @brief Get the memory used by the filter
+ * @param f filter pointer
+ * @return bytes of the filter and its buckets
+ * @ingroup DataStructureMethods
+ */
+size_t cuckoo_filter_bytes(CuckooFilter *f);
+
+/**
+ * @brief Free memory of the filter
+ * @param f filter pointer
+ * @ingroup DataStructureMethods
+ */
+void cuckoo_filter_free(CuckooFilter *f);
+
+#endif /* CUCKOO_FILTER_H */
@@ -0,0 +1,127 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <assert.h>
+#include "bloom-filter.h"
+#include "cuckoo-filter.h"
+
+#define N_KEYS 20000
+
+// keys 0, 2, 4... are added, odd keys are looked up as absent
+static double false_positive_rate(bool (*contains)(void*, int), void *f) {
+    int positives = 0;
+    for (int i = 0; i < N_KEYS; i++) {
+        positives += contains(f, 2 * i + 1);
+    }
+    return (double) positives / N_KEYS;
+}
+
+static bool bloom_contains(void *f, int key) {
+    return bloom_filter_contains((BloomFilter*) f, key);
+}
+
+static bool cuckoo_contains(void *f, int key) {
+    return cuckoo_filter_contains((CuckooFilter*) f, key);
+}
+
+void test_bloom_filter() {
+    puts("== bloom filter: no false negative, few false positives");
+    BloomFilter *f = bloom_filter_create(N_KEYS, BLOOM_FILTER_BITS_PER_KEY);
+    assert(!bloom_filter_contains(f, 0));
+    for (int i = 0; i < N_KEYS; i++) {
+        bloom_filter_add(f, 2 * i);
+    }
+    for (int i = 0; i < N_KEYS; i++) {
+        assert(bloom_filter_contains(f, 2 * i));
+    }
+    assert(bloom_filter_size(f) == N_KEYS);
+    assert(bloom_filter_capacity(f) == N_KEYS);
+    double rate = false_positive_rate(bloom_contains, f);
+    printf("false positives at %d bits per key: %.3f%%, %zu bytes\n",
+           BLOOM_FILTER_BITS_PER_KEY, 100 * rate, bloom_filter_bytes(f));
+    assert(rate < 0.02);
+
+    BloomFilter *copy = bloom_filter_copy(f);
+    bloom_filter_add(copy, -1);
+    assert(bloom_filter_contains(copy, -1));
+    assert(bloom_filter_size(copy) == N_KEYS + 1);
+    assert(bloom_filter_size(f) == N_KEYS);
+    for (int i = 0; i < N_KEYS; i++) {
+        assert(bloom_filter_contains(copy, 2 * i));
+    }
+    bloom_filter_free(copy);
+    bloom_filter_free(f);
+}
+
+void test_cuckoo_filter() {
+    puts("== cuckoo filter: add, remove and fill until full");
+    CuckooFilter *f = cuckoo_filter_create(N_KEYS);
+    for (int i = 0; i < N_KEYS; i++) {
+        bool inserted = cuckoo_filter_add(f, 2 * i);
+        assert(inserted);
+    }
+    for (int i = 0; i < N_KEYS; i++) {
+        assert(cuckoo_filter_contains(f, 2 * i));
+    }
+    double rate = false_positive_rate(cuckoo_contains, f);
+    printf("false positives: %.3f%%, %zu bytes\n", 100 * rate, cuckoo_filter_bytes(f));
+    assert(rate < 0.002);
+
+    CuckooFilter *copy = cuckoo_filter_copy(f);
+
+    // remove every other key, the others stay
+    for (int i = 0; i < N_KEYS; i += 2) {
+        assert(cuckoo_filter_remove(f, 2 * i));
+    }
+    assert(cuckoo_filter_size(f) == N_KEYS / 2);
+    for (int i = 1; i < N_KEYS; i += 2) {
+        assert(cuckoo_filter_contains(f, 2 * i));
+    }
+    int removed_found = 0;
+    for (int i = 0; i < N_KEYS; i += 2) {
+        removed_found += cuckoo_filter_contains(f, 2 * i);
+    }
+    assert(removed_found < N_KEYS / 100);
+    for (int i = 0; i < N_KEYS; i++) {
+        assert(cuckoo_filter_contains(copy, 2 * i));
+    }
+    cuckoo_filter_free(copy);
+
+    // fill past the capacity: adds fail at some point, never losing a key
+    int added = 0;
+    while (cuckoo_filter_add(f, -added - 1)) {
+        added++;
+    }
+    printf("full after %zu keys for a capacity of %zu\n", cuckoo_filter_size(f), cuckoo_filter_capacity(f));
+    assert(cuckoo_filter_size(f) >= N_KEYS);
+    for (int i = 0; i < added; i++) {
+        assert(cuckoo_filter_contains(f, -i - 1));
+    }
+    for (int i = 1; i < N_KEYS; i += 2) {
+        assert(cuckoo_filter_contains(f, 2 * i));
+    }
+
+    // a removal keeps the other keys, the one without a slot included
+    bool removed = cuckoo_filter_remove(f, -1);
+    assert(removed);
+    for (int i = 1; i < added; i++) {
+        assert(cuckoo_filter_contains(f, -i - 1));
+    }
+    cuckoo_filter_free(f);
+}
+
+int main(void) {
+    test_bloom_filter();
+    test_cuckoo_filter();
+    return 0;
+}
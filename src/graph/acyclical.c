@@ -21,11 +21,9 @@ static void graph_dfsa(
     cc->exploration[node] = ++cc->counter_exploration;
     stack_push(cc->cycle_path, node);
 
-    Set* neighbors_set = graph_get_neighbors(g, node);
-    Iterator* set_it = set_iterator(neighbors_set);
-
-    while (!iterator_done(set_it)) {
-        int neighbor = *(int*) iterator_next(set_it);
+    GraphNeighbors neighbors = graph_neighbors_begin(g, node);
+    while (graph_neighbors_next(&neighbors)) {
+        int neighbor = neighbors.node;
         if (cc->exploration[neighbor] == 0) {
             graph_dfsa(g, neighbor, cc);
         } else if (cc->exploration[neighbor] < cc->exploration[node] && cc->complete[neighbor] == 0) {
@@ -35,8 +33,6 @@ static void graph_dfsa(
             break;
         }
     }
-    set_free(neighbors_set);
-    iterator_free(set_it);
     // early stop
     if (cc->has_cycles) {
         return;
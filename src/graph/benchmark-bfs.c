@@ -0,0 +1,100 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Breadth-first search from node 0 of a random undirected graph of EDGES
+ * edges between NODES nodes: the graph_bfs() iterator, the graph_csr_bfs()
+ * one on the frozen graph, and graph_csr_bfs_levels() on pools of 1 to 8
+ * threads. The rate is in millions of edges of the component traversed per
+ * second (MTEPS).
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+#include "graph-csr.h"
+
+#ifndef NODES
+#define NODES (1 << 20)
+#endif
+
+#ifndef EDGES
+#define EDGES 10000000
+#endif
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static size_t walk(Iterator *it) {
+    size_t visited = 0;
+    while (!iterator_done(it)) {
+        iterator_next(it);
+        visited++;
+    }
+    iterator_free(it);
+    return visited;
+}
+
+int main(void) {
+    srand(42);
+    double start = now_seconds();
+    Graph *g = graph_undirected_create();
+    for (int e = 0; e < EDGES; e++) {
+        graph_add_edge(g, rand() % NODES, rand() % NODES);
+    }
+    GraphCSR *csr = graph_freeze(g);
+    int n = graph_csr_max_node_id(csr) + 1;
+    printf("graph of %zu nodes and %d edges built in %.1f s\n", graph_size(g), EDGES, now_seconds() - start);
+
+    // edges of the component of the source, seen from both ends
+    int *depth = (int*) malloc(n * sizeof(int));
+    int *parent = (int*) malloc(n * sizeof(int));
+    ThreadPool *pool = thread_pool_create(1);
+    graph_csr_bfs_levels(csr, 0, depth, parent, pool);
+    thread_pool_free(pool);
+    size_t edges = 0;
+    for (int u = 0; u < n; u++) {
+        edges += depth[u] >= 0 ? graph_csr_degree(csr, u) : 0;
+    }
+
+    printf("algorithm;threads;seconds;MTEPS\n");
+    start = now_seconds();
+    walk(graph_bfs(g, 0));
+    double seconds = now_seconds() - start;
+    printf("graph-bfs;1;%.3f;%.1f\n", seconds, edges / seconds * 1e-6);
+
+    start = now_seconds();
+    walk(graph_csr_bfs(csr, 0));
+    seconds = now_seconds() - start;
+    printf("csr-bfs;1;%.3f;%.1f\n", seconds, edges / seconds * 1e-6);
+
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+        pool = thread_pool_create(threads);
+        start = now_seconds();
+        graph_csr_bfs_levels(csr, 0, depth, parent, pool);
+        seconds = now_seconds() - start;
+        printf("bfs-levels;%zu;%.3f;%.1f\n", threads, seconds, edges / seconds * 1e-6);
+        thread_pool_free(pool);
+    }
+
+    free(depth);
+    free(parent);
+    graph_csr_free(csr);
+    graph_free(g);
+    return 0;
+}
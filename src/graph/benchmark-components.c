@@ -0,0 +1,128 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Connected components of a random undirected graph of EDGES edges between
+ * NODES nodes: a breadth-first search from each node not labelled yet, the
+ * sequential union-find of graph_connected_components(), and Afforest by
+ * graph_connected_components_parallel() on pools of 2 to 8 threads. Both
+ * freeze the graph to its CSR form first, so the same algorithms on a graph
+ * frozen once show the cost of the rest.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+#include "graph-csr.h"
+
+#ifndef NODES
+#define NODES (1 << 20)
+#endif
+
+#ifndef EDGES
+#define EDGES 10000000
+#endif
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int* components_bfs(Graph *g) {
+    int n = graph_max_node_id(g) + 1;
+    int *labels = (int*) malloc(n * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        labels[u] = -1;
+    }
+    Iterator *nodes = graph_nodes_iterator(g);
+    while (!iterator_done(nodes)) {
+        int u = *(int*) iterator_next(nodes);
+        if (labels[u] >= 0) {
+            continue;
+        }
+        Iterator *it = graph_bfs(g, u);
+        while (!iterator_done(it)) {
+            labels[*(int*) iterator_next(it)] = u;
+        }
+        iterator_free(it);
+    }
+    iterator_free(nodes);
+    return labels;
+}
+
+static int count_components(const int *labels, int n) {
+    int count = 0;
+    for (int u = 0; u < n; u++) {
+        count += labels[u] == u;
+    }
+    return count;
+}
+
+int main(void) {
+    srand(42);
+    double start = now_seconds();
+    Graph *g = graph_undirected_create();
+    for (int e = 0; e < EDGES; e++) {
+        graph_add_edge(g, rand() % NODES, rand() % NODES);
+    }
+    int n = graph_max_node_id(g) + 1;
+    printf("graph of %zu nodes and %d edges built in %.1f s\n", graph_size(g), EDGES, now_seconds() - start);
+
+    printf("algorithm;threads;components;seconds\n");
+    start = now_seconds();
+    int *expected = components_bfs(g);
+    printf("bfs;1;%d;%.3f\n", count_components(expected, n), now_seconds() - start);
+
+    start = now_seconds();
+    int *labels = graph_connected_components(g);
+    printf("union-find;1;%d;%.3f\n", count_components(labels, n), now_seconds() - start);
+    free(labels);
+
+    for (size_t threads = 2; threads <= 8; threads *= 2) {
+        ThreadPool *pool = thread_pool_create(threads);
+        start = now_seconds();
+        labels = graph_connected_components_parallel(g, pool);
+        double seconds = now_seconds() - start;
+        for (int u = 0; u < n; u++) {
+            if ((labels[u] < 0) != (expected[u] < 0) || labels[expected[u] < 0 ? u : expected[u]] != labels[u]) {
+                printf("unexpected label of %d\n", u);
+                break;
+            }
+        }
+        printf("afforest;%zu;%d;%.3f\n", threads, count_components(labels, n), seconds);
+        free(labels);
+        thread_pool_free(pool);
+    }
+
+    start = now_seconds();
+    GraphCSR *csr = graph_freeze(g);
+    printf("freeze;1;-;%.3f\n", now_seconds() - start);
+    start = now_seconds();
+    labels = graph_csr_connected_components(csr);
+    printf("csr-union-find;1;%d;%.3f\n", count_components(labels, n), now_seconds() - start);
+    free(labels);
+    ThreadPool *pool = thread_pool_create(4);
+    start = now_seconds();
+    labels = graph_csr_connected_components_parallel(csr, pool);
+    printf("csr-afforest;4;%d;%.3f\n", count_components(labels, n), now_seconds() - start);
+    free(labels);
+    thread_pool_free(pool);
+    graph_csr_free(csr);
+
+    free(expected);
+    graph_free(g);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Shortest paths from node 0 of a random directed graph of EDGES edges
+ * between NODES nodes, of weights from 0 to MAX_WEIGHT: graph_dijkstra(),
+ * Dijkstra on the frozen graph with each of its queues, and
+ * graph_csr_sssp_delta_stepping() on pools of 1 to 8 threads.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "graph.h"
+#include "graph-csr.h"
+
+#ifndef NODES
+#define NODES (1 << 20)
+#endif
+
+#ifndef EDGES
+#define EDGES 10000000
+#endif
+
+#ifndef MAX_WEIGHT
+#define MAX_WEIGHT 1000
+#endif
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(void) {
+    srand(42);
+    double start = now_seconds();
+    Graph *g = graph_create();
+    for (int e = 0; e < EDGES; e++) {
+        graph_add_edge_with_weight(g, rand() % NODES, rand() % NODES, rand() % (MAX_WEIGHT + 1));
+    }
+    GraphCSR *csr = graph_freeze(g);
+    int n = graph_csr_max_node_id(csr) + 1;
+    printf("graph of %zu nodes and %d edges built in %.1f s\n", graph_size(g), EDGES, now_seconds() - start);
+
+    int *expected = (int*) malloc(n * sizeof(int));
+    int *dist = (int*) malloc(n * sizeof(int));
+    int *parent = (int*) malloc(n * sizeof(int));
+    printf("algorithm;threads;seconds\n");
+    start = now_seconds();
+    Graph *g_dijkstra = graph_dijkstra(g, 0);
+    printf("graph-dijkstra;1;%.3f\n", now_seconds() - start);
+    graph_free(g_dijkstra);
+
+    const char *queues[] = {"auto", "binary-heap", "radix-heap", "dial"};
+    for (int queue = GRAPH_QUEUE_BINARY_HEAP; queue <= GRAPH_QUEUE_DIAL; queue++) {
+        start = now_seconds();
+        graph_csr_dijkstra_with_queue(csr, 0, queue == GRAPH_QUEUE_BINARY_HEAP ? expected : dist, parent,
+                                      (GraphQueueType) queue);
+        double seconds = now_seconds() - start;
+        if (queue != GRAPH_QUEUE_BINARY_HEAP && memcmp(dist, expected, n * sizeof(int)) != 0) {
+            printf("unexpected distances\n");
+        }
+        printf("csr-dijkstra-%s;1;%.3f\n", queues[queue], seconds);
+    }
+    start = now_seconds();
+    graph_csr_dijkstra(csr, 0, dist, parent);
+    printf("csr-dijkstra-%s;1;%.3f\n", queues[GRAPH_QUEUE_AUTO], now_seconds() - start);
+
+    for (size_t threads = 1; threads <= 8; threads *= 2) {
+        ThreadPool *pool = thread_pool_create(threads);
+        start = now_seconds();
+        graph_csr_sssp_delta_stepping(csr, 0, 0, dist, parent, pool);
+        double seconds = now_seconds() - start;
+        if (memcmp(dist, expected, n * sizeof(int)) != 0) {
+            printf("unexpected distances\n");
+        }
+        printf("delta-stepping;%zu;%.3f\n", threads, seconds);
+        thread_pool_free(pool);
+    }
+
+    free(expected);
+    free(dist);
+    free(parent);
+    graph_csr_free(csr);
+    graph_free(g);
+    return 0;
+}
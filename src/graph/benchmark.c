@@ -0,0 +1,61 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Memory per node of sparse directed graphs: each node has `degree` edges
+ * to random nodes. Heap bytes are read from glibc before and after the graph
+ * is built. Build with -DGRAPH_ADJACENCY_TYPE=SET_HASH_TABLE to measure the
+ * neighbors as hash table sets, as `make benchmark` does for comparison.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <malloc.h>
+#include "graph.h"
+
+#define NODES 100000
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static size_t heap_bytes(void) {
+    return mallinfo2().uordblks;
+}
+
+int main(void) {
+    static const int degrees[] = {0, 1, 2, 4, 8, 16};
+    printf("adjacency;nodes;degree;bytes/node;build(ms)\n");
+    srand(42);
+    for (size_t d = 0; d < sizeof(degrees) / sizeof(degrees[0]); d++) {
+        size_t before = heap_bytes();
+        double start = now_seconds();
+        Graph *g = graph_create();
+        for (int u = 0; u < NODES; u++) {
+            graph_add_node(g, u);
+            for (int k = 0; k < degrees[d]; k++) {
+                graph_add_edge(g, u, rand() % NODES);
+            }
+        }
+        double elapsed = now_seconds() - start;
+        size_t bytes = heap_bytes() - before;
+        printf("%s;%d;%d;%.0f;%.0f\n", GRAPH_ADJACENCY_TYPE == SET_SMALL ? "small" : "hash-table",
+               NODES, degrees[d], (double) bytes / NODES, elapsed * 1e3);
+        graph_free(g);
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "graph-csr.h"
+
+#define PARALLEL_TASKS 8   // tasks per thread, to balance the load
+#define BFS_ALPHA 14       // bottom-up once the frontier has 1/ALPHA of the unvisited edges
+#define BFS_BETA 24        // top-down again once the frontier has 1/BETA of the nodes
+
+// the nodes found by a task of a top-down step
+typedef struct BfsBuffer {
+    int *nodes;
+    size_t size;
+    size_t capacity;
+    size_t edges;   // out of the nodes
+} BfsBuffer;
+
+typedef struct BfsLevels {
+    const GraphCSR *g;
+    int n;
+    size_t n_words;
+    const size_t *offsets;
+    const int *targets;
+    int *depth;
+    int *parent;
+    int level;          // depth of the nodes of the next frontier
+    uint64_t *visited;
+    uint64_t *frontier; // bitmaps of the bottom-up steps
+    uint64_t *next;
+    int *queue;         // frontier of the top-down steps
+    size_t queue_size;
+    BfsBuffer *buffers; // one per task
+    size_t parts;
+} BfsLevels;
+
+static inline bool bfs_levels__bit(const uint64_t *bits, int u) {
+    return bits[u / 64] >> (u % 64) & 1;
+}
+
+static inline size_t bfs_levels__degree(BfsLevels *b, int u) {
+    return b->offsets[u + 1] - b->offsets[u];
+}
+
+static void bfs_levels__push(BfsBuffer *buffer, int u, size_t degree) {
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity = buffer->capacity > 0 ? 2 * buffer->capacity : 256;
+        buffer->nodes = (int*) realloc(buffer->nodes, buffer->capacity * sizeof(int));
+        check_alloc(buffer->nodes);
+    }
+    buffer->nodes[buffer->size++] = u;
+    buffer->edges += degree;
+}
+
+// the neighbors of the frontier not visited yet are claimed by setting
+// their bit: the task that sets it first is their parent
+static void bfs_levels__top_down(void *context, size_t part) {
+    BfsLevels *b = (BfsLevels*) context;
+    BfsBuffer *buffer = &b->buffers[part];
+    size_t from = b->queue_size * part / b->parts;
+    size_t to = b->queue_size * (part + 1) / b->parts;
+    for (size_t i = from; i < to; i++) {
+        int u = b->queue[i];
+        for (size_t e = b->offsets[u]; e < b->offsets[u + 1]; e++) {
+            int v = b->targets[e];
+            uint64_t bit = (uint64_t) 1 << (v % 64);
+            if (__atomic_load_n(&b->visited[v / 64], __ATOMIC_RELAXED) & bit) {
+                continue;
+            }
+            if (!(__atomic_fetch_or(&b->visited[v / 64], bit, __ATOMIC_RELAXED) & bit)) {
+                b->depth[v] = b->level;
+                b->parent[v] = u;
+                bfs_levels__push(buffer, v, bfs_levels__degree(b, v));
+            }
+        }
+    }
+}
+
+// each node not visited yet looks for a neighbor in the frontier, the
+// nodes of a task span whole words so the bitmaps need no atomics
+static void bfs_levels__bottom_up(void *context, size_t part) {
+    BfsLevels *b = (BfsLevels*) context;
+    BfsBuffer *buffer = &b->buffers[part];
+    size_t from = b->n_words * part / b->parts;
+    size_t to = b->n_words * (part + 1) / b->parts;
+    for (size_t w = from; w < to; w++) {
+        uint64_t next = 0;
+        uint64_t unvisited = ~b->visited[w];
+        while (unvisited != 0) {
+            int v = (int) (w * 64 + __builtin_ctzll(unvisited));
+            unvisited &= unvisited - 1;
+            if (v >= b->n) {
+                break;
+            }
+            for (size_t e = b->offsets[v]; e < b->offsets[v + 1]; e++) {
+                int u = b->targets[e];
+                if (bfs_levels__bit(b->frontier, u)) {
+                    b->depth[v] = b->level;
+                    b->parent[v] = u;
+                    next |= (uint64_t) 1 << (v % 64);
+                    buffer->size++;
+                    buffer->edges += bfs_levels__degree(b, v);
+                    break;
+                }
+            }
+        }
+        b->next[w] = next;
+        b->visited[w] |= next;
+    }
+}
+
+static void bfs_levels__run(BfsLevels *b, ThreadPool *pool, ThreadPoolTask task) {
+    for (size_t part = 0; part < b->parts; part++) {
+        b->buffers[part].size = 0;
+        b->buffers[part].edges = 0;
+    }
+    if (b->parts == 1) {
+        task(b, 0);
+    } else {
+        thread_pool_run(pool, task, b, b->parts);
+    }
+}
+
+void graph_csr_bfs_levels(const GraphCSR *g, int source, int *depth, int *parent, ThreadPool *pool) {
+    BfsLevels b;
+    b.g = g;
+    b.n = graph_csr_max_node_id(g) + 1;
+    b.n_words = (size_t) b.n / 64 + 1;
+    b.offsets = graph_csr_offsets(g);
+    b.targets = graph_csr_targets(g);
+    b.depth = depth;
+    b.parent = parent;
+    for (int u = 0; u < b.n; u++) {
+        depth[u] = -1;
+        parent[u] = -1;
+    }
+    if (!graph_csr_has_node(g, source)) {
+        return;
+    }
+    size_t edges = graph_csr_edges_count(g);
+    bool parallel = thread_pool_size(pool) > 1 && edges >= GRAPH_PARALLEL_MIN_EDGES;
+    b.parts = parallel ? thread_pool_size(pool) * PARALLEL_TASKS : 1;
+    b.visited = (uint64_t*) calloc(b.n_words, sizeof(uint64_t));
+    b.frontier = (uint64_t*) calloc(b.n_words, sizeof(uint64_t));
+    b.next = (uint64_t*) calloc(b.n_words, sizeof(uint64_t));
+    b.queue = (int*) malloc(b.n * sizeof(int));
+    b.buffers = (BfsBuffer*) calloc(b.parts, sizeof(BfsBuffer));
+    check_alloc(b.visited);
+    check_alloc(b.frontier);
+    check_alloc(b.next);
+    check_alloc(b.queue);
+    check_alloc(b.buffers);
+
+    depth[source] = 0;
+    b.visited[source / 64] |= (uint64_t) 1 << (source % 64);
+    b.queue[0] = source;
+    b.queue_size = 1;
+    // edges out of the frontier and out of the nodes not visited yet
+    size_t frontier_edges = b.offsets[source + 1] - b.offsets[source];
+    size_t unvisited_edges = edges - frontier_edges;
+    size_t frontier_size = 1;
+    bool bottom_up = false;
+
+    // a bottom-up step looks for the parents of a node among its neighbors,
+    // which are its predecessors only if the graph is undirected
+    bool can_go_bottom_up = !graph_csr_is_directed(g);
+    for (b.level = 1; frontier_size > 0; b.level++) {
+        if (can_go_bottom_up && !bottom_up && frontier_edges > unvisited_edges / BFS_ALPHA) {
+            // queue to bitmap
+            for (size_t w = 0; w < b.n_words; w++) {
+                b.frontier[w] = 0;
+            }
+            for (size_t i = 0; i < b.queue_size; i++) {
+                b.frontier[b.queue[i] / 64] |= (uint64_t) 1 << (b.queue[i] % 64);
+            }
+            bottom_up = true;
+        } else if (bottom_up && frontier_size < (size_t) b.n / BFS_BETA) {
+            // bitmap to queue
+            b.queue_size = 0;
+            for (size_t w = 0; w < b.n_words; w++) {
+                for (uint64_t bits = b.frontier[w]; bits != 0; bits &= bits - 1) {
+                    b.queue[b.queue_size++] = (int) (w * 64 + __builtin_ctzll(bits));
+                }
+            }
+            bottom_up = false;
+        }
+
+        frontier_size = 0;
+        frontier_edges = 0;
+        if (bottom_up) {
+            bfs_levels__run(&b, pool, &bfs_levels__bottom_up);
+            uint64_t *swap = b.frontier;
+            b.frontier = b.next;
+            b.next = swap;
+        } else {
+            bfs_levels__run(&b, pool, &bfs_levels__top_down);
+            b.queue_size = 0;
+            for (size_t part = 0; part < b.parts; part++) {
+                BfsBuffer *buffer = &b.buffers[part];
+                for (size_t i = 0; i < buffer->size; i++) {
+                    b.queue[b.queue_size++] = buffer->nodes[i];
+                }
+            }
+        }
+        for (size_t part = 0; part < b.parts; part++) {
+            frontier_size += b.buffers[part].size;
+            frontier_edges += b.buffers[part].edges;
+        }
+        unvisited_edges -= frontier_edges < unvisited_edges ? frontier_edges : unvisited_edges;
+    }
+
+    for (size_t part = 0; part < b.parts; part++) {
+        free(b.buffers[part].nodes);
+    }
+    free(b.buffers);
+    free(b.queue);
+    free(b.next);
+    free(b.frontier);
+    free(b.visited);
+}
+
+void graph_bfs_levels(Graph *g, int source, int *depth, int *parent, ThreadPool *pool) {
+    GraphCSR *csr = graph_freeze(g);
+    if (csr == NULL) {
+        return;
+    }
+    graph_csr_bfs_levels(csr, source, depth, parent, pool);
+    graph_csr_free(csr);
+}
@@ -54,17 +54,12 @@ void* graph_bfs_next(Iterator* it) {
     it_context->path = list_insert(it_context->path, current_node);
 
     // Get the neighbors of the current node.
-    Set* neighbors_set = graph_get_neighbors(it_context->graph, current_node);
-    Iterator* set_it = set_iterator(neighbors_set); // Helper function
+    GraphNeighbors neighbors = graph_neighbors_begin(it_context->graph, current_node);
     // Iterate over the neighbors.
-    while (!iterator_done(set_it)) {
-        int neighbor = *(int*)iterator_next(set_it);
-        graph_visit_if_necessary(it_context, neighbor);
+    while (graph_neighbors_next(&neighbors)) {
+        graph_visit_if_necessary(it_context, neighbors.node);
     }
 
-    iterator_free(set_it);
-    set_free(neighbors_set);
-
     return &it_context->path->data;
 }
 
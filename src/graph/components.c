@@ -0,0 +1,195 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include "graph-csr.h"
+#include "../set/set-disjoint.h"
+#include "../set/set-disjoint-concurrent.h"
+#include "../utils/hash.h"
+
+#define PARALLEL_TASKS 8      // tasks per thread, to balance the load
+#define AFFOREST_ROUNDS 2     // neighbors of each node linked before sampling
+#define AFFOREST_SAMPLES 1024 // nodes sampled to find the largest component
+
+// the neighbors of the node u are the targets from offsets[u] to offsets[u + 1] - 1
+typedef struct Components {
+    const GraphCSR *g;
+    int n;            // node ids from 0 to n - 1
+    const size_t *offsets;
+    const int *targets;
+    bool directed;
+    int *labels;
+    DisjointSetConcurrent *ds;
+    size_t parts;
+    int round;
+    int largest;      // root of the largest component, skipped by the last round
+} Components;
+
+static void components__init(Components *c, const GraphCSR *g) {
+    c->g = g;
+    c->n = graph_csr_max_node_id(g) + 1;
+    c->offsets = graph_csr_offsets(g);
+    c->targets = graph_csr_targets(g);
+    c->directed = graph_csr_is_directed(g);
+    c->labels = (int*) malloc(c->n * sizeof(int));
+    check_alloc(c->labels);
+    for (int u = 0; u < c->n; u++) {
+        c->labels[u] = -1;
+    }
+}
+
+int* graph_csr_connected_components(const GraphCSR *g) {
+    Components c;
+    components__init(&c, g);
+    DisjointSet *ds = set_disjoint_create(c.n);
+    for (int u = 0; u < c.n; u++) {
+        for (size_t e = c.offsets[u]; e < c.offsets[u + 1]; e++) {
+            set_disjoint_union(ds, u, c.targets[e]);
+        }
+    }
+    // nodes in increasing order: the first one of a component labels it
+    int *smallest = (int*) malloc(c.n * sizeof(int));
+    check_alloc(smallest);
+    for (int u = 0; u < c.n; u++) {
+        smallest[u] = -1;
+    }
+    for (int u = 0; u < c.n; u++) {
+        if (!graph_csr_has_node(g, u)) {
+            continue;
+        }
+        int root = set_disjoint_find(ds, u);
+        if (smallest[root] < 0) {
+            smallest[root] = u;
+        }
+        c.labels[u] = smallest[root];
+    }
+    free(smallest);
+    set_disjoint_free(ds);
+    return c.labels;
+}
+
+int* graph_connected_components(Graph *g) {
+    GraphCSR *csr = graph_freeze(g);
+    if (csr == NULL) {
+        return NULL;
+    }
+    int *labels = graph_csr_connected_components(csr);
+    graph_csr_free(csr);
+    return labels;
+}
+
+static void components__part(Components *c, size_t part, int *from, int *to) {
+    *from = (int) ((size_t) c->n * part / c->parts);
+    *to = (int) ((size_t) c->n * (part + 1) / c->parts);
+}
+
+// link each node to its neighbor of the round
+static void components__link_round(void *context, size_t part) {
+    Components *c = (Components*) context;
+    int from, to;
+    components__part(c, part, &from, &to);
+    for (int u = from; u < to; u++) {
+        size_t e = c->offsets[u] + c->round;
+        if (e < c->offsets[u + 1]) {
+            set_disjoint_concurrent_union(c->ds, u, c->targets[e]);
+        }
+    }
+}
+
+// link the nodes out of the largest component to the rest of their neighbors
+static void components__link_rest(void *context, size_t part) {
+    Components *c = (Components*) context;
+    int from, to;
+    components__part(c, part, &from, &to);
+    for (int u = from; u < to; u++) {
+        if (!c->directed && set_disjoint_concurrent_find(c->ds, u) == c->largest) {
+            continue;
+        }
+        for (size_t e = c->offsets[u] + AFFOREST_ROUNDS; e < c->offsets[u + 1]; e++) {
+            set_disjoint_concurrent_union(c->ds, u, c->targets[e]);
+        }
+    }
+}
+
+static void components__label(void *context, size_t part) {
+    Components *c = (Components*) context;
+    int from, to;
+    components__part(c, part, &from, &to);
+    for (int u = from; u < to; u++) {
+        if (graph_csr_has_node(c->g, u)) {
+            c->labels[u] = set_disjoint_concurrent_find(c->ds, u);
+        }
+    }
+}
+
+static int components__compare(const void *a, const void *b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+// most frequent root among nodes picked by a fixed hash, ids out of the
+// graph are picked again a few times and then left as their own root
+static int components__largest(Components *c) {
+    int samples[AFFOREST_SAMPLES];
+    for (int i = 0; i < AFFOREST_SAMPLES; i++) {
+        int u = 0;
+        for (int k = 0; k < 8; k++) {
+            u = (int) (hash_mix((uint64_t) i * 8 + k) % c->n);
+            if (graph_csr_has_node(c->g, u)) {
+                break;
+            }
+        }
+        samples[i] = set_disjoint_concurrent_find(c->ds, u);
+    }
+    qsort(samples, AFFOREST_SAMPLES, sizeof(int), &components__compare);
+    int largest = samples[0], count = 0;
+    for (int i = 0, run = 0; i < AFFOREST_SAMPLES; i++) {
+        run = i > 0 && samples[i] == samples[i - 1] ? run + 1 : 1;
+        if (run > count) {
+            count = run;
+            largest = samples[i];
+        }
+    }
+    return largest;
+}
+
+int* graph_csr_connected_components_parallel(const GraphCSR *g, ThreadPool *pool) {
+    if (thread_pool_size(pool) < 2 || graph_csr_edges_count(g) < GRAPH_PARALLEL_MIN_EDGES) {
+        return graph_csr_connected_components(g);
+    }
+    Components c;
+    components__init(&c, g);
+
+    // roots are linked under the smallest one: each component is labelled
+    // by its smallest node, whatever the order of the unions
+    c.ds = set_disjoint_concurrent_create(c.n);
+    c.parts = thread_pool_size(pool) * PARALLEL_TASKS;
+    for (c.round = 0; c.round < AFFOREST_ROUNDS; c.round++) {
+        thread_pool_run(pool, &components__link_round, &c, c.parts);
+    }
+    c.largest = components__largest(&c);
+    thread_pool_run(pool, &components__link_rest, &c, c.parts);
+    thread_pool_run(pool, &components__label, &c, c.parts);
+
+    set_disjoint_concurrent_free(c.ds);
+    return c.labels;
+}
+
+int* graph_connected_components_parallel(Graph *g, ThreadPool *pool) {
+    GraphCSR *csr = graph_freeze(g);
+    if (csr == NULL) {
+        return NULL;
+    }
+    int *labels = graph_csr_connected_components_parallel(csr, pool);
+    graph_csr_free(csr);
+    return labels;
+}
@@ -0,0 +1,303 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "graph-csr.h"
+
+#define PARALLEL_TASKS 8   // tasks per thread, to balance the load
+#define DELTA_BINS 64      // buckets held by a task from the current one on, the later ones wait in a far pile
+
+// the distance of a node in the high half and its parent in the low one:
+// a smaller entry is a shorter path, so both are updated by a single CAS
+#define SSSP_ENTRY(d, p) ((uint64_t) (uint32_t) (d) << 32 | (uint32_t) (p))
+#define SSSP_DIST(entry) ((int) ((entry) >> 32))
+#define SSSP_PARENT(entry) ((int) (uint32_t) (entry))
+
+typedef struct SsspBuffer {
+    int *nodes;
+    size_t size;
+    size_t capacity;
+} SsspBuffer;
+
+// nodes pushed by a task, by bucket
+typedef struct SsspBins {
+    SsspBuffer near[DELTA_BINS];    // bucket b in near[b % DELTA_BINS]
+    SsspBuffer far;
+    int far_first;                  // no bucket of the far pile is before it
+} SsspBins;
+
+typedef struct DeltaStepping {
+    int n;
+    int delta;
+    const size_t *offsets;
+    const int *targets;
+    const int *weights;
+    uint64_t *entries;
+    int *light_at;      // distance of each node when its light edges were last relaxed
+    int *heavy_at;      // and its heavy edges
+    int bucket;         // current bucket
+    int *frontier;      // nodes of the current bucket to relax
+    size_t frontier_size;
+    SsspBuffer settled; // nodes relaxed in the current bucket
+    SsspBins *bins;     // one per task
+    size_t parts;
+    bool heavy;         // the kind of edges relaxed by the tasks
+} DeltaStepping;
+
+static void sssp__push(SsspBuffer *buffer, int u) {
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity = buffer->capacity > 0 ? 2 * buffer->capacity : 256;
+        buffer->nodes = (int*) realloc(buffer->nodes, buffer->capacity * sizeof(int));
+        check_alloc(buffer->nodes);
+    }
+    buffer->nodes[buffer->size++] = u;
+}
+
+static inline int sssp__dist(DeltaStepping *s, int u) {
+    return SSSP_DIST(__atomic_load_n(&s->entries[u], __ATOMIC_RELAXED));
+}
+
+static void sssp__bin(DeltaStepping *s, SsspBins *bins, int v, int d) {
+    int bucket = d / s->delta;
+    if (bucket < s->bucket + DELTA_BINS) {
+        sssp__push(&bins->near[bucket % DELTA_BINS], v);
+    } else {
+        sssp__push(&bins->far, v);
+        bins->far_first = bucket < bins->far_first ? bucket : bins->far_first;
+    }
+}
+
+// lower the distance of v through u, keeping the lowest one of concurrent relaxations
+static void sssp__relax(DeltaStepping *s, SsspBins *bins, int u, int v, int d) {
+    uint64_t entry = SSSP_ENTRY(d, u);
+    uint64_t current = __atomic_load_n(&s->entries[v], __ATOMIC_RELAXED);
+    while (entry < current) {
+        if (__atomic_compare_exchange_n(&s->entries[v], &current, entry, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            sssp__bin(s, bins, v, d);
+            return;
+        }
+    }
+}
+
+// relax the light or the heavy edges out of a part of the frontier, once
+// for each distance a node gets
+static void sssp__relax_part(void *context, size_t part) {
+    DeltaStepping *s = (DeltaStepping*) context;
+    SsspBins *bins = &s->bins[part];
+    size_t from = s->frontier_size * part / s->parts;
+    size_t to = s->frontier_size * (part + 1) / s->parts;
+    int *relaxed_at = s->heavy ? s->heavy_at : s->light_at;
+    for (size_t i = from; i < to; i++) {
+        int u = s->frontier[i];
+        int d = sssp__dist(s, u);
+        if (__atomic_exchange_n(&relaxed_at[u], d, __ATOMIC_RELAXED) == d) {
+            continue;
+        }
+        for (size_t e = s->offsets[u]; e < s->offsets[u + 1]; e++) {
+            if ((s->weights[e] > s->delta) == s->heavy) {
+                sssp__relax(s, bins, u, s->targets[e], d + s->weights[e]);
+            }
+        }
+    }
+}
+
+static void sssp__run(DeltaStepping *s, ThreadPool *pool) {
+    if (s->parts == 1) {
+        sssp__relax_part(s, 0);
+    } else {
+        thread_pool_run(pool, &sssp__relax_part, s, s->parts);
+    }
+}
+
+// take the nodes of the current bucket out of the bins of all tasks
+static void sssp__gather(DeltaStepping *s) {
+    s->frontier_size = 0;
+    for (size_t part = 0; part < s->parts; part++) {
+        SsspBuffer *bin = &s->bins[part].near[s->bucket % DELTA_BINS];
+        for (size_t i = 0; i < bin->size; i++) {
+            int u = bin->nodes[i];
+            // a node pushed again at a shorter distance was relaxed in an earlier bucket
+            if (sssp__dist(s, u) / s->delta == s->bucket) {
+                s->frontier[s->frontier_size++] = u;
+            }
+        }
+        bin->size = 0;
+    }
+}
+
+// move to the next bucket with nodes, false if there is none
+static bool sssp__next_bucket(DeltaStepping *s) {
+    int next = INT_MAX, far_first = INT_MAX;
+    for (int bucket = s->bucket + 1; next == INT_MAX && bucket < s->bucket + DELTA_BINS; bucket++) {
+        for (size_t part = 0; part < s->parts; part++) {
+            if (s->bins[part].near[bucket % DELTA_BINS].size > 0) {
+                next = bucket;
+                break;
+            }
+        }
+    }
+    for (size_t part = 0; part < s->parts; part++) {
+        far_first = s->bins[part].far_first < far_first ? s->bins[part].far_first : far_first;
+    }
+    next = far_first < next ? far_first : next;
+    if (next == INT_MAX) {
+        return false;
+    }
+    s->bucket = next;
+    if (far_first >= next + DELTA_BINS) {
+        return true;
+    }
+
+    // the far piles reach the new window of buckets: bring those nodes in,
+    // and drop the ones pushed again at a shorter distance since
+    for (size_t part = 0; part < s->parts; part++) {
+        SsspBins *bins = &s->bins[part];
+        size_t kept = 0;
+        bins->far_first = INT_MAX;
+        for (size_t i = 0; i < bins->far.size; i++) {
+            int u = bins->far.nodes[i], bucket = sssp__dist(s, u) / s->delta;
+            if (bucket < s->bucket) {
+                continue;
+            } else if (bucket < s->bucket + DELTA_BINS) {
+                sssp__push(&bins->near[bucket % DELTA_BINS], u);
+            } else {
+                bins->far.nodes[kept++] = u;
+                bins->far_first = bucket < bins->far_first ? bucket : bins->far_first;
+            }
+        }
+        bins->far.size = kept;
+    }
+    return true;
+}
+
+// the largest weight over the average degree, after Meyer and Sanders
+static int sssp__auto_delta(const GraphCSR *g) {
+    const int *weights = graph_csr_weights(g);
+    size_t edges = graph_csr_edges_count(g), nodes = graph_csr_size(g);
+    int max_weight = 1;
+    for (size_t e = 0; e < edges; e++) {
+        max_weight = weights[e] > max_weight ? weights[e] : max_weight;
+    }
+    size_t degree = nodes > 0 ? edges / nodes : 1;
+    int delta = (int) (max_weight / (degree > 0 ? degree : 1));
+    return delta > 0 ? delta : 1;
+}
+
+void graph_csr_sssp_delta_stepping(const GraphCSR *g, int source, int delta, int *dist, int *parent, ThreadPool *pool) {
+    DeltaStepping s;
+    s.n = graph_csr_max_node_id(g) + 1;
+    for (int u = 0; u < s.n; u++) {
+        dist[u] = INT_MAX;
+        parent[u] = -1;
+    }
+    if (!graph_csr_has_node(g, source)) {
+        return;
+    }
+    s.delta = delta > 0 ? delta : sssp__auto_delta(g);
+    s.offsets = graph_csr_offsets(g);
+    s.targets = graph_csr_targets(g);
+    s.weights = graph_csr_weights(g);
+    bool parallel = thread_pool_size(pool) > 1 && graph_csr_edges_count(g) >= GRAPH_PARALLEL_MIN_EDGES;
+    s.parts = parallel ? thread_pool_size(pool) * PARALLEL_TASKS : 1;
+    s.entries = (uint64_t*) malloc(s.n * sizeof(uint64_t));
+    s.light_at = (int*) malloc(s.n * sizeof(int));
+    s.heavy_at = (int*) malloc(s.n * sizeof(int));
+    s.frontier = NULL;
+    s.bins = (SsspBins*) calloc(s.parts, sizeof(SsspBins));
+    check_alloc(s.entries);
+    check_alloc(s.light_at);
+    check_alloc(s.heavy_at);
+    check_alloc(s.bins);
+    for (size_t part = 0; part < s.parts; part++) {
+        s.bins[part].far_first = INT_MAX;
+    }
+    for (int u = 0; u < s.n; u++) {
+        s.entries[u] = SSSP_ENTRY(INT_MAX, -1);
+        s.light_at[u] = -1;
+        s.heavy_at[u] = -1;
+    }
+    s.settled.nodes = NULL;
+    s.settled.size = 0;
+    s.settled.capacity = 0;
+
+    size_t frontier_capacity = 256;
+    s.frontier = (int*) malloc(frontier_capacity * sizeof(int));
+    check_alloc(s.frontier);
+    s.entries[source] = SSSP_ENTRY(0, -1);
+    s.bucket = 0;
+    sssp__push(&s.bins[0].near[0], source);
+    do {
+        // relax the light edges until no node is left in the bucket, then
+        // the heavy edges of the nodes settled, which lead to later buckets
+        s.settled.size = 0;
+        s.heavy = false;
+        for (;;) {
+            size_t pending = 0;
+            for (size_t part = 0; part < s.parts; part++) {
+                pending += s.bins[part].near[s.bucket % DELTA_BINS].size;
+            }
+            if (pending == 0) {
+                break;
+            }
+            if (pending > frontier_capacity) {
+                frontier_capacity = pending;
+                s.frontier = (int*) realloc(s.frontier, frontier_capacity * sizeof(int));
+                check_alloc(s.frontier);
+            }
+            sssp__gather(&s);
+            sssp__run(&s, pool);
+            for (size_t i = 0; i < s.frontier_size; i++) {
+                sssp__push(&s.settled, s.frontier[i]);
+            }
+        }
+        if (s.settled.size > frontier_capacity) {
+            frontier_capacity = s.settled.size;
+            s.frontier = (int*) realloc(s.frontier, frontier_capacity * sizeof(int));
+            check_alloc(s.frontier);
+        }
+        for (size_t i = 0; i < s.settled.size; i++) {
+            s.frontier[i] = s.settled.nodes[i];
+        }
+        s.frontier_size = s.settled.size;
+        s.heavy = true;
+        sssp__run(&s, pool);
+    } while (sssp__next_bucket(&s));
+
+    for (int u = 0; u < s.n; u++) {
+        dist[u] = SSSP_DIST(s.entries[u]);
+        parent[u] = SSSP_PARENT(s.entries[u]);
+    }
+    for (size_t part = 0; part < s.parts; part++) {
+        for (int i = 0; i < DELTA_BINS; i++) {
+            free(s.bins[part].near[i].nodes);
+        }
+        free(s.bins[part].far.nodes);
+    }
+    free(s.bins);
+    free(s.settled.nodes);
+    free(s.frontier);
+    free(s.entries);
+    free(s.light_at);
+    free(s.heavy_at);
+}
+
+void graph_sssp_delta_stepping(Graph *g, int source, int delta, int *dist, int *parent, ThreadPool *pool) {
+    GraphCSR *csr = graph_freeze(g);
+    if (csr == NULL) {
+        return;
+    }
+    graph_csr_sssp_delta_stepping(csr, source, delta, dist, parent, pool);
+    graph_csr_free(csr);
+}
@@ -12,57 +12,63 @@
 
 #include <limits.h>
 #include "graph.h"
-#include "../pqueue/pqueue.h"
+#include "graph-queue.h"
 #include "../stack/stack.h"
 #include "../iterator/iterator.h"
 
-#define DIJKSTRA_INFINITY INT_MAX
-
 Graph* graph_dijkstra(Graph* g, int source) {
-    int n = graph_max_node_id(g) + 1;
+    // distances indexed by node id from the smallest one, the nodes being sorted
+    Graph *g_new = graph_create();
+    Iterator *it = graph_nodes_iterator(g);
+    if (iterator_done(it) || !graph_has_node(g, source)) {
+        iterator_free(it);
+        return g_new;
+    }
+    int first = *(int*) iterator_next(it), last = first;
+    while (!iterator_done(it)) {
+        last = *(int*) iterator_next(it);
+    }
+    iterator_free(it);
+    size_t n = (size_t) ((long long) last - first + 1);
     int *dist = (int*) malloc(sizeof(int) * n);
     int *prev = (int*) malloc(sizeof(int) * n);
-
-    for (int i = 0; i < n; i++) {
-        dist[i] = DIJKSTRA_INFINITY;
+    check_alloc(dist);
+    check_alloc(prev);
+    for (size_t i = 0; i < n; i++) {
+        dist[i] = INT_MAX;
         prev[i] = -1;
     }
 
-    dist[source] = 0;
-
-    PQueue *pq = pqueue_create(MIN_PQUEUE);
-    pqueue_insert(pq, source, 0);
-
-    while (!pqueue_is_empty(pq)) {
-        PQueueNode u_node = pqueue_extract(pq);
-        int u = u_node.key;
-
-        Set *neighbors = graph_get_neighbors(g, u);
-        Iterator *it = set_iterator(neighbors);
-
-        while (!iterator_done(it)) {
-            int v = *(int*) iterator_next(it);
-            int weight = graph_get_edge_weight(g, u, v);
-            if (dist[u] != DIJKSTRA_INFINITY && dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
-                prev[v] = u;
-                pqueue_update_key(pq, v, dist[v]);
+    GraphQueue *q = graph_queue_create(GRAPH_QUEUE_AUTO, graph_min_edge_weight(g), graph_max_edge_weight(g));
+    dist[source - first] = 0;
+    graph_queue_push(q, 0, source, -1);
+    while (!graph_queue_empty(q)) {
+        GraphQueueItem item = graph_queue_pop(q);
+        int u = item.node;
+        if (item.priority > dist[u - first]) {
+            continue;
+        }
+        GraphNeighbors neighbors = graph_neighbors_begin(g, u);
+        while (graph_neighbors_next(&neighbors)) {
+            int v = neighbors.node, d = dist[u - first] + neighbors.weight;
+            if (d < dist[v - first]) {
+                dist[v - first] = d;
+                prev[v - first] = u;
+                graph_queue_push(q, d, v, u);
             }
         }
-        iterator_free(it);
-        set_free(neighbors);
     }
+    graph_queue_free(q);
 
-    Graph *g_new = graph_create();
-    for (int i = 0; i < n; i++) {
-        if (prev[i] != -1) {
-            graph_add_node(g_new, i);
+    for (size_t i = 0; i < n; i++) {
+        if (dist[i] != INT_MAX && (int) i + first != source) {
+            int v = (int) i + first;
+            graph_add_node(g_new, v);
             graph_add_node(g_new, prev[i]);
-            graph_add_edge_with_weight(g_new, prev[i], i, dist[i]);
+            graph_add_edge_with_weight(g_new, prev[i], v, dist[i]);
         }
     }
 
-    pqueue_free(pq);
     free(dist);
     free(prev);
 
@@ -82,18 +88,14 @@ List* graph_shortest_path(Graph* g, int source, int destination) {
         int node = stack_pop(dfs);
         set_add(visited, node);
 
-        Set *neighbors = graph_get_neighbors(g_dijkstra, node);
-        Iterator *it = set_iterator(neighbors);
-
-        while (!iterator_done(it)) {
-            int neighbor = *(int*) iterator_next(it);
+        GraphNeighbors neighbors = graph_neighbors_begin(g_dijkstra, node);
+        while (graph_neighbors_next(&neighbors)) {
+            int neighbor = neighbors.node;
             hash_table_put(prev, neighbor, node);
             if (!set_contains(visited, neighbor)) {
                 stack_push(dfs, neighbor);
             }
         }
-        set_free(neighbors);
-        iterator_free(it);
     }
     stack_free(dfs);
     set_free(visited);
@@ -0,0 +1,189 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include "graph-csr.h"
+
+#define UNCLASSIFIED -1
+
+// a node being explored and its next edge
+typedef struct TarjanFrame {
+    int node;
+    size_t edge;
+} TarjanFrame;
+
+typedef struct TarjanCSR {
+    const GraphCSR *g;
+    const size_t *offsets;
+    const int *targets;
+    int *types;         // of each edge, or UNCLASSIFIED
+    int *components;
+    int *exploration;
+    int *complete;
+    int counter_exploration;
+    int counter_complete;
+    int *path;          // for strong connected components
+    bool *on_path;
+    size_t path_size;
+    TarjanFrame *frames;
+    size_t depth;
+} TarjanCSR;
+
+static EdgeType tarjan_csr__classify(TarjanCSR *t, int parent, int u) {
+    if (t->exploration[u] == 0) {
+        return TREE;
+    } else if (t->exploration[u] > t->exploration[parent]) {
+        return FORWARD;
+    } else if (t->complete[u] > 0) {
+        return CROSS;
+    } else {
+        return BACK;
+    }
+}
+
+// the edge of an undirected graph has the type it got from its first end
+static void tarjan_csr__record(TarjanCSR *t, int u, size_t e, EdgeType edge_type) {
+    if (t->types[e] != UNCLASSIFIED) {
+        return;
+    }
+    t->types[e] = edge_type;
+    if (!graph_csr_is_directed(t->g)) {
+        int v = t->targets[e];
+        for (size_t r = t->offsets[v]; r < t->offsets[v + 1]; r++) {
+            if (t->targets[r] == u) {
+                t->types[r] = edge_type;
+                break;
+            }
+        }
+    }
+}
+
+static void tarjan_csr__enter(TarjanCSR *t, int u) {
+    t->exploration[u] = ++t->counter_exploration;
+    t->components[u] = t->exploration[u];
+    t->path[t->path_size++] = u;
+    t->on_path[u] = true;
+    TarjanFrame frame = {u, t->offsets[u]};
+    t->frames[t->depth++] = frame;
+}
+
+static inline int tarjan_csr__min(int a, int b) {
+    return a < b ? a : b;
+}
+
+// the depth-first search of graph_dfst(), with a stack of frames instead of
+// recursion so that long paths do not exhaust the stack
+static void tarjan_csr__explore(TarjanCSR *t, int start) {
+    tarjan_csr__enter(t, start);
+    while (t->depth > 0) {
+        TarjanFrame *frame = &t->frames[t->depth - 1];
+        int u = frame->node;
+        if (frame->edge < t->offsets[u + 1]) {
+            size_t e = frame->edge++;
+            int v = t->targets[e];
+            EdgeType edge_type = tarjan_csr__classify(t, u, v);
+            tarjan_csr__record(t, u, e, edge_type);
+            if (edge_type == TREE) {
+                tarjan_csr__enter(t, v);
+            } else if (t->on_path[v]) {
+                t->components[u] = tarjan_csr__min(t->components[u], t->exploration[v]);
+            }
+            continue;
+        }
+
+        // pop elements for components visited in a cycle
+        if (t->components[u] == t->exploration[u]) {
+            int w;
+            do {
+                w = t->path[--t->path_size];
+                t->on_path[w] = false;
+            } while (w != u);
+        }
+        t->complete[u] = ++t->counter_complete;
+        t->depth--;
+        if (t->depth > 0) {
+            int parent = t->frames[t->depth - 1].node;
+            t->components[parent] = tarjan_csr__min(t->components[parent], t->components[u]);
+        }
+    }
+}
+
+static void tarjan_csr(const GraphCSR *g, int *types, int *components) {
+    int n = graph_csr_max_node_id(g) + 1;
+    TarjanCSR t;
+    t.g = g;
+    t.offsets = graph_csr_offsets(g);
+    t.targets = graph_csr_targets(g);
+    t.types = types;
+    t.components = components;
+    t.exploration = (int*) calloc(n, sizeof(int));
+    t.complete = (int*) calloc(n, sizeof(int));
+    t.path = (int*) malloc(n * sizeof(int));
+    t.on_path = (bool*) calloc(n, sizeof(bool));
+    t.frames = (TarjanFrame*) malloc(n * sizeof(TarjanFrame));
+    check_alloc(t.exploration);
+    check_alloc(t.complete);
+    check_alloc(t.path);
+    check_alloc(t.on_path);
+    check_alloc(t.frames);
+    t.counter_exploration = 0;
+    t.counter_complete = 0;
+    t.path_size = 0;
+    t.depth = 0;
+
+    for (size_t e = 0; e < graph_csr_edges_count(g); e++) {
+        types[e] = UNCLASSIFIED;
+    }
+    for (int u = 0; u < n; u++) {
+        components[u] = -1;
+    }
+    // dfs over each node
+    for (int u = 0; u < n; u++) {
+        if (graph_csr_has_node(g, u) && t.exploration[u] == 0) {
+            tarjan_csr__explore(&t, u);
+        }
+    }
+    free(t.exploration);
+    free(t.complete);
+    free(t.path);
+    free(t.on_path);
+    free(t.frames);
+}
+
+EdgeType* graph_csr_tarjan(const GraphCSR *g) {
+    int n = graph_csr_max_node_id(g) + 1;
+    int *types = (int*) malloc((graph_csr_edges_count(g) + 1) * sizeof(int));
+    int *components = (int*) malloc(n * sizeof(int));
+    check_alloc(types);
+    check_alloc(components);
+    tarjan_csr(g, types, components);
+    free(components);
+
+    EdgeType *edge_types = (EdgeType*) malloc((graph_csr_edges_count(g) + 1) * sizeof(EdgeType));
+    check_alloc(edge_types);
+    for (size_t e = 0; e < graph_csr_edges_count(g); e++) {
+        edge_types[e] = (EdgeType) types[e];
+    }
+    free(types);
+    return edge_types;
+}
+
+int* graph_csr_strong_components(const GraphCSR *g) {
+    int n = graph_csr_max_node_id(g) + 1;
+    int *types = (int*) malloc((graph_csr_edges_count(g) + 1) * sizeof(int));
+    int *components = (int*) malloc(n * sizeof(int));
+    check_alloc(types);
+    check_alloc(components);
+    tarjan_csr(g, types, components);
+    free(types);
+    return components;
+}
@@ -0,0 +1,304 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include "graph-csr.h"
+
+struct GraphCSR {
+    int n;              // node ids from 0 to n - 1
+    size_t n_nodes;
+    bool directed;
+    size_t *offsets;    // n + 1 offsets in the targets
+    int *targets;
+    int *weights;
+    int min_weight;     // of all edges, 0 for a graph without edges
+    int max_weight;
+    uint64_t *nodes;    // bit u % 64 of word u / 64 set for the nodes of the graph
+};
+
+static inline bool graph_csr__bit(const uint64_t *bits, int u) {
+    return bits[u / 64] >> (u % 64) & 1;
+}
+
+static inline void graph_csr__set_bit(uint64_t *bits, int u) {
+    bits[u / 64] |= (uint64_t) 1 << (u % 64);
+}
+
+static uint64_t* graph_csr__bits(int n) {
+    uint64_t *bits = (uint64_t*) calloc(n / 64 + 1, sizeof(uint64_t));
+    check_alloc(bits);
+    return bits;
+}
+
+GraphCSR* graph_freeze(Graph *g) {
+    size_t n_nodes = graph_size(g);
+    int *nodes = (int*) malloc((n_nodes + 1) * sizeof(int));
+    check_alloc(nodes);
+    Iterator *it = graph_nodes_iterator(g);
+    for (size_t i = 0; !iterator_done(it); i++) {
+        nodes[i] = *(int*) iterator_next(it);
+    }
+    iterator_free(it);
+    // the nodes are sorted, a negative id has no index in the arrays
+    if (n_nodes > 0 && nodes[0] < 0) {
+        free(nodes);
+        return NULL;
+    }
+    GraphCSR *csr = (GraphCSR*) malloc(sizeof(GraphCSR));
+    check_alloc(csr);
+    csr->n_nodes = n_nodes;
+    csr->directed = graph_is_directed(g);
+    csr->n = csr->n_nodes > 0 ? nodes[csr->n_nodes - 1] + 1 : 1;
+
+    size_t capacity = 1024, n_edges = 0;
+    csr->offsets = (size_t*) malloc((csr->n + 1) * sizeof(size_t));
+    check_alloc(csr->offsets);
+    csr->targets = (int*) malloc(capacity * sizeof(int));
+    check_alloc(csr->targets);
+    csr->weights = (int*) malloc(capacity * sizeof(int));
+    check_alloc(csr->weights);
+    csr->nodes = graph_csr__bits(csr->n);
+    csr->min_weight = INT_MAX;
+    csr->max_weight = INT_MIN;
+    int next = 0;
+    for (size_t i = 0; i < csr->n_nodes; i++) {
+        int u = nodes[i];
+        while (next <= u) {
+            csr->offsets[next++] = n_edges;
+        }
+        graph_csr__set_bit(csr->nodes, u);
+        GraphNeighbors neighbors = graph_neighbors_begin(g, u);
+        while (graph_neighbors_next(&neighbors)) {
+            if (n_edges == capacity) {
+                capacity *= 2;
+                csr->targets = (int*) realloc(csr->targets, capacity * sizeof(int));
+                check_alloc(csr->targets);
+                csr->weights = (int*) realloc(csr->weights, capacity * sizeof(int));
+                check_alloc(csr->weights);
+            }
+            csr->targets[n_edges] = neighbors.node;
+            csr->weights[n_edges++] = neighbors.weight;
+            csr->min_weight = neighbors.weight < csr->min_weight ? neighbors.weight : csr->min_weight;
+            csr->max_weight = neighbors.weight > csr->max_weight ? neighbors.weight : csr->max_weight;
+        }
+    }
+    while (next <= csr->n) {
+        csr->offsets[next++] = n_edges;
+    }
+    if (n_edges == 0) {
+        csr->min_weight = 0;
+        csr->max_weight = 0;
+    }
+    free(nodes);
+    return csr;
+}
+
+size_t graph_csr_size(const GraphCSR *g) {
+    return g->n_nodes;
+}
+
+size_t graph_csr_edges_count(const GraphCSR *g) {
+    return g->offsets[g->n];
+}
+
+int graph_csr_max_node_id(const GraphCSR *g) {
+    return g->n - 1;
+}
+
+bool graph_csr_is_directed(const GraphCSR *g) {
+    return g->directed;
+}
+
+bool graph_csr_has_node(const GraphCSR *g, int u) {
+    return u >= 0 && u < g->n && graph_csr__bit(g->nodes, u);
+}
+
+size_t graph_csr_degree(const GraphCSR *g, int u) {
+    return graph_csr_has_node(g, u) ? g->offsets[u + 1] - g->offsets[u] : 0;
+}
+
+const size_t* graph_csr_offsets(const GraphCSR *g) {
+    return g->offsets;
+}
+
+const int* graph_csr_targets(const GraphCSR *g) {
+    return g->targets;
+}
+
+const int* graph_csr_weights(const GraphCSR *g) {
+    return g->weights;
+}
+
+int graph_csr_min_weight(const GraphCSR *g) {
+    return g->min_weight;
+}
+
+int graph_csr_max_weight(const GraphCSR *g) {
+    return g->max_weight;
+}
+
+void graph_csr_free(GraphCSR *g) {
+    free(g->offsets);
+    free(g->targets);
+    free(g->weights);
+    free(g->nodes);
+    free(g);
+}
+
+// the nodes of a traversal, visited up front and handed out by an iterator
+typedef struct GraphCSRWalk {
+    size_t size;
+    size_t next;
+    // followed by the size nodes, in the order of the visit
+} GraphCSRWalk;
+
+static inline int* graph_csr__walk_nodes(GraphCSRWalk *w) {
+    return (int*) (w + 1);
+}
+
+static void* graph_csr__walk_next(Iterator *it) {
+    GraphCSRWalk *w = (GraphCSRWalk*) it->container;
+    return &graph_csr__walk_nodes(w)[w->next++];
+}
+
+static bool graph_csr__walk_done(Iterator *it) {
+    GraphCSRWalk *w = (GraphCSRWalk*) it->container;
+    return w->next == w->size;
+}
+
+static void graph_csr__walk_free(Iterator *it) {
+    free(it->container);
+    free(it);
+}
+
+// nodes are visited when taken from the pending ones, a queue or a stack,
+// and their neighbors not seen yet become pending, as graph_bfs() and
+// graph_dfs() do
+static Iterator* graph_csr__walk(GraphCSR *g, int start_node, bool stack) {
+    GraphCSRWalk *w = (GraphCSRWalk*) malloc(sizeof(GraphCSRWalk) + (g->n + 1) * sizeof(int));
+    check_alloc(w);
+    int *order = graph_csr__walk_nodes(w);
+    int *pending = (int*) malloc((g->n + 1) * sizeof(int));
+    check_alloc(pending);
+    uint64_t *seen = graph_csr__bits(g->n);
+    size_t head = 0, tail = 0, size = 0;
+    int next_node = 0;
+
+    pending[tail++] = start_node;
+    if (graph_csr_has_node(g, start_node)) {
+        graph_csr__set_bit(seen, start_node);
+    }
+    for (;;) {
+        // the nodes of a directed graph not reached yet, by increasing id
+        while (head == tail && g->directed && next_node < g->n) {
+            if (graph_csr__bit(g->nodes, next_node) && !graph_csr__bit(seen, next_node)) {
+                graph_csr__set_bit(seen, next_node);
+                pending[tail++] = next_node;
+            }
+            next_node++;
+        }
+        if (head == tail) {
+            break;
+        }
+        int u = stack ? pending[--tail] : pending[head++];
+        order[size++] = u;
+        if (!graph_csr_has_node(g, u)) {
+            continue;
+        }
+        for (size_t e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            int v = g->targets[e];
+            if (!graph_csr__bit(seen, v)) {
+                graph_csr__set_bit(seen, v);
+                pending[tail++] = v;
+            }
+        }
+    }
+    w->size = size;
+    w->next = 0;
+    free(pending);
+    free(seen);
+    return iterator_create(w, &graph_csr__walk_next, &graph_csr__walk_free, &graph_csr__walk_done);
+}
+
+Iterator* graph_csr_bfs(GraphCSR *g, int start_node) {
+    return graph_csr__walk(g, start_node, false);
+}
+
+Iterator* graph_csr_dfs(GraphCSR *g, int start_node) {
+    return graph_csr__walk(g, start_node, true);
+}
+
+void graph_csr_dijkstra_with_queue(const GraphCSR *g, int source, int *dist, int *parent, GraphQueueType queue) {
+    for (int u = 0; u < g->n; u++) {
+        dist[u] = INT_MAX;
+        parent[u] = -1;
+    }
+    if (!graph_csr_has_node(g, source)) {
+        return;
+    }
+    GraphQueue *q = graph_queue_create(queue, g->min_weight, g->max_weight);
+    dist[source] = 0;
+    graph_queue_push(q, 0, source, -1);
+    while (!graph_queue_empty(q)) {
+        GraphQueueItem item = graph_queue_pop(q);
+        int u = item.node;
+        if (item.priority > dist[u]) {
+            continue;
+        }
+        for (size_t e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            int v = g->targets[e], d = dist[u] + g->weights[e];
+            if (d < dist[v]) {
+                dist[v] = d;
+                parent[v] = u;
+                graph_queue_push(q, d, v, u);
+            }
+        }
+    }
+    graph_queue_free(q);
+}
+
+void graph_csr_dijkstra(const GraphCSR *g, int source, int *dist, int *parent) {
+    graph_csr_dijkstra_with_queue(g, source, dist, parent, GRAPH_QUEUE_AUTO);
+}
+
+int graph_csr_prim(const GraphCSR *g, int start, int *parent) {
+    for (int u = 0; u < g->n; u++) {
+        parent[u] = -1;
+    }
+    if (!graph_csr_has_node(g, start)) {
+        return 0;
+    }
+    uint64_t *in_tree = graph_csr__bits(g->n);
+    GraphQueue *heap = graph_queue_create(GRAPH_QUEUE_BINARY_HEAP, INT_MIN, INT_MAX);
+    int total = 0;
+    graph_queue_push(heap, 0, start, -1);
+    while (!graph_queue_empty(heap)) {
+        GraphQueueItem item = graph_queue_pop(heap);
+        int u = item.node;
+        if (graph_csr__bit(in_tree, u)) {
+            continue;
+        }
+        graph_csr__set_bit(in_tree, u);
+        parent[u] = item.from;
+        total += item.from >= 0 ? item.priority : 0;
+        for (size_t e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            if (!graph_csr__bit(in_tree, g->targets[e])) {
+                graph_queue_push(heap, g->weights[e], g->targets[e], u);
+            }
+        }
+    }
+    graph_queue_free(heap);
+    free(in_tree);
+    return total;
+}
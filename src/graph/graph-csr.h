@@ -0,0 +1,267 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef GRAPH_CSR_H
+#define GRAPH_CSR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "graph.h"
+#include "graph-queue.h"
+
+/**
+ * @brief An immutable graph in compressed sparse row (CSR) form.
+ *
+ * A snapshot of a Graph for analytics: the neighbors of all nodes are laid
+ * out in one array of targets, with their weights in another one, and the
+ * node u has its neighbors from offsets[u] to offsets[u + 1] - 1. Nodes are
+ * indexed by id, so that a visit of the neighbors walks contiguous memory
+ * instead of a hash table lookup and a set per node. Neighbors are in the
+ * order of the sets of the graph, so the traversals visit the nodes in the
+ * same order as the ones of a Graph.
+ *
+ * The node ids must be non-negative, and the arrays take the largest one
+ * plus one entries.
+ */
+typedef struct GraphCSR GraphCSR;
+
+/**
+ * @brief Build the CSR form of a graph.
+ * @param g The graph, left unchanged.
+ * @return pointer to the newly created CSR graph, or NULL if some node id
+ * is negative.
+ * @ingroup DataStructureMethods
+ */
+GraphCSR* graph_freeze(Graph *g);
+
+/**
+ * @brief Get the number of nodes.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+size_t graph_csr_size(const GraphCSR *g);
+
+/**
+ * @brief Get the number of edges, the ones of an undirected graph counted
+ * from both ends.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+size_t graph_csr_edges_count(const GraphCSR *g);
+
+/**
+ * @brief Get the maximum node id, 0 for an empty graph.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+int graph_csr_max_node_id(const GraphCSR *g);
+
+/**
+ * @brief Check if the graph is directed.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+bool graph_csr_is_directed(const GraphCSR *g);
+
+/**
+ * @brief Check if a node exists in the graph.
+ * @param g The CSR graph.
+ * @param u The node.
+ * @ingroup DataStructureMethods
+ */
+bool graph_csr_has_node(const GraphCSR *g, int u);
+
+/**
+ * @brief Get the number of neighbors of a node.
+ * @param g The CSR graph.
+ * @param u The node.
+ * @return the degree of u, 0 if it is not in the graph.
+ * @ingroup DataStructureMethods
+ */
+size_t graph_csr_degree(const GraphCSR *g, int u);
+
+/**
+ * @brief Get the offsets of the neighbors of each node.
+ * @param g The CSR graph.
+ * @return graph_csr_max_node_id() + 2 offsets in the targets, owned by the graph.
+ * @ingroup DataStructureMethods
+ */
+const size_t* graph_csr_offsets(const GraphCSR *g);
+
+/**
+ * @brief Get the neighbors of all nodes.
+ * @param g The CSR graph.
+ * @return graph_csr_edges_count() node ids, owned by the graph.
+ * @ingroup DataStructureMethods
+ */
+const int* graph_csr_targets(const GraphCSR *g);
+
+/**
+ * @brief Get the weights of the edges, in the order of the targets.
+ * @param g The CSR graph.
+ * @return graph_csr_edges_count() weights, owned by the graph.
+ * @ingroup DataStructureMethods
+ */
+const int* graph_csr_weights(const GraphCSR *g);
+
+/**
+ * @brief Get the smallest weight of the edges, 0 if there are none.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+int graph_csr_min_weight(const GraphCSR *g);
+
+/**
+ * @brief Get the largest weight of the edges, 0 if there are none.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+int graph_csr_max_weight(const GraphCSR *g);
+
+/**
+ * @brief Free memory of the CSR graph.
+ * @param g The CSR graph.
+ * @ingroup DataStructureMethods
+ */
+void graph_csr_free(GraphCSR *g);
+
+/**
+ * @brief Breadth-First Search, in the order of graph_bfs().
+ *
+ * The nodes of a directed graph not reached from the start node are
+ * visited next, by increasing id.
+ * @param g The CSR graph.
+ * @param start_node The node to start the traversal from.
+ * @return A node iterator
+ * @ingroup DataStructureMethods
+ */
+Iterator* graph_csr_bfs(GraphCSR *g, int start_node);
+
+/**
+ * @brief Depth-First Search, in the order of graph_dfs().
+ * @param g The CSR graph.
+ * @param start_node The node to start the traversal from.
+ * @return A node iterator
+ * @ingroup DataStructureMethods
+ */
+Iterator* graph_csr_dfs(GraphCSR *g, int start_node);
+
+/**
+ * @brief Shortest paths from a node by Dijkstra's algorithm.
+ *
+ * The queue is picked from the weights: Dial's buckets up to
+ * GRAPH_QUEUE_DIAL_MAX_WEIGHT, a radix heap above, and a binary heap if some
+ * weight is negative.
+ * @param g The CSR graph, of non-negative weights.
+ * @param source The source node.
+ * @param dist array of graph_csr_max_node_id() + 1 entries, set to the
+ * distance of each node from the source, INT_MAX if unreachable.
+ * @param parent array of as many entries, set to the previous node of the
+ * shortest path to each node, -1 for the source and the unreachable nodes.
+ * @ingroup DataStructureMethods
+ */
+void graph_csr_dijkstra(const GraphCSR *g, int source, int *dist, int *parent);
+
+/**
+ * @brief Shortest paths from a node by Dijkstra's algorithm on a given queue.
+ * @param g The CSR graph, of non-negative weights.
+ * @param source The source node.
+ * @param dist array of graph_csr_max_node_id() + 1 entries, set to the
+ * distance of each node from the source, INT_MAX if unreachable.
+ * @param parent array of as many entries, set to the previous node of the
+ * shortest path to each node, -1 for the source and the unreachable nodes.
+ * @param queue the priority queue of the nodes
+ * @ingroup DataStructureMethods
+ */
+void graph_csr_dijkstra_with_queue(const GraphCSR *g, int source, int *dist, int *parent, GraphQueueType queue);
+
+/**
+ * @brief Minimum spanning tree of the component of a node by Prim's algorithm.
+ * @param g The CSR graph, undirected.
+ * @param start The node to start from.
+ * @param parent array of graph_csr_max_node_id() + 1 entries, set to the
+ * parent of each node in the tree, -1 for the start node and the nodes out
+ * of its component.
+ * @return the sum of the weights of the tree, as graph_edges_sum() of graph_prim().
+ * @ingroup DataStructureMethods
+ */
+int graph_csr_prim(const GraphCSR *g, int start, int *parent);
+
+/**
+ * @brief Classify the edges by a depth-first search, as graph_tarjan().
+ *
+ * The search starts from each node not explored yet, by increasing id. An
+ * edge of an undirected graph is classified from the end explored first,
+ * both of its entries get the same type.
+ * @param g The CSR graph.
+ * @return array of the type of each edge, in the order of the targets.
+ * @ingroup DataStructureMethods
+ */
+EdgeType* graph_csr_tarjan(const GraphCSR *g);
+
+/**
+ * @brief Strong components by Tarjan's algorithm, as graph_strong_components().
+ * @param g The CSR graph.
+ * @return array of components indexed by node id, -1 for the ids not in the graph.
+ * @ingroup DataStructureMethods
+ */
+int* graph_csr_strong_components(const GraphCSR *g);
+
+/**
+ * @brief Label the connected components, as graph_connected_components().
+ * @param g The CSR graph.
+ * @return array indexed by node id: the smallest node of the component of
+ * each node, -1 for the ids not in the graph.
+ * @ingroup DataStructureMethods
+ */
+int* graph_csr_connected_components(const GraphCSR *g);
+
+/**
+ * @brief Label the connected components on a thread pool, as
+ * graph_connected_components_parallel().
+ * @param g The CSR graph.
+ * @param pool threads to run on
+ * @return the same labels as graph_csr_connected_components()
+ * @ingroup DataStructureMethods
+ */
+int* graph_csr_connected_components_parallel(const GraphCSR *g, ThreadPool *pool);
+
+/**
+ * @brief Breadth-first search level by level on a thread pool, as
+ * graph_bfs_levels().
+ * @param g The CSR graph.
+ * @param source The node to start from.
+ * @param depth array of graph_csr_max_node_id() + 1 entries, set to the
+ * number of edges from the source to each node, -1 for the nodes not reached.
+ * @param parent array of as many entries, set to the node each node was
+ * reached from, -1 for the source and the nodes not reached.
+ * @param pool threads to run on
+ * @ingroup DataStructureMethods
+ */
+void graph_csr_bfs_levels(const GraphCSR *g, int source, int *depth, int *parent, ThreadPool *pool);
+
+/**
+ * @brief Shortest paths from a source by delta-stepping on a thread pool, as
+ * graph_sssp_delta_stepping().
+ * @param g The CSR graph, of non-negative weights.
+ * @param source The source node.
+ * @param delta width of the buckets, 0 or less to pick it from the graph.
+ * @param dist array of graph_csr_max_node_id() + 1 entries, set to the
+ * distance of each node from the source, INT_MAX if unreachable.
+ * @param parent array of as many entries, set to the previous node of a
+ * shortest path to each node, -1 for the source and the unreachable nodes.
+ * @param pool threads to run on
+ * @ingroup DataStructureMethods
+ */
+void graph_csr_sssp_delta_stepping(const GraphCSR *g, int source, int delta, int *dist, int *parent, ThreadPool *pool);
+
+#endif /* GRAPH_CSR_H */
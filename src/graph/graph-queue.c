@@ -0,0 +1,181 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include "graph-queue.h"
+#include "../utils/check_alloc.h"
+
+// items in an array, as a binary min-heap or as a bucket
+typedef struct GraphQueueHeap {
+    GraphQueueItem *items;
+    size_t size;
+    size_t capacity;
+} GraphQueueHeap;
+
+// monotone radix heap: the items of bucket i > 0 differ from the last key
+// popped first at bit i - 1, so that only the items of the first bucket
+// not empty are moved down on a pop, each of them at most 32 times
+#define GRAPH_QUEUE_RADIX_BUCKETS 33
+
+struct GraphQueue {
+    GraphQueueType type;
+    size_t size;
+    GraphQueueHeap heap;
+    GraphQueueHeap radix[GRAPH_QUEUE_RADIX_BUCKETS];
+    unsigned last;          // key of the radix heap popped last
+    GraphQueueHeap *dial;   // bucket d % n_dial for the key d
+    size_t n_dial;
+    int current;            // key of the dial bucket popped from
+};
+
+static inline bool graph_queue__less(const GraphQueueItem *a, const GraphQueueItem *b) {
+    return a->priority < b->priority || (a->priority == b->priority && a->node < b->node);
+}
+
+static void graph_queue__append(GraphQueueHeap *h, GraphQueueItem item) {
+    if (h->size == h->capacity) {
+        h->capacity = h->capacity > 0 ? 2 * h->capacity : 16;
+        h->items = (GraphQueueItem*) realloc(h->items, h->capacity * sizeof(GraphQueueItem));
+        check_alloc(h->items);
+    }
+    h->items[h->size++] = item;
+}
+
+static void graph_queue__heap_push(GraphQueueHeap *h, GraphQueueItem item) {
+    graph_queue__append(h, item);
+    size_t i = h->size - 1;
+    while (i > 0 && graph_queue__less(&item, &h->items[(i - 1) / 2])) {
+        h->items[i] = h->items[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->items[i] = item;
+}
+
+static GraphQueueItem graph_queue__heap_pop(GraphQueueHeap *h) {
+    GraphQueueItem top = h->items[0], last = h->items[--h->size];
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= h->size) {
+            break;
+        }
+        if (child + 1 < h->size && graph_queue__less(&h->items[child + 1], &h->items[child])) {
+            child++;
+        }
+        if (!graph_queue__less(&h->items[child], &last)) {
+            break;
+        }
+        h->items[i] = h->items[child];
+        i = child;
+    }
+    h->items[i] = last;
+    return top;
+}
+
+static inline int graph_queue__radix_bucket(unsigned last, unsigned key) {
+    return key == last ? 0 : 32 - __builtin_clz(key ^ last);
+}
+
+static void graph_queue__radix_pop_bucket(GraphQueue *q) {
+    int i = 1;
+    while (q->radix[i].size == 0) {
+        i++;
+    }
+    GraphQueueHeap *bucket = &q->radix[i];
+    unsigned last = (unsigned) bucket->items[0].priority;
+    for (size_t j = 1; j < bucket->size; j++) {
+        last = (unsigned) bucket->items[j].priority < last ? (unsigned) bucket->items[j].priority : last;
+    }
+    q->last = last;
+    for (size_t j = 0; j < bucket->size; j++) {
+        GraphQueueItem item = bucket->items[j];
+        graph_queue__append(&q->radix[graph_queue__radix_bucket(last, (unsigned) item.priority)], item);
+    }
+    bucket->size = 0;
+}
+
+GraphQueue* graph_queue_create(GraphQueueType type, int min_weight, int max_weight) {
+    GraphQueue *q = (GraphQueue*) calloc(1, sizeof(GraphQueue));
+    check_alloc(q);
+    if (type == GRAPH_QUEUE_AUTO) {
+        if (min_weight < 0) {
+            type = GRAPH_QUEUE_BINARY_HEAP;
+        } else if (max_weight <= GRAPH_QUEUE_DIAL_MAX_WEIGHT) {
+            type = GRAPH_QUEUE_DIAL;
+        } else {
+            type = GRAPH_QUEUE_RADIX_HEAP;
+        }
+    }
+    q->type = type;
+    if (type == GRAPH_QUEUE_DIAL) {
+        q->n_dial = (size_t) (max_weight > 0 ? max_weight : 0) + 1;
+        q->dial = (GraphQueueHeap*) calloc(q->n_dial, sizeof(GraphQueueHeap));
+        check_alloc(q->dial);
+    }
+    return q;
+}
+
+void graph_queue_push(GraphQueue *q, int priority, int node, int from) {
+    GraphQueueItem item = {priority, node, from};
+    switch (q->type) {
+    case GRAPH_QUEUE_RADIX_HEAP:
+        graph_queue__append(&q->radix[graph_queue__radix_bucket(q->last, (unsigned) priority)], item);
+        break;
+    case GRAPH_QUEUE_DIAL:
+        // the keys pushed are at most the largest weight past the current one
+        if (q->size == 0) {
+            q->current = priority;
+        }
+        graph_queue__append(&q->dial[(size_t) priority % q->n_dial], item);
+        break;
+    default:
+        graph_queue__heap_push(&q->heap, item);
+    }
+    q->size++;
+}
+
+GraphQueueItem graph_queue_pop(GraphQueue *q) {
+    q->size--;
+    switch (q->type) {
+    case GRAPH_QUEUE_RADIX_HEAP:
+        if (q->radix[0].size == 0) {
+            graph_queue__radix_pop_bucket(q);
+        }
+        return q->radix[0].items[--q->radix[0].size];
+    case GRAPH_QUEUE_DIAL: {
+        GraphQueueHeap *bucket = &q->dial[(size_t) q->current % q->n_dial];
+        while (bucket->size == 0) {
+            q->current++;
+            bucket = &q->dial[(size_t) q->current % q->n_dial];
+        }
+        return bucket->items[--bucket->size];
+    }
+    default:
+        return graph_queue__heap_pop(&q->heap);
+    }
+}
+
+bool graph_queue_empty(GraphQueue *q) {
+    return q->size == 0;
+}
+
+void graph_queue_free(GraphQueue *q) {
+    free(q->heap.items);
+    for (int i = 0; i < GRAPH_QUEUE_RADIX_BUCKETS; i++) {
+        free(q->radix[i].items);
+    }
+    for (size_t i = 0; i < q->n_dial; i++) {
+        free(q->dial[i].items);
+    }
+    free(q->dial);
+    free(q);
+}
@@ -0,0 +1,109 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef GRAPH_QUEUE_H
+#define GRAPH_QUEUE_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Largest edge weight for which the queue picked by
+ * graph_queue_create() keeps the nodes in Dial's buckets, one per distance
+ * up to the largest weight past the current one, instead of a radix heap.
+ */
+#ifndef GRAPH_QUEUE_DIAL_MAX_WEIGHT
+#define GRAPH_QUEUE_DIAL_MAX_WEIGHT 4096
+#endif
+
+/**
+ * @brief Kind of priority queue of the nodes of Dijkstra's algorithm
+ */
+typedef enum GraphQueueType {
+    GRAPH_QUEUE_AUTO,        /**< picked from the range of the weights */
+    GRAPH_QUEUE_BINARY_HEAP, /**< binary heap, for any weights */
+    GRAPH_QUEUE_RADIX_HEAP,  /**< monotone radix heap, for non-negative weights */
+    GRAPH_QUEUE_DIAL         /**< Dial's circular buckets, for small non-negative weights */
+} GraphQueueType;
+
+/**
+ * @brief A node of a GraphQueue, with the node it was reached from
+ */
+typedef struct GraphQueueItem {
+    int priority;
+    int node;
+    int from;
+} GraphQueueItem;
+
+/**
+ * @brief A priority queue of the nodes of a graph search.
+ *
+ * A node is pushed again instead of decreasing its priority, so the search
+ * skips the entries popped after a shorter one of the same node. The radix
+ * heap and Dial's buckets are monotone: no priority pushed may be smaller
+ * than the last one popped, which holds for the distances of Dijkstra's
+ * algorithm over non-negative weights. Dial's buckets also need the pushed
+ * priorities to be at most the largest weight past the last one popped.
+ */
+typedef struct GraphQueue GraphQueue;
+
+/**
+ * @brief Create an empty queue for the edges of weights in a range
+ *
+ * The range may be wider than the actual weights, as bounds kept while
+ * edges are removed: a smaller minimum only rules out the monotone queues,
+ * and a larger maximum adds Dial's buckets.
+ * @param type kind of the queue, or GRAPH_QUEUE_AUTO to pick a binary heap
+ * for negative weights, Dial's buckets up to GRAPH_QUEUE_DIAL_MAX_WEIGHT and
+ * a radix heap above
+ * @param min_weight no weight is smaller
+ * @param max_weight no weight is larger
+ * @return pointer to the newly created queue
+ * @ingroup DataStructureMethods
+ */
+GraphQueue* graph_queue_create(GraphQueueType type, int min_weight, int max_weight);
+
+/**
+ * @brief Push a node
+ * @param q queue pointer
+ * @param priority priority of the node, smaller first
+ * @param node node pushed
+ * @param from node it was reached from, or -1
+ * @ingroup DataStructureMethods
+ */
+void graph_queue_push(GraphQueue *q, int priority, int node, int from);
+
+/**
+ * @brief Pop a node of the smallest priority
+ *
+ * Ties are broken by the smallest node on a binary heap only.
+ * @param q queue pointer, not empty
+ * @return item popped
+ * @ingroup DataStructureMethods
+ */
+GraphQueueItem graph_queue_pop(GraphQueue *q);
+
+/**
+ * @brief Check if a queue is empty
+ * @param q queue pointer
+ * @return true if no item is left
+ * @ingroup DataStructureMethods
+ */
+bool graph_queue_empty(GraphQueue *q);
+
+/**
+ * @brief Free a queue and the items left in it
+ * @param q queue pointer
+ * @ingroup DataStructureMethods
+ */
+void graph_queue_free(GraphQueue *q);
+
+#endif /* GRAPH_QUEUE_H */
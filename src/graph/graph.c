@@ -1,15 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
 #include "graph.h"
 #include "../hash-table/hash-table-gen.h"
 
-#define GRAPH_DEFAULT_N_BUCKETS 128
+#define GRAPH_DEFAULT_N_BUCKETS 16
 
 struct Graph {
     HashTableGen *adj;
     bool directed; // true by default
     bool weighted; // false by default
     bool tarjan;   // false by default
+    int min_weight; // of the edges ever added, INT_MAX before the first one
+    int max_weight;
 };
 
 Graph* graph_create() {
@@ -21,6 +24,8 @@ Graph* graph_create() {
     g->directed = true;
     g->weighted = false;
     g->tarjan = false;
+    g->min_weight = INT_MAX;
+    g->max_weight = INT_MIN;
     if (!g->adj) {
         free(g);
         return NULL;
@@ -47,9 +52,28 @@ static void graph_nodes_iterator_free(Iterator *it) {
     free(it);
 }
 
+static int graph__compare_nodes(const void *a, const void *b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
 Iterator* graph_nodes_iterator(Graph *g) {
-    List *nodes = hash_table_gen_keys(g->adj);
-    list_sort(&nodes);
+    // sorted in an array: list_sort() inserts one node at a time
+    size_t n = hash_table_gen_size(g->adj);
+    int *sorted = (int*) malloc((n + 1) * sizeof(int));
+    check_alloc(sorted);
+    List *keys = hash_table_gen_keys(g->adj);
+    size_t i = 0;
+    for (List *l = keys; l != NULL; l = l->next) {
+        sorted[i++] = l->data;
+    }
+    list_free(keys);
+    qsort(sorted, n, sizeof(int), &graph__compare_nodes);
+    List *nodes = list_create();
+    while (i > 0) {
+        nodes = list_insert(nodes, sorted[--i]);
+    }
+    free(sorted);
     Iterator *iterator = list_iterator_data(nodes);
     iterator->free = &graph_nodes_iterator_free;
     return iterator;
@@ -61,16 +85,10 @@ List* graph_edges(Graph *g) {
     while (!iterator_done(nodes)) {
         int node = *(int*) iterator_next(nodes);
 
-        Set* neighbors = graph_get_neighbors(g, node);
-        Iterator* set_it = set_iterator(neighbors);
-
-        while (!iterator_done(set_it)) {
-            int neighbor = *(int*) iterator_next(set_it);
-
-            edges = list_insert_with_key(edges, node, neighbor);
+        GraphNeighbors neighbors = graph_neighbors_begin(g, node);
+        while (graph_neighbors_next(&neighbors)) {
+            edges = list_insert_with_key(edges, node, neighbors.node);
         }
-        set_free(neighbors);
-        iterator_free(set_it);
     }
     iterator_free(nodes);
     return edges;
@@ -81,9 +99,8 @@ int graph_edges_count(Graph *g) {
     int n_edges = 0;
     while (!iterator_done(nodes)) {
         int node = *(int*) iterator_next(nodes);
-        Set* neighbors = graph_get_neighbors(g, node);
+        Set* neighbors = (Set*) hash_table_gen_get(g->adj, node, NULL);
         n_edges += set_size(neighbors);
-        set_free(neighbors);
     }
     iterator_free(nodes);
     return n_edges;
@@ -184,11 +201,24 @@ bool graph_is_weighted(Graph *g) {
     return g->weighted;
 }
 
+int graph_min_edge_weight(Graph *g) {
+    return g->min_weight <= g->max_weight ? g->min_weight : 0;
+}
+
+int graph_max_edge_weight(Graph *g) {
+    return g->min_weight <= g->max_weight ? g->max_weight : 0;
+}
+
+static void graph__weight_added(Graph *g, int weight) {
+    g->min_weight = weight < g->min_weight ? weight : g->min_weight;
+    g->max_weight = weight > g->max_weight ? weight : g->max_weight;
+}
+
 void graph_add_node(Graph *g, int node) {
     bool exists;
     hash_table_gen_get(g->adj, node, &exists);
     if (!exists) {
-        Set *s = set_create();
+        Set *s = set_create_with_type(GRAPH_ADJACENCY_TYPE);
         hash_table_gen_put(g->adj, node, s);
     }
 }
@@ -199,6 +229,7 @@ void graph_add_edge_with_weight(Graph *g, int u, int v, int weight) {
     Set *set_u = (Set*) hash_table_gen_get(g->adj, u, NULL);
     set_add_with_value(set_u, v, weight);
     g->weighted = true;
+    graph__weight_added(g, weight);
 
     if (!g->directed) {
         Set *set_v = (Set*) hash_table_gen_get(g->adj, v, NULL);
@@ -211,6 +242,7 @@ void graph_add_edge(Graph *g, int u, int v) {
     graph_add_node(g, v);
     Set *set_u = (Set*) hash_table_gen_get(g->adj, u, NULL);
     set_add(set_u, v);
+    graph__weight_added(g, set_get_value(set_u, v));
 
     if (!g->directed) {
         Set *set_v = (Set*) hash_table_gen_get(g->adj, v, NULL);
@@ -278,6 +310,33 @@ Set* graph_get_neighbors(Graph *g, int node) {
     return set_copy(neighbors);
 }
 
+GraphNeighbors graph_neighbors_begin(Graph *g, int node) {
+    GraphNeighbors it;
+    Set *neighbors = (Set*) hash_table_gen_get(g->adj, node, &it.exists);
+    if (it.exists) {
+        it.cursor = set_cursor(neighbors);
+    }
+    it.node = 0;
+    it.weight = 0;
+    return it;
+}
+
+bool graph_neighbors_next(GraphNeighbors *it) {
+    if (!it->exists || !set_cursor_next(&it->cursor)) {
+        return false;
+    }
+    it->node = it->cursor.key;
+    it->weight = it->cursor.value;
+    return true;
+}
+
+void graph_for_each_neighbor(Graph *g, int node, void (*visit)(int v, int weight, void *context), void *context) {
+    GraphNeighbors it = graph_neighbors_begin(g, node);
+    while (graph_neighbors_next(&it)) {
+        visit(it.node, it.weight, context);
+    }
+}
+
 int graph_get_edge_weight(Graph *g, int u, int v) {
     bool exists;
     Set *set_u = (Set*) hash_table_gen_get(g->adj, u, &exists);
@@ -346,23 +405,19 @@ void graph_export_to_dot(Graph *g, const char* filename) {
     current_node = nodes;
     while (current_node) {
         int u = (int)(long)current_node->data;
-        Set *neighbors = (Set*) hash_table_gen_get(g->adj, u, NULL);
-        Iterator *it = set_iterator(neighbors);
-        while (!iterator_done(it)) {
-            int v = *(int*)iterator_next(it);
+        GraphNeighbors neighbors = graph_neighbors_begin(g, u);
+        while (graph_neighbors_next(&neighbors)) {
+            int v = neighbors.node;
             if (g->directed || u < v) { // Avoid duplicate edges in undirected graphs
                 fprintf(fp, "    %d %s %d", u, g->directed ? "->" : "--", v);
                 if (g->tarjan) {
-                    int edge_type = set_get_value(neighbors, v);
-                    fprintf(fp, " [label=\"%s\"]", graph_edge_type_name((EdgeType)edge_type));
+                    fprintf(fp, " [label=\"%s\"]", graph_edge_type_name((EdgeType)neighbors.weight));
                 } else if (g->weighted) {
-                    int weight = set_get_value(neighbors, v);
-                    fprintf(fp, " [label=\"%d\"]", weight);
+                    fprintf(fp, " [label=\"%d\"]", neighbors.weight);
                 }
                 fprintf(fp, ";\n");
             }
         }
-        iterator_free(it);
         current_node = current_node->next;
     }
     list_free(nodes);
@@ -16,6 +16,24 @@
 #include <stdbool.h>
 #include "../set/set.h"
 
+/**
+ * @brief Representation of the set of neighbors of each node, see SetType.
+ *
+ * Small sets by default: most nodes of a sparse graph have a few neighbors,
+ * held in the set itself instead of a hash table of their own.
+ */
+#ifndef GRAPH_ADJACENCY_TYPE
+#define GRAPH_ADJACENCY_TYPE SET_SMALL
+#endif
+
+/**
+ * @brief Edges under which graph algorithms taking a ThreadPool run on the
+ * calling thread alone.
+ */
+#ifndef GRAPH_PARALLEL_MIN_EDGES
+#define GRAPH_PARALLEL_MIN_EDGES 65536
+#endif
+
 typedef struct Graph Graph;
 
 typedef enum edgeType {
@@ -79,6 +97,24 @@ bool graph_is_directed(Graph *g);
  */
 bool graph_is_weighted(Graph *g);
 
+/**
+ * @brief Get a lower bound of the weights of the edges.
+ *
+ * The smallest weight of the edges ever added, the removed ones included.
+ * @return the bound, 0 if no edge was added.
+ * @ingroup DataStructureMethods
+ */
+int graph_min_edge_weight(Graph *g);
+
+/**
+ * @brief Get an upper bound of the weights of the edges.
+ *
+ * The largest weight of the edges ever added, the removed ones included.
+ * @return the bound, 0 if no edge was added.
+ * @ingroup DataStructureMethods
+ */
+int graph_max_edge_weight(Graph *g);
+
 /**
  * @brief Adds a node to the graph.
  * @param g The graph.
@@ -163,6 +199,53 @@ bool graph_has_node(Graph *g, int u);
  */
 Set* graph_get_neighbors(Graph *g, int node);
 
+/**
+ * @brief A walk over the neighbors of a node, in the adjacency set of the
+ * graph itself: no copy is made and nothing is allocated.
+ *
+ * The edges of the node must not be changed during the walk.
+ */
+typedef struct GraphNeighbors {
+    SetCursor cursor;
+    bool exists;    /**< false for a node not in the graph, with no neighbors */
+    int node;       /**< current neighbor */
+    int weight;     /**< weight of the edge to the current neighbor */
+} GraphNeighbors;
+
+/**
+ * @brief Start a walk over the neighbors of a node.
+ *
+ * The neighbors come in the order of graph_get_neighbors():
+ *
+ *     GraphNeighbors it = graph_neighbors_begin(g, u);
+ *     while (graph_neighbors_next(&it)) {
+ *         visit(it.node, it.weight);
+ *     }
+ * @param g The graph.
+ * @param node The node.
+ * @return a walk placed before the first neighbor
+ * @ingroup DataStructureMethods
+ */
+GraphNeighbors graph_neighbors_begin(Graph *g, int node);
+
+/**
+ * @brief Move to the next neighbor.
+ * @param it walk pointer, its node and weight are set to the new neighbor
+ * @return false when there are no more neighbors, true otherwise
+ * @ingroup DataStructureMethods
+ */
+bool graph_neighbors_next(GraphNeighbors *it);
+
+/**
+ * @brief Call a function on each neighbor of a node, with no copy.
+ * @param g The graph.
+ * @param node The node.
+ * @param visit called with each neighbor, the weight of its edge and the context
+ * @param context passed to visit
+ * @ingroup DataStructureMethods
+ */
+void graph_for_each_neighbor(Graph *g, int node, void (*visit)(int v, int weight, void *context), void *context);
+
 /**
  * @brief Frees the memory allocated for the graph.
  * @param g The graph.
@@ -270,6 +353,86 @@ Graph* graph_tarjan(Graph *g);
  */
 int* graph_strong_components(Graph *g);
 
+/**
+ * @brief Label the connected components of the graph with a union-find.
+ *
+ * Edges are followed both ways, so the components of a directed graph are
+ * its weakly connected ones.
+ * @param g The graph to traverse, of non-negative node ids.
+ * @return array indexed by node id up to graph_max_node_id(): the smallest
+ * node of the component of each node, -1 for the ids not in the graph.
+ * NULL if some node id is negative.
+ * @ingroup DataStructureMethods
+ */
+int* graph_connected_components(Graph *g);
+
+/**
+ * @brief Label the connected components of the graph on a thread pool.
+ *
+ * The Afforest algorithm: the first neighbors of every node are linked in a
+ * concurrent union-find, the largest component is found by sampling, and
+ * the remaining edges are linked for the nodes out of it only, as the
+ * edges of an undirected graph are seen from both ends. Graphs of less than
+ * GRAPH_PARALLEL_MIN_EDGES edges are labelled as by graph_connected_components().
+ * The graph must not be modified meanwhile.
+ * @param g The graph to traverse, of non-negative node ids.
+ * @param pool threads to run on
+ * @return the same labels as graph_connected_components()
+ * @see Sutton et al., Optimizing parallel graph connectivity computation via subgraph sampling, 2018
+ * @ingroup DataStructureMethods
+ */
+int* graph_connected_components_parallel(Graph *g, ThreadPool *pool);
+
+/**
+ * @brief Breadth-first search of the nodes reachable from a source, level by
+ * level on a thread pool.
+ *
+ * The graph is frozen to its CSR form, see graph_freeze(). Each level is
+ * found top-down, from the edges out of the frontier, or bottom-up, by the
+ * nodes not visited yet looking for a neighbor in the frontier, whichever
+ * looks at fewer edges: the frontiers of the bottom-up steps are bitmaps.
+ * Directed graphs are searched top-down only, as the neighbors of a node
+ * are not its predecessors. Graphs of less than GRAPH_PARALLEL_MIN_EDGES
+ * edges are searched on the calling thread.
+ * @param g The graph to traverse, of non-negative node ids, else the
+ * arrays are left untouched.
+ * @param source The node to start from.
+ * @param depth array of graph_max_node_id() + 1 entries, set to the number
+ * of edges from the source to each node, -1 for the nodes not reached.
+ * @param parent array of as many entries, set to the node each node was
+ * reached from, -1 for the source and the nodes not reached. Any of the
+ * nodes of the previous level may be the parent of a node.
+ * @param pool threads to run on
+ * @see Beamer et al., Direction-optimizing breadth-first search, 2012
+ * @ingroup DataStructureMethods
+ */
+void graph_bfs_levels(Graph *g, int source, int *depth, int *parent, ThreadPool *pool);
+
+/**
+ * @brief Shortest paths from a source by delta-stepping, on a thread pool.
+ *
+ * The graph is frozen to its CSR form, see graph_freeze(). Nodes are kept
+ * in buckets of distances delta wide, taken in order: the light edges, of
+ * weight up to delta, out of the nodes of a bucket are relaxed in parallel
+ * until it is empty, then the heavy ones out of the nodes it settled. A
+ * delta of 1 behaves as Dijkstra's algorithm, a large one as Bellman-Ford.
+ * Graphs of less than GRAPH_PARALLEL_MIN_EDGES edges are searched on the
+ * calling thread.
+ * @param g The graph, of non-negative weights and node ids, else the arrays
+ * are left untouched.
+ * @param source The source node.
+ * @param delta width of the buckets, 0 or less to pick it from the graph:
+ * its largest weight over its average degree.
+ * @param dist array of graph_max_node_id() + 1 entries, set to the distance
+ * of each node from the source, INT_MAX if unreachable, as by graph_dijkstra().
+ * @param parent array of as many entries, set to the previous node of a
+ * shortest path to each node, -1 for the source and the unreachable nodes.
+ * @param pool threads to run on
+ * @see Meyer and Sanders, Delta-stepping: a parallelizable shortest path algorithm, 2003
+ * @ingroup DataStructureMethods
+ */
+void graph_sssp_delta_stepping(Graph *g, int source, int delta, int *dist, int *parent, ThreadPool *pool);
+
 /**
  * This method is defined in acyclical.c because it inherits part of the acyclical code.
  *
@@ -282,6 +445,9 @@ List* graph_topological_sort(Graph *g);
 
 /**
  * @brief Run dijkstra algorithm on the graph.
+ *
+ * The queue of the nodes is picked from the bounds of the weights, see
+ * graph_queue_create().
  * @param g The graph to traverse.
  * @param source The source node to start.
  * @return a new graph with the shortest path tree.
@@ -11,9 +11,8 @@ Graph* graph_kruskal(Graph *g) {
         List *edge = (List*) iterator_next(it);
         int u = edge->key;
         int v = edge->data;
-        if (set_disjoint_find(components, u) != set_disjoint_find(components, v)) {
+        if (set_disjoint_union(components, u, v)) {
             graph_add_edge_with_weight(g_kruskal, u, v, graph_get_edge_weight(g, u, v));
-            set_disjoint_union(components, u, v);
         }
     }
 
@@ -3,18 +3,13 @@
 #include "../pqueue/pqueue.h"
 
 void update_heap(Graph* g, PQueue* pq, Set* visited, int start) {
-    Set* neighbors = graph_get_neighbors(g, start);
-    Iterator *it = set_iterator_items(neighbors);
-    while (!iterator_done(it)) {
-        List *neighbor_weight = (List*) iterator_next(it);
-        if (!set_contains(visited, neighbor_weight->key)) {
-            int k = pair_hash(start, neighbor_weight->key);
-            int w = neighbor_weight->data;
-            pqueue_insert(pq, k, w);
+    GraphNeighbors neighbors = graph_neighbors_begin(g, start);
+    while (graph_neighbors_next(&neighbors)) {
+        if (!set_contains(visited, neighbors.node)) {
+            int k = pair_hash(start, neighbors.node);
+            pqueue_insert(pq, k, neighbors.weight);
         }
     }
-    set_free(neighbors);
-    iterator_free(it);
 }
 
 // WARNING: this implementation only return the Minimum Spanning Tree
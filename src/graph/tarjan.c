@@ -53,11 +53,9 @@ static void graph_dfst(
     tc->exploration[node] = ++tc->counter_exploration;
     tc->components[node] = tc->exploration[node];
     stack_push(tc->path, node);
-    Set* neighbors_set = graph_get_neighbors(g, node);
-    Iterator* set_it = set_iterator(neighbors_set);
-
-    while (!iterator_done(set_it)) {
-        int neighbor = *(int*) iterator_next(set_it);
+    GraphNeighbors neighbors = graph_neighbors_begin(g, node);
+    while (graph_neighbors_next(&neighbors)) {
+        int neighbor = neighbors.node;
         EdgeType edge_type = tarjan_classify_edge(tc, node, neighbor);
         if (!graph_has_edge(tc->g_tarjan, node, neighbor)) {
             graph_add_edge_with_weight(tc->g_tarjan, node, neighbor, edge_type);
@@ -74,8 +72,6 @@ static void graph_dfst(
     if (tc->components[node] == tc->exploration[node]) {
         while (stack_pop(tc->path) != node);
     }
-    set_free(neighbors_set);
-    iterator_free(set_it);
 
     tc->complete[node] = ++tc->counter_complete;
 }
@@ -1,9 +1,12 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <unistd.h>
+#include <limits.h>
 #include <linux/limits.h>
 #include <string.h>
 #include "graph.h"
+#include "graph-csr.h"
 
 void test_bfs() {
     printf("\n--- Testing BFS ---\n");
@@ -66,6 +69,7 @@ void test_dfs() {
     iterator_free(it);
     printf("DFS Path: ");
     list_println(path);
+    // siblings (4, 5) are pushed in increasing order, so 5 is visited first
     List *path_expected = list_init(6, 6, 1, 3, 2, 5, 4);
     printf("DFS Expected: ");
     list_println(path_expected);
@@ -113,6 +117,43 @@ void test_graph_directed() {
     graph_free(g);
 }
 
+static void sum_weights(int v, int weight, void *context) {
+    (void) v;
+    *(int*) context += weight;
+}
+
+void test_graph_neighbors() {
+    puts("== Graph neighbors walk");
+    Graph *g = graph_create();
+    for (int v = 0; v < 20; v++) {
+        graph_add_edge_with_weight(g, 1, v * 7, v);
+    }
+    graph_add_node(g, 2);
+
+    // the elements of graph_get_neighbors(), in the same order
+    Set *copy = graph_get_neighbors(g, 1);
+    SetCursor cursor = set_cursor(copy);
+    GraphNeighbors neighbors = graph_neighbors_begin(g, 1);
+    while (set_cursor_next(&cursor)) {
+        assert(graph_neighbors_next(&neighbors));
+        assert(neighbors.node == cursor.key);
+        assert(neighbors.weight == cursor.value);
+        assert(neighbors.weight == neighbors.node / 7);
+    }
+    assert(!graph_neighbors_next(&neighbors));
+    set_free(copy);
+
+    neighbors = graph_neighbors_begin(g, 2);
+    assert(!graph_neighbors_next(&neighbors));
+    neighbors = graph_neighbors_begin(g, 3);
+    assert(!graph_neighbors_next(&neighbors));
+
+    int sum = 0;
+    graph_for_each_neighbor(g, 1, &sum_weights, &sum);
+    assert(sum == 19 * 20 / 2);
+    graph_free(g);
+}
+
 void test_graph_undirected() {
     puts("== Graph undirected tests");
     Graph *g = graph_undirected_create();
@@ -261,6 +302,268 @@ void test_graph_strong_components() {
     graph_free(g);
 }
 
+void test_graph_connected_components() {
+    puts("== Graph connected components");
+    Graph *g = graph_undirected_create();
+    graph_add_edge(g, 5, 1);
+    graph_add_edge(g, 1, 3);
+    graph_add_edge(g, 7, 8);
+    graph_add_node(g, 6);
+
+    int *components = graph_connected_components(g);
+    int expected[] = {-1, 1, -1, 1, -1, 1, 6, 7, 7};
+    assert(graph_max_node_id(g) == 8);
+    for (int u = 0; u <= 8; u++) {
+        assert(components[u] == expected[u]);
+    }
+    free(components);
+    graph_free(g);
+
+    // weakly connected components of a directed graph
+    g = graph_create();
+    graph_add_edge(g, 3, 0);
+    graph_add_edge(g, 2, 0);
+    graph_add_edge(g, 4, 5);
+    components = graph_connected_components(g);
+    assert(components[2] == 0 && components[3] == 0 && components[5] == 4);
+    free(components);
+    graph_free(g);
+
+    // random graphs large enough to run in parallel, the same labels
+    ThreadPool *pool = thread_pool_create(4);
+    srand(42);
+    for (int directed = 0; directed < 2; directed++) {
+        int n = 50000;
+        g = directed ? graph_create() : graph_undirected_create();
+        for (int e = 0; e < 40000; e++) {
+            graph_add_edge(g, rand() % n, rand() % n);
+        }
+        for (int e = 0; e < 40000; e++) {
+            int u = rand() % (n / 10);
+            graph_add_edge(g, u, u + 1);
+        }
+        int *sequential = graph_connected_components(g);
+        int *parallel = graph_connected_components_parallel(g, pool);
+        int n_components = 0, max_node_id = graph_max_node_id(g);
+        for (int u = 0; u <= max_node_id; u++) {
+            assert(sequential[u] == parallel[u]);
+            n_components += sequential[u] == u;
+        }
+        printf("%s graph of %zu nodes: %d components\n", directed ? "directed" : "undirected",
+               graph_size(g), n_components);
+        free(sequential);
+        free(parallel);
+        graph_free(g);
+    }
+    thread_pool_free(pool);
+}
+
+// random weighted graph, with some nodes left out of the ids
+static Graph* random_graph(bool directed, int n, int n_edges) {
+    Graph *g = directed ? graph_create() : graph_undirected_create();
+    for (int u = 0; u < n; u += 3) {
+        graph_add_node(g, u);
+    }
+    for (int e = 0; e < n_edges; e++) {
+        graph_add_edge_with_weight(g, rand() % n, rand() % n, 1 + rand() % 100);
+    }
+    return g;
+}
+
+static void assert_same_iterator(Iterator *expected, Iterator *it) {
+    while (!iterator_done(expected)) {
+        assert(!iterator_done(it));
+        int u = *(int*) iterator_next(expected);
+        int v = *(int*) iterator_next(it);
+        assert(u == v);
+    }
+    assert(iterator_done(it));
+    iterator_free(expected);
+    iterator_free(it);
+}
+
+// depths of a plain breadth-first search, to check the other ones
+static int* bfs_depths(Graph *g, int source) {
+    int n = graph_max_node_id(g) + 1;
+    int *depth = (int*) malloc(n * sizeof(int));
+    int *queue = (int*) malloc(n * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        depth[u] = -1;
+    }
+    int head = 0, tail = 0;
+    depth[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int u = queue[head++];
+        GraphNeighbors neighbors = graph_neighbors_begin(g, u);
+        while (graph_neighbors_next(&neighbors)) {
+            if (depth[neighbors.node] < 0) {
+                depth[neighbors.node] = depth[u] + 1;
+                queue[tail++] = neighbors.node;
+            }
+        }
+    }
+    free(queue);
+    return depth;
+}
+
+void test_graph_bfs_levels() {
+    puts("== Graph BFS levels");
+    ThreadPool *pool = thread_pool_create(4);
+    Graph *g = graph_create();
+    graph_add_edge(g, 1, 2);
+    graph_add_edge(g, 1, 3);
+    graph_add_edge(g, 3, 4);
+    graph_add_edge(g, 4, 1);
+    graph_add_edge(g, 5, 4);
+    int depth[6], parent[6];
+    graph_bfs_levels(g, 1, depth, parent, pool);
+    int expected_depth[] = {-1, 0, 1, 1, 2, -1};
+    int expected_parent[] = {-1, -1, 1, 1, 3, -1};
+    for (int u = 0; u < 6; u++) {
+        assert(depth[u] == expected_depth[u]);
+        assert(parent[u] == expected_parent[u]);
+    }
+    graph_free(g);
+
+    // random graphs large enough to run in parallel and go bottom-up
+    srand(11);
+    for (int directed = 0; directed < 2; directed++) {
+        int n = 50000;
+        g = directed ? graph_create() : graph_undirected_create();
+        for (int e = 0; e < 300000; e++) {
+            graph_add_edge(g, rand() % n, rand() % n);
+        }
+        int source = rand() % n, max_node_id = graph_max_node_id(g), reached = 0;
+        int *expected = bfs_depths(g, source);
+        int *levels = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *parents = (int*) malloc((max_node_id + 1) * sizeof(int));
+        graph_bfs_levels(g, source, levels, parents, pool);
+        for (int u = 0; u <= max_node_id; u++) {
+            assert(levels[u] == expected[u]);
+            if (u != source && levels[u] > 0) {
+                assert(levels[parents[u]] == levels[u] - 1);
+                assert(graph_has_edge(g, parents[u], u));
+            } else {
+                assert(parents[u] == -1);
+            }
+            reached += levels[u] >= 0;
+        }
+        printf("%s graph of %zu nodes: %d reached from %d\n", directed ? "directed" : "undirected",
+               graph_size(g), reached, source);
+        free(expected);
+        free(levels);
+        free(parents);
+        graph_free(g);
+    }
+    thread_pool_free(pool);
+}
+
+void test_graph_csr() {
+    puts("== Graph CSR");
+    Graph *g = graph_undirected_create();
+    graph_add_edge_with_weight(g, 1, 2, 10);
+    graph_add_edge_with_weight(g, 4, 1, 9);
+    graph_add_node(g, 6);
+    GraphCSR *csr = graph_freeze(g);
+    assert(graph_csr_size(csr) == 4);
+    assert(graph_csr_edges_count(csr) == 4);
+    assert(graph_csr_max_node_id(csr) == 6);
+    assert(!graph_csr_is_directed(csr));
+    assert(graph_csr_has_node(csr, 6) && !graph_csr_has_node(csr, 3) && !graph_csr_has_node(csr, 7));
+    assert(graph_csr_degree(csr, 1) == 2 && graph_csr_degree(csr, 6) == 0);
+    const size_t *offsets = graph_csr_offsets(csr);
+    const int *targets = graph_csr_targets(csr), *weights = graph_csr_weights(csr);
+    for (size_t e = offsets[1]; e < offsets[2]; e++) {
+        assert(weights[e] == graph_get_edge_weight(g, 1, targets[e]));
+    }
+    graph_csr_free(csr);
+    graph_free(g);
+
+    // negative ids have no index in the arrays, Dijkstra walks the graph
+    g = graph_create();
+    graph_add_edge_with_weight(g, -3, 2, 4);
+    graph_add_edge_with_weight(g, 2, -1, 1);
+    graph_add_edge_with_weight(g, -3, -1, 7);
+    assert(graph_freeze(g) == NULL);
+    assert(graph_connected_components(g) == NULL);
+    assert(graph_minimum_distance(g, -3, -1) == 5);
+    graph_free(g);
+
+    // the algorithms of the CSR form against the ones of the graph
+    srand(7);
+    for (int directed = 0; directed < 2; directed++) {
+        int n = 300;
+        g = random_graph(directed, n, 600);
+        csr = graph_freeze(g);
+        int max_node_id = graph_max_node_id(g);
+        assert(graph_csr_max_node_id(csr) == max_node_id);
+        assert(graph_csr_size(csr) == graph_size(g));
+
+        for (int start = 0; start < 10; start++) {
+            assert_same_iterator(graph_bfs(g, start), graph_csr_bfs(csr, start));
+            assert_same_iterator(graph_dfs(g, start), graph_csr_dfs(csr, start));
+        }
+
+        int *dist = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *parent = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *expected = (int*) malloc((max_node_id + 1) * sizeof(int));
+        graph_csr_dijkstra(csr, 0, dist, parent);
+        Graph *g_dijkstra = graph_dijkstra(g, 0);
+        for (int u = 0; u <= max_node_id; u++) {
+            expected[u] = u == 0 ? 0 : INT_MAX;
+        }
+        Iterator *it = graph_nodes_iterator(g_dijkstra);
+        while (!iterator_done(it)) {
+            int u = *(int*) iterator_next(it);
+            GraphNeighbors neighbors = graph_neighbors_begin(g_dijkstra, u);
+            while (graph_neighbors_next(&neighbors)) {
+                expected[neighbors.node] = neighbors.weight;
+            }
+        }
+        iterator_free(it);
+        for (int u = 0; u <= max_node_id; u++) {
+            assert(dist[u] == expected[u]);
+            assert(parent[u] < 0 || dist[u] == dist[parent[u]] + graph_get_edge_weight(g, parent[u], u));
+        }
+        graph_free(g_dijkstra);
+
+        if (!directed) {
+            Graph *g_prim = graph_prim(g, 0);
+            assert(graph_csr_prim(csr, 0, parent) == graph_edges_sum(g_prim));
+            graph_free(g_prim);
+        }
+
+        Graph *g_tarjan = graph_tarjan(g);
+        EdgeType *types = graph_csr_tarjan(csr);
+        offsets = graph_csr_offsets(csr);
+        targets = graph_csr_targets(csr);
+        for (int u = 0; u <= max_node_id; u++) {
+            for (size_t e = offsets[u]; e < offsets[u + 1]; e++) {
+                assert((int) types[e] == graph_get_edge_weight(g_tarjan, u, targets[e]));
+            }
+        }
+        free(types);
+        graph_free(g_tarjan);
+
+        int *components = graph_strong_components(g);
+        int *csr_components = graph_csr_strong_components(csr);
+        for (int u = 0; u <= max_node_id; u++) {
+            assert(components[u] == csr_components[u]);
+        }
+        free(components);
+        free(csr_components);
+
+        printf("%s graph of %zu nodes and %zu edges: same results\n",
+               directed ? "directed" : "undirected", graph_csr_size(csr), graph_csr_edges_count(csr));
+        free(dist);
+        free(parent);
+        free(expected);
+        graph_csr_free(csr);
+        graph_free(g);
+    }
+}
+
 void test_graph_export() {
     char cwd[PATH_MAX];
     getcwd(cwd, sizeof(cwd));
@@ -389,6 +692,120 @@ void test_graph_dijkstra(bool extra_tests) {
     graph_free(dijkstra_result);
 }
 
+void test_graph_dijkstra_queues() {
+    puts("== Graph Dijkstra queues");
+    srand(5);
+    int max_weights[] = {0, 1, 10, 1000, 1 << 20};
+    for (int i = 0; i < 5; i++) {
+        int n = 5000;
+        Graph *g = graph_create();
+        for (int e = 0; e < 20000; e++) {
+            graph_add_edge_with_weight(g, rand() % n, rand() % n, rand() % (max_weights[i] + 1));
+        }
+        GraphCSR *csr = graph_freeze(g);
+        assert(graph_csr_min_weight(csr) >= 0 && graph_csr_max_weight(csr) <= max_weights[i]);
+        int max_node_id = graph_csr_max_node_id(csr);
+        int *expected = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *dist = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *parent = (int*) malloc((max_node_id + 1) * sizeof(int));
+        graph_csr_dijkstra_with_queue(csr, 0, expected, parent, GRAPH_QUEUE_BINARY_HEAP);
+        for (int queue = GRAPH_QUEUE_AUTO; queue <= GRAPH_QUEUE_DIAL; queue++) {
+            graph_csr_dijkstra_with_queue(csr, 0, dist, parent, (GraphQueueType) queue);
+            for (int u = 0; u <= max_node_id; u++) {
+                assert(dist[u] == expected[u]);
+                assert(parent[u] < 0 || dist[u] == dist[parent[u]] + graph_get_edge_weight(g, parent[u], u));
+            }
+        }
+
+        // the graph picks the same queue from the bounds it keeps of the weights
+        assert(graph_min_edge_weight(g) == graph_csr_min_weight(csr));
+        assert(graph_max_edge_weight(g) == graph_csr_max_weight(csr));
+        Graph *tree = graph_dijkstra(g, 0);
+        int reached = 0;
+        for (int u = 1; u <= max_node_id; u++) {
+            reached += expected[u] != INT_MAX;
+        }
+        List *edges = graph_edges(tree);
+        for (List *edge = edges; edge != NULL; edge = edge->next) {
+            assert(graph_get_edge_weight(tree, edge->key, edge->data) == expected[edge->data]);
+            reached--;
+        }
+        assert(reached == 0);
+        list_free(edges);
+        graph_free(tree);
+        printf("weights up to %d: the same distances on every queue\n", max_weights[i]);
+        free(expected);
+        free(dist);
+        free(parent);
+        graph_csr_free(csr);
+        graph_free(g);
+    }
+}
+
+void test_graph_sssp_delta_stepping() {
+    puts("== Graph delta-stepping shortest paths");
+    ThreadPool *pool = thread_pool_create(4);
+    Graph *g = graph_create();
+    graph_add_edge_with_weight(g, 1, 2, 7);
+    graph_add_edge_with_weight(g, 1, 3, 9);
+    graph_add_edge_with_weight(g, 1, 6, 14);
+    graph_add_edge_with_weight(g, 2, 3, 10);
+    graph_add_edge_with_weight(g, 2, 4, 15);
+    graph_add_edge_with_weight(g, 3, 4, 11);
+    graph_add_edge_with_weight(g, 3, 6, 2);
+    graph_add_edge_with_weight(g, 4, 5, 6);
+    graph_add_edge_with_weight(g, 5, 6, 9);
+    int dist[7], parent[7];
+    // the distances of the edges of the tree of graph_dijkstra()
+    Graph *g_dijkstra = graph_dijkstra(g, 1);
+    for (int delta = 0; delta <= 20; delta += 5) {
+        graph_sssp_delta_stepping(g, 1, delta, dist, parent, pool);
+        assert(dist[0] == INT_MAX && parent[0] == -1);
+        assert(dist[1] == 0 && parent[1] == -1);
+        for (int u = 2; u <= 6; u++) {
+            assert(dist[u] == graph_get_edge_weight(g_dijkstra, parent[u], u));
+        }
+    }
+    graph_free(g_dijkstra);
+    graph_free(g);
+
+    // random graphs large enough to run in parallel, with far buckets
+    srand(23);
+    for (int directed = 0; directed < 2; directed++) {
+        int n = 20000;
+        g = directed ? graph_create() : graph_undirected_create();
+        for (int e = 0; e < 100000; e++) {
+            graph_add_edge_with_weight(g, rand() % n, rand() % n, rand() % 1000);
+        }
+        GraphCSR *csr = graph_freeze(g);
+        int max_node_id = graph_csr_max_node_id(csr);
+        int *expected = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *distances = (int*) malloc((max_node_id + 1) * sizeof(int));
+        int *parents = (int*) malloc((max_node_id + 1) * sizeof(int));
+        graph_csr_dijkstra(csr, 0, expected, parents);
+        int deltas[] = {0, 1, 50, 100000};
+        for (int i = 0; i < 4; i++) {
+            graph_csr_sssp_delta_stepping(csr, 0, deltas[i], distances, parents, pool);
+            for (int u = 0; u <= max_node_id; u++) {
+                assert(distances[u] == expected[u]);
+                if (parents[u] >= 0) {
+                    assert(distances[u] == distances[parents[u]] + graph_get_edge_weight(g, parents[u], u));
+                } else {
+                    assert(u == 0 || distances[u] == INT_MAX);
+                }
+            }
+        }
+        printf("%s graph of %zu nodes: same distances as Dijkstra\n", directed ? "directed" : "undirected",
+               graph_size(g));
+        free(expected);
+        free(distances);
+        free(parents);
+        graph_csr_free(csr);
+        graph_free(g);
+    }
+    thread_pool_free(pool);
+}
+
 void test_graph_kruskal(bool extra_tests) {
     char cwd[PATH_MAX];
     getcwd(cwd, sizeof(cwd));
@@ -471,13 +888,19 @@ int main(int argc, char *argv[]) {
     int extra_tests = should_run_extra_tests(argc, argv);
     test_graph_directed();
     test_graph_undirected();
+    test_graph_neighbors();
     test_bfs();
     test_dfs();
     test_graph_acyclical();
     test_graph_tarjan();
     test_graph_strong_components();
+    test_graph_connected_components();
+    test_graph_csr();
+    test_graph_bfs_levels();
     test_graph_topological_sort();
     test_graph_dijkstra(extra_tests);
+    test_graph_dijkstra_queues();
+    test_graph_sssp_delta_stepping();
     test_graph_edges_ordered();
     test_graph_kruskal(extra_tests);
     test_graph_prim(extra_tests);
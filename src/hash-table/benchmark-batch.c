@@ -0,0 +1,104 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Batched lookups and inserts (hash_table_get_many, hash_table_put_many)
+ * against the one at a time loop, for tables that fit or not in the cache.
+ * Lookups are random keys, half of them present. set_contains_many() is
+ * hash_table_get_many() over the set memory, so it gets the same speedup.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hash-table.h"
+
+#define N_LOOKUPS (1 << 22)
+#define SIZES 3
+
+static const int sizes[SIZES] = {1 << 12, 1 << 18, 1 << 22};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void benchmark_size(HashTableType type, int size, const int *lookups, int *values, bool *exists) {
+    int *keys = (int*) malloc(size * sizeof(int));
+    for (int i = 0; i < size; i++) {
+        keys[i] = 2 * i; // even keys: half of the lookups miss
+    }
+
+    double start = now_seconds();
+    HashTable *single = hash_table_create_with_type(1, type);
+    for (int i = 0; i < size; i++) {
+        hash_table_put(single, keys[i], i);
+    }
+    double put_single = now_seconds() - start;
+
+    start = now_seconds();
+    HashTable *batch = hash_table_create_with_type(1, type);
+    hash_table_put_many(batch, keys, keys, size);
+    double put_batch = now_seconds() - start;
+
+    long checksum = 0;
+    start = now_seconds();
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        checksum += hash_table_get(single, lookups[i], &exists[i]);
+    }
+    double get_single = now_seconds() - start;
+
+    start = now_seconds();
+    hash_table_get_many(single, lookups, N_LOOKUPS, values, exists);
+    double get_batch = now_seconds() - start;
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        checksum -= values[i];
+    }
+
+    printf("%s;%d;%.1f;%.1f;%.2f;%.1f;%.1f;%.2f\n",
+           type == HASH_TABLE_CHAINING ? "chaining" : "open", size,
+           put_single * 1e9 / size, put_batch * 1e9 / size, put_single / put_batch,
+           get_single * 1e9 / N_LOOKUPS, get_batch * 1e9 / N_LOOKUPS, get_single / get_batch);
+    if (checksum != 0) {
+        puts("mismatch between hash_table_get and hash_table_get_many");
+    }
+
+    hash_table_free(single);
+    hash_table_free(batch);
+    free(keys);
+}
+
+int main(void) {
+    int *lookups = (int*) malloc(N_LOOKUPS * sizeof(int));
+    int *values = (int*) malloc(N_LOOKUPS * sizeof(int));
+    bool *exists = (bool*) malloc(N_LOOKUPS * sizeof(bool));
+    srand(42);
+
+    printf("== %d lookups, batches of %d keys\n", N_LOOKUPS, HASH_TABLE_BATCH);
+    printf("Type;Size;Put(ns);PutMany(ns);Speedup;Get(ns);GetMany(ns);Speedup\n");
+    for (int type = HASH_TABLE_CHAINING; type <= HASH_TABLE_OPEN_ADDRESSING; type++) {
+        for (int s = 0; s < SIZES; s++) {
+            for (int i = 0; i < N_LOOKUPS; i++) {
+                lookups[i] = rand() % (2 * sizes[s]);
+            }
+            benchmark_size((HashTableType) type, sizes[s], lookups, values, exists);
+        }
+    }
+
+    free(lookups);
+    free(values);
+    free(exists);
+    return 0;
+}
@@ -0,0 +1,139 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Multi-threaded throughput of HashTableConcurrent against a HashTable
+ * wrapped by a single mutex, on read-mostly workloads.
+ *
+ * Usage: ./benchmark-concurrent.out [max_threads]
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "hash-table.h"
+#include "hash-table-concurrent.h"
+
+#define N_KEYS (1 << 20)
+#define OPS_PER_THREAD 2000000
+#define DEFAULT_MAX_THREADS 16
+
+typedef enum TableKind {
+    MUTEX_HASH_TABLE,
+    CONCURRENT_HASH_TABLE
+} TableKind;
+
+static const char *table_names[] = {"mutex", "concurrent"};
+
+typedef struct Worker {
+    TableKind kind;
+    HashTable *ht;
+    pthread_mutex_t *lock;
+    HashTableConcurrent *t;
+    int read_percent;
+    uint64_t seed;
+    long checksum;
+} Worker;
+
+static inline uint64_t xorshift(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+static void* worker_run(void *arg) {
+    Worker *w = (Worker*) arg;
+    long checksum = 0;
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        uint64_t r = xorshift(&w->seed);
+        int key = (int)((r >> 8) % N_KEYS);
+        bool read = (int)(r % 100) < w->read_percent;
+        if (w->kind == CONCURRENT_HASH_TABLE) {
+            if (read) {
+                checksum += hash_table_concurrent_get(w->t, key, NULL);
+            } else {
+                hash_table_concurrent_put(w->t, key, i);
+            }
+        } else {
+            pthread_mutex_lock(w->lock);
+            if (read) {
+                checksum += hash_table_get(w->ht, key, NULL);
+            } else {
+                hash_table_put(w->ht, key, i);
+            }
+            pthread_mutex_unlock(w->lock);
+        }
+    }
+    w->checksum = checksum;
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// million operations per second of n_threads on a prefilled table
+static double benchmark_run(TableKind kind, int n_threads, int read_percent) {
+    HashTable *ht = hash_table_create(N_KEYS);
+    HashTableConcurrent *t = hash_table_concurrent_create(N_KEYS);
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+    for (int k = 0; k < N_KEYS; k += 2) {
+        hash_table_put(ht, k, k);
+        hash_table_concurrent_put(t, k, k);
+    }
+
+    pthread_t *threads = (pthread_t*) malloc(n_threads * sizeof(pthread_t));
+    Worker *workers = (Worker*) malloc(n_threads * sizeof(Worker));
+    double start = now_seconds();
+    for (int i = 0; i < n_threads; i++) {
+        Worker w = {kind, ht, &lock, t, read_percent, 0x9E3779B97F4A7C15ULL * (i + 1), 0};
+        workers[i] = w;
+        pthread_create(&threads[i], NULL, worker_run, &workers[i]);
+    }
+    for (int i = 0; i < n_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = now_seconds() - start;
+
+    free(threads);
+    free(workers);
+    pthread_mutex_destroy(&lock);
+    hash_table_concurrent_free(t);
+    hash_table_free(ht);
+    return (double) n_threads * OPS_PER_THREAD / elapsed / 1e6;
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+    const int read_percents[] = {90, 99};
+
+    printf("== %d keys, %d operations per thread\n", N_KEYS, OPS_PER_THREAD);
+    printf("Threads;Table;Reads(%%);Throughput(Mops/s)\n");
+    for (size_t r = 0; r < sizeof(read_percents) / sizeof(read_percents[0]); r++) {
+        for (int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+            for (int kind = MUTEX_HASH_TABLE; kind <= CONCURRENT_HASH_TABLE; kind++) {
+                double mops = benchmark_run((TableKind) kind, n_threads, read_percents[r]);
+                printf("%d;%s;%d;%.2f\n", n_threads, table_names[kind], read_percents[r], mops);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Lookups that mostly miss, on tables without a filter and with a Bloom or
+ * a cuckoo filter in front of them (hash_table_use_filter), for tables that
+ * fit or not in the cache; 90% of the lookups are absent keys. Build with
+ * CFLAGS="-O2 -mavx2" to measure the optimized tables and the vector bit
+ * tests of the Bloom filter.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hash-table.h"
+
+#define N_LOOKUPS (1 << 22)
+#define SIZES 3
+#define FILTERS 3
+
+static const int sizes[SIZES] = {1 << 12, 1 << 18, 1 << 22};
+static const char *filter_names[FILTERS] = {"none", "bloom", "cuckoo"};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void benchmark_size(HashTableType type, int size, const int *lookups) {
+    HashTable *ht = hash_table_create_with_type(1, type);
+    for (int i = 0; i < size; i++) {
+        hash_table_put(ht, 10 * i, i); // multiples of 10: 90% of the lookups miss
+    }
+
+    for (int f = 0; f < FILTERS; f++) {
+        hash_table_use_filter(ht, (HashTableFilter) f);
+        long hits = 0;
+        double start = now_seconds();
+        for (int i = 0; i < N_LOOKUPS; i++) {
+            bool exists;
+            hash_table_get(ht, lookups[i], &exists);
+            hits += exists;
+        }
+        double elapsed = now_seconds() - start;
+        printf("%s;%d;%s;%.1f;%.1f;%.1f\n",
+               type == HASH_TABLE_CHAINING ? "chaining" : "open", size, filter_names[f],
+               100.0 * hits / N_LOOKUPS, elapsed * 1e9 / N_LOOKUPS,
+               (double) hash_table_stats(ht).bytes / size);
+    }
+    hash_table_free(ht);
+}
+
+int main(void) {
+    int *lookups = (int*) malloc(N_LOOKUPS * sizeof(int));
+    srand(42);
+    printf("== %d lookups\n", N_LOOKUPS);
+    printf("Type;Size;Filter;Hits(%%);Get(ns);BytesPerKey\n");
+    for (int s = 0; s < SIZES; s++) {
+        for (int i = 0; i < N_LOOKUPS; i++) {
+            lookups[i] = rand() % (10 * sizes[s]);
+        }
+        benchmark_size(HASH_TABLE_CHAINING, sizes[s], lookups);
+        benchmark_size(HASH_TABLE_OPEN_ADDRESSING, sizes[s], lookups);
+    }
+    free(lookups);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Time to get a large table back after a restart: rebuilding it with
+ * hash_table_put against reopening a snapshot with hash_table_open_mmap,
+ * then random lookups on the mapped table against the in-memory one.
+ *
+ * Usage: ./benchmark-snapshot.out [path]
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hash-table.h"
+
+#define N_KEYS (1 << 22)
+#define N_LOOKUPS (1 << 22)
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double lookups_ns(HashTable *ht, const int *lookups, long *checksum) {
+    double start = now_seconds();
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        *checksum += hash_table_get(ht, lookups[i], NULL);
+    }
+    return (now_seconds() - start) * 1e9 / N_LOOKUPS;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : "benchmark.snapshot";
+    int *lookups = (int*) malloc(N_LOOKUPS * sizeof(int));
+    srand(42);
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        lookups[i] = rand() % (2 * N_KEYS);
+    }
+
+    printf("== %d keys, %d lookups\n", N_KEYS, N_LOOKUPS);
+    printf("Type;Rebuild(s);Save(s);OpenMmap(s);Get(ns);MappedGet(ns)\n");
+    for (int type = HASH_TABLE_CHAINING; type <= HASH_TABLE_OPEN_ADDRESSING; type++) {
+        double start = now_seconds();
+        HashTable *ht = hash_table_create_with_type(1, (HashTableType) type);
+        for (int k = 0; k < N_KEYS; k++) {
+            hash_table_put(ht, 2 * k, k);
+        }
+        double rebuild = now_seconds() - start;
+
+        start = now_seconds();
+        hash_table_save(ht, path);
+        double save = now_seconds() - start;
+
+        start = now_seconds();
+        HashTable *mapped = hash_table_open_mmap(path);
+        double open = now_seconds() - start;
+
+        long checksum = 0;
+        double get = lookups_ns(ht, lookups, &checksum);
+        double mapped_get = lookups_ns(mapped, lookups, &checksum);
+        printf("%s;%.3f;%.3f;%.6f;%.1f;%.1f\n", type == HASH_TABLE_CHAINING ? "chaining" : "open",
+               rebuild, save, open, get, mapped_get);
+        if (checksum != 0 && !hash_table_verify_snapshot(mapped)) {
+            puts("corrupted snapshot");
+        }
+
+        hash_table_free(mapped);
+        hash_table_free(ht);
+    }
+
+    remove(path);
+    free(lookups);
+    return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Distribution quality of the hash functions over common key patterns,
+ * and the resulting put/get time of a HashTable.
+ *
+ * For each pattern, N_KEYS keys are spread over N_KEYS buckets (load 1):
+ * - max: longest chain
+ * - empty: fraction of empty buckets (ideal ~ 1/e = 0.368)
+ * - cost: mean nodes visited by a successful lookup (ideal ~ 1.5)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hash-table.h"
+#include "../utils/hash.h"
+#include "../utils/pair_hash.h"
+
+#define N_KEYS (1 << 16)
+#define PAIR_SIDE (1 << 8)
+
+typedef enum KeyPattern {
+    SEQUENTIAL,
+    NEGATIVE,
+    STRIDED_64,
+    STRIDED_1024,
+    PAIR_HASH,
+    RANDOM,
+    N_PATTERNS
+} KeyPattern;
+
+static const char *pattern_names[] = {
+    "sequential", "negative", "strided-64", "strided-1024", "pair-hash", "random"
+};
+
+// previous hash of the tables: absolute value modulo the number of buckets
+static uint64_t hash_modulo(int key) {
+    return key < 0 ? 0u - (uint64_t) key : (uint64_t) key;
+}
+
+typedef struct HashCandidate {
+    const char *name;
+    HashFunction hash; // NULL for the default hash_mix
+} HashCandidate;
+
+static const HashCandidate candidates[] = {
+    {"modulo", &hash_modulo},
+    {"identity", &hash_identity},
+    {"mix", NULL},
+};
+
+#define N_CANDIDATES (sizeof(candidates) / sizeof(candidates[0]))
+
+static void generate_keys(int *keys, KeyPattern pattern) {
+    for (int i = 0; i < N_KEYS; i++) {
+        switch (pattern) {
+        case SEQUENTIAL: keys[i] = i; break;
+        case NEGATIVE: keys[i] = -i; break;
+        case STRIDED_64: keys[i] = i * 64; break;
+        case STRIDED_1024: keys[i] = i * 1024; break;
+        case PAIR_HASH: keys[i] = pair_hash(i / PAIR_SIDE, i % PAIR_SIDE); break;
+        case RANDOM: keys[i] = rand(); break;
+        default: break;
+        }
+    }
+}
+
+static void benchmark_distribution(const int *keys, HashFunction hash, size_t *counts) {
+    size_t mask = N_KEYS - 1;
+    memset(counts, 0, N_KEYS * sizeof(size_t));
+    for (int i = 0; i < N_KEYS; i++) {
+        counts[hash_apply(hash, keys[i]) & mask]++;
+    }
+
+    size_t max = 0, empty = 0;
+    double cost = 0;
+    for (size_t b = 0; b < N_KEYS; b++) {
+        max = counts[b] > max ? counts[b] : max;
+        empty += counts[b] == 0;
+        cost += (double) counts[b] * (counts[b] + 1) / 2;
+    }
+    printf("%zu;%.3f;%.2f;", max, (double) empty / N_KEYS, cost / N_KEYS);
+}
+
+static void benchmark_table(const int *keys, HashFunction hash) {
+    clock_t start = clock();
+    HashTable *ht = hash_table_create_with_hash(16, HASH_TABLE_CHAINING, hash);
+    for (int i = 0; i < N_KEYS; i++) {
+        hash_table_put(ht, keys[i], i);
+    }
+    long checksum = 0;
+    for (int i = 0; i < N_KEYS; i++) {
+        checksum += hash_table_get(ht, keys[i], NULL);
+    }
+    hash_table_free(ht);
+    clock_t end = clock();
+    printf("%.3f\n", (double) 1000 * (end - start) / CLOCKS_PER_SEC);
+    if (checksum < 0) {
+        puts("unreachable");
+    }
+}
+
+int main(void) {
+    int *keys = (int*) malloc(N_KEYS * sizeof(int));
+    size_t *counts = (size_t*) malloc(N_KEYS * sizeof(size_t));
+    srand(42);
+
+    printf("== %d keys, %d buckets\n", N_KEYS, N_KEYS);
+    printf("Pattern;Hash;Max;Empty;Cost;Time(ms)\n");
+    for (int p = 0; p < N_PATTERNS; p++) {
+        generate_keys(keys, (KeyPattern) p);
+        for (size_t c = 0; c < N_CANDIDATES; c++) {
+            printf("%s;%s;", pattern_names[p], candidates[c].name);
+            benchmark_distribution(keys, candidates[c].hash, counts);
+            benchmark_table(keys, candidates[c].hash);
+        }
+    }
+
+    free(keys);
+    free(counts);
+    return 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "hash-table-concurrent.h"
+#include "hash-table.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+#define STRIPES HASH_TABLE_CONCURRENT_STRIPES
+#define CACHE_LINE 64
+
+typedef struct ConcurrentNode {
+    int key;                        // immutable once published
+    int value;                      // atomic
+    struct ConcurrentNode *next;    // atomic, readers may walk it at any time
+    struct ConcurrentNode *retired; // next node of the retired list
+} ConcurrentNode;
+
+// one array of buckets, replaced as a whole when the table grows
+typedef struct ConcurrentBuckets {
+    size_t n_buckets;                   // power of two, at least STRIPES
+    ConcurrentNode **heads;             // atomic
+    struct ConcurrentBuckets *retired;  // next array of the retired list
+} ConcurrentBuckets;
+
+typedef struct ConcurrentStripe {
+    pthread_mutex_t lock;     // guards the buckets i with i % STRIPES == stripe
+    size_t size;              // pairs in those buckets, written under lock
+    char padding[CACHE_LINE]; // no false sharing between stripes
+} ConcurrentStripe;
+
+struct HashTableConcurrent {
+    ConcurrentBuckets *buckets;         // atomic, current array
+    char padding[CACHE_LINE];           // read by every get, keep it apart
+    ConcurrentStripe stripes[STRIPES];
+    ConcurrentNode *retired_nodes;      // atomic, removed nodes
+    ConcurrentBuckets *retired_buckets; // arrays replaced by a growth
+};
+
+static ConcurrentBuckets* concurrent_buckets_alloc(size_t n_buckets) {
+    ConcurrentBuckets *b = (ConcurrentBuckets*) malloc(sizeof(ConcurrentBuckets));
+    check_alloc(b);
+    b->n_buckets = n_buckets;
+    b->heads = (ConcurrentNode**) calloc(n_buckets, sizeof(ConcurrentNode*));
+    check_alloc(b->heads);
+    b->retired = NULL;
+    return b;
+}
+
+// free an array of buckets with its nodes, no reader may be using it
+static void concurrent_buckets_free(ConcurrentBuckets *b) {
+    for (size_t i = 0; i < b->n_buckets; i++) {
+        ConcurrentNode *node = b->heads[i];
+        while (node != NULL) {
+            ConcurrentNode *next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(b->heads);
+    free(b);
+}
+
+static ConcurrentNode* concurrent_node_new(int key, int value, ConcurrentNode *next) {
+    ConcurrentNode *node = (ConcurrentNode*) malloc(sizeof(ConcurrentNode));
+    check_alloc(node);
+    node->key = key;
+    node->value = value;
+    node->next = next;
+    node->retired = NULL;
+    return node;
+}
+
+static ConcurrentStripe* hash_table_concurrent__stripe(HashTableConcurrent *t, uint64_t h) {
+    return &t->stripes[h & (STRIPES - 1)];
+}
+
+// defer the free of a removed node: readers may still be walking over it
+static void hash_table_concurrent__retire(HashTableConcurrent *t, ConcurrentNode *node) {
+    node->retired = __atomic_load_n(&t->retired_nodes, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&t->retired_nodes, &node->retired, node,
+                                        true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        // node->retired was updated with the current head, try again
+    }
+}
+
+// double the buckets, unless another writer did it since seen was loaded
+static void hash_table_concurrent__grow(HashTableConcurrent *t, ConcurrentBuckets *seen) {
+    for (size_t i = 0; i < STRIPES; i++) {
+        pthread_mutex_lock(&t->stripes[i].lock);
+    }
+
+    ConcurrentBuckets *b = t->buckets;
+    if (b == seen) {
+        // copy instead of relinking: readers are still walking the chains of b
+        ConcurrentBuckets *grown = concurrent_buckets_alloc(b->n_buckets * 2);
+        size_t mask = grown->n_buckets - 1;
+        for (size_t i = 0; i < b->n_buckets; i++) {
+            for (ConcurrentNode *node = b->heads[i]; node != NULL; node = node->next) {
+                size_t index = hash_mix(node->key) & mask;
+                grown->heads[index] = concurrent_node_new(node->key, node->value, grown->heads[index]);
+            }
+        }
+        __atomic_store_n(&t->buckets, grown, __ATOMIC_RELEASE);
+        b->retired = t->retired_buckets;
+        t->retired_buckets = b;
+    }
+
+    for (size_t i = STRIPES; i > 0; i--) {
+        pthread_mutex_unlock(&t->stripes[i - 1].lock);
+    }
+}
+
+HashTableConcurrent* hash_table_concurrent_create(size_t n_buckets) {
+    HashTableConcurrent *t = (HashTableConcurrent*) malloc(sizeof(HashTableConcurrent));
+    check_alloc(t);
+    t->buckets = concurrent_buckets_alloc(hash_round_pow2(n_buckets > STRIPES ? n_buckets : STRIPES));
+    for (size_t i = 0; i < STRIPES; i++) {
+        pthread_mutex_init(&t->stripes[i].lock, NULL);
+        t->stripes[i].size = 0;
+    }
+    t->retired_nodes = NULL;
+    t->retired_buckets = NULL;
+    return t;
+}
+
+void hash_table_concurrent_put(HashTableConcurrent *t, int key, int value) {
+    uint64_t h = hash_mix(key);
+    ConcurrentStripe *stripe = hash_table_concurrent__stripe(t, h);
+    pthread_mutex_lock(&stripe->lock);
+
+    // the array cannot be replaced while a stripe lock is held
+    ConcurrentBuckets *b = t->buckets;
+    ConcurrentNode **head = &b->heads[h & (b->n_buckets - 1)];
+    for (ConcurrentNode *node = *head; node != NULL; node = node->next) {
+        if (node->key == key) {
+            __atomic_store_n(&node->value, value, __ATOMIC_RELAXED);
+            pthread_mutex_unlock(&stripe->lock);
+            return;
+        }
+    }
+
+    // the node is fully built before being visible to readers
+    __atomic_store_n(head, concurrent_node_new(key, value, *head), __ATOMIC_RELEASE);
+    size_t size = stripe->size + 1;
+    __atomic_store_n(&stripe->size, size, __ATOMIC_RELAXED);
+    bool crowded = size > b->n_buckets / STRIPES * HASH_TABLE_MAX_LOAD;
+    pthread_mutex_unlock(&stripe->lock);
+
+    if (crowded) {
+        hash_table_concurrent__grow(t, b);
+    }
+}
+
+void hash_table_concurrent_remove(HashTableConcurrent *t, int key) {
+    uint64_t h = hash_mix(key);
+    ConcurrentStripe *stripe = hash_table_concurrent__stripe(t, h);
+    pthread_mutex_lock(&stripe->lock);
+
+    ConcurrentBuckets *b = t->buckets;
+    ConcurrentNode **link = &b->heads[h & (b->n_buckets - 1)];
+    for (ConcurrentNode *node = *link; node != NULL; link = &node->next, node = *link) {
+        if (node->key == key) {
+            // node->next stays intact for the readers standing on node
+            __atomic_store_n(link, node->next, __ATOMIC_RELEASE);
+            __atomic_store_n(&stripe->size, stripe->size - 1, __ATOMIC_RELAXED);
+            hash_table_concurrent__retire(t, node);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stripe->lock);
+}
+
+int hash_table_concurrent_get(HashTableConcurrent *t, int key, bool *exists) {
+    uint64_t h = hash_mix(key);
+    ConcurrentBuckets *b = __atomic_load_n(&t->buckets, __ATOMIC_ACQUIRE);
+    ConcurrentNode *node = __atomic_load_n(&b->heads[h & (b->n_buckets - 1)], __ATOMIC_ACQUIRE);
+    while (node != NULL && node->key != key) {
+        node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    }
+    if (exists != NULL) {
+        *exists = node != NULL;
+    }
+    if (node == NULL) {
+        return -1;
+    }
+    return __atomic_load_n(&node->value, __ATOMIC_RELAXED);
+}
+
+size_t hash_table_concurrent_size(HashTableConcurrent *t) {
+    size_t size = 0;
+    for (size_t i = 0; i < STRIPES; i++) {
+        size += __atomic_load_n(&t->stripes[i].size, __ATOMIC_RELAXED);
+    }
+    return size;
+}
+
+void hash_table_concurrent_reclaim(HashTableConcurrent *t) {
+    ConcurrentNode *node = t->retired_nodes;
+    while (node != NULL) {
+        ConcurrentNode *next = node->retired;
+        free(node);
+        node = next;
+    }
+    t->retired_nodes = NULL;
+
+    ConcurrentBuckets *b = t->retired_buckets;
+    while (b != NULL) {
+        ConcurrentBuckets *next = b->retired;
+        concurrent_buckets_free(b);
+        b = next;
+    }
+    t->retired_buckets = NULL;
+}
+
+void hash_table_concurrent_free(HashTableConcurrent *t) {
+    hash_table_concurrent_reclaim(t);
+    concurrent_buckets_free(t->buckets);
+    for (size_t i = 0; i < STRIPES; i++) {
+        pthread_mutex_destroy(&t->stripes[i].lock);
+    }
+    free(t);
+}
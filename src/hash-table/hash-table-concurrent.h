@@ -0,0 +1,109 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef HASH_TABLE_CONCURRENT_H
+#define HASH_TABLE_CONCURRENT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of locks shared by the writers of a concurrent hash table.
+ *
+ * Bucket i is guarded by the lock i % HASH_TABLE_CONCURRENT_STRIPES, so up
+ * to this number of writers can run in parallel. Must be a power of two.
+ */
+#ifndef HASH_TABLE_CONCURRENT_STRIPES
+#define HASH_TABLE_CONCURRENT_STRIPES 64
+#endif
+
+/**
+ * @brief A thread-safe hash table of int -> int with separate chaining.
+ *
+ * Reads are lock-free: hash_table_concurrent_get() never blocks and never
+ * writes to shared memory, so read-mostly workloads scale with the number
+ * of threads. Writes take one of HASH_TABLE_CONCURRENT_STRIPES striped
+ * locks, chosen by the hash of the key.
+ *
+ * The table grows when its load factor reaches HASH_TABLE_MAX_LOAD: the
+ * growing writer takes every lock, copies the pairs to a new array of
+ * buckets and publishes it atomically. Readers keep walking the previous
+ * array meanwhile, so it cannot be freed right away.
+ *
+ * Removed nodes and previous bucket arrays are retired instead of freed.
+ * They are released by hash_table_concurrent_reclaim(), which must be
+ * called at a quiescent point (when no other thread is using the table),
+ * or by hash_table_concurrent_free().
+ */
+typedef struct HashTableConcurrent HashTableConcurrent;
+
+/**
+ * @brief Create a new concurrent hash table
+ * @param n_buckets initial number of buckets (at least HASH_TABLE_CONCURRENT_STRIPES)
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTableConcurrent* hash_table_concurrent_create(size_t n_buckets);
+
+/**
+ * @brief Put a value associated to a key, thread-safe
+ * @param t hash table pointer
+ * @param key integer key
+ * @param value integer value to store
+ * @ingroup DataStructureMethods
+ */
+void hash_table_concurrent_put(HashTableConcurrent *t, int key, int value);
+
+/**
+ * @brief Remove the value associated with a given key, thread-safe
+ * @param t hash table pointer
+ * @param key integer key
+ * @ingroup DataStructureMethods
+ */
+void hash_table_concurrent_remove(HashTableConcurrent *t, int key);
+
+/**
+ * @brief Get a value in the hash table, thread-safe and lock-free
+ * @param t hash table pointer
+ * @param key integer key
+ * @param exists bool pointer, set true if found false otherwise; null pointer does nothing
+ * @return the value or -1 if the key does not exist
+ * @ingroup DataStructureMethods
+ */
+int hash_table_concurrent_get(HashTableConcurrent *t, int key, bool *exists);
+
+/**
+ * @brief Get the number of elements in the hash table
+ *
+ * Exact only when no write is running concurrently.
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_concurrent_size(HashTableConcurrent *t);
+
+/**
+ * @brief Free the removed nodes and the bucket arrays replaced by a growth
+ *
+ * Not thread-safe: no other thread may use the table during this call.
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+void hash_table_concurrent_reclaim(HashTableConcurrent *t);
+
+/**
+ * @brief Free memory of the hash table
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+void hash_table_concurrent_free(HashTableConcurrent *t);
+
+#endif /* HASH_TABLE_CONCURRENT_H */
@@ -2,27 +2,42 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "hash-table-gen.h"
+#include "hash-table.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
 
 struct HashTableGen {
     size_t size;
-    size_t n_buckets;
+    size_t n_buckets;       // always a power of two
     ListGen **buckets;
+    size_t min_buckets;     // the table never shrinks below its initial size
+    size_t old_n_buckets;   // size of old_buckets
+    ListGen **old_buckets;  // buckets being migrated, NULL when not rehashing
+    size_t rehash_index;    // next bucket of old_buckets to migrate
+    HashFunction hash;      // NULL for the default mixer
 };
 
-static unsigned int hash_int(int key, size_t n_buckets) {
-    if (key < 0) {
-        key = -key;
-    }
-    return (unsigned int)(key % n_buckets);
+// bucket of key: the low bits of the hash, n_buckets is a power of two
+static inline size_t hash_table_gen__index(HashTableGen *ht, int key, size_t n_buckets) {
+    return (size_t) hash_apply(ht->hash, key) & (n_buckets - 1);
 }
 
 HashTableGen* hash_table_gen_create(size_t n_buckets) {
+    return hash_table_gen_create_with_hash(n_buckets, NULL);
+}
+
+HashTableGen* hash_table_gen_create_with_hash(size_t n_buckets, HashFunction hash) {
     HashTableGen *ht = (HashTableGen*) malloc(sizeof(HashTableGen));
     if (!ht) return NULL;
 
-    ht->n_buckets = n_buckets;
+    ht->hash = hash;
+    ht->n_buckets = hash_round_pow2(n_buckets);
+    ht->min_buckets = ht->n_buckets;
     ht->size = 0;
-    ht->buckets = (ListGen**) calloc(n_buckets, sizeof(ListGen*));
+    ht->old_n_buckets = 0;
+    ht->old_buckets = NULL;
+    ht->rehash_index = 0;
+    ht->buckets = (ListGen**) calloc(ht->n_buckets, sizeof(ListGen*));
     if (!ht->buckets) {
         free(ht);
         return NULL;
@@ -30,6 +45,86 @@ HashTableGen* hash_table_gen_create(size_t n_buckets) {
     return ht;
 }
 
+// migrate up to n_steps non-empty buckets of the old generation,
+// bounding also the number of empty buckets visited
+static void hash_table_gen__rehash_step(HashTableGen *ht, size_t n_steps) {
+    if (ht->old_buckets == NULL) {
+        return;
+    }
+
+    size_t empty_visits = n_steps * 10;
+    while (n_steps > 0 && ht->rehash_index < ht->old_n_buckets) {
+        ListGen *node = ht->old_buckets[ht->rehash_index];
+        if (node == NULL) {
+            ht->rehash_index++;
+            if (--empty_visits == 0) {
+                break;
+            }
+            continue;
+        }
+        while (node != NULL) {
+            ListGen *next = node->next;
+            size_t index = hash_table_gen__index(ht, node->key, ht->n_buckets);
+            node->next = ht->buckets[index];
+            ht->buckets[index] = node;
+            node = next;
+        }
+        ht->old_buckets[ht->rehash_index++] = NULL;
+        n_steps--;
+    }
+
+    if (ht->rehash_index == ht->old_n_buckets) {
+        free(ht->old_buckets);
+        ht->old_buckets = NULL;
+        ht->old_n_buckets = 0;
+        ht->rehash_index = 0;
+    }
+}
+
+static void hash_table_gen__rehash(HashTableGen *ht, size_t n_buckets) {
+    while (ht->old_buckets != NULL) {
+        hash_table_gen__rehash_step(ht, HASH_TABLE_REHASH_STEP);
+    }
+    ListGen **buckets = (ListGen**) calloc(n_buckets, sizeof(ListGen*));
+    check_alloc(buckets);
+    ht->old_buckets = ht->buckets;
+    ht->old_n_buckets = ht->n_buckets;
+    ht->rehash_index = 0;
+    ht->buckets = buckets;
+    ht->n_buckets = n_buckets;
+}
+
+static void hash_table_gen__resize_if_needed(HashTableGen *ht) {
+    if (ht->old_buckets != NULL) {
+        return;
+    }
+    if (ht->size > ht->n_buckets * HASH_TABLE_MAX_LOAD) {
+        hash_table_gen__rehash(ht, ht->n_buckets * 2);
+    } else if (ht->n_buckets > ht->min_buckets
+               && ht->size * HASH_TABLE_SHRINK_RATIO < ht->n_buckets) {
+        size_t n_buckets = ht->n_buckets / 2;
+        hash_table_gen__rehash(ht, n_buckets > ht->min_buckets ? n_buckets : ht->min_buckets);
+    }
+}
+
+// find the node of key: in the new buckets or, during a rehash,
+// in a bucket of the old generation not migrated yet
+static ListGen* hash_table_gen__search(HashTableGen *ht, int key, ListGen ***bucket) {
+    ListGen **b = &ht->buckets[hash_table_gen__index(ht, key, ht->n_buckets)];
+    ListGen *found = list_gen_search_by_key(*b, key);
+    if (found == NULL && ht->old_buckets != NULL) {
+        ListGen **old = &ht->old_buckets[hash_table_gen__index(ht, key, ht->old_n_buckets)];
+        found = list_gen_search_by_key(*old, key);
+        if (found != NULL) {
+            b = old;
+        }
+    }
+    if (bucket != NULL) {
+        *bucket = b;
+    }
+    return found;
+}
+
 bool hash_table_gen_empty(HashTableGen *ht) {
     if (!ht) {
         return true;
@@ -40,55 +135,48 @@ bool hash_table_gen_empty(HashTableGen *ht) {
 }
 
 void hash_table_gen_put(HashTableGen *ht, int key, void *data) {
-    unsigned int index = hash_int(key, ht->n_buckets);
-
-    ListGen *found = list_gen_search_by_key(ht->buckets[index], key);
+    hash_table_gen__rehash_step(ht, HASH_TABLE_REHASH_STEP);
+    ListGen *found = hash_table_gen__search(ht, key, NULL);
 
     if (found != NULL) {
         found->data = data;
     } else {
+        size_t index = hash_table_gen__index(ht, key, ht->n_buckets);
         ht->buckets[index] = list_gen_insert_with_key(ht->buckets[index], key, data);
         ht->size++;
+        hash_table_gen__resize_if_needed(ht);
     }
 }
 
 void hash_table_gen_remove(HashTableGen *ht, int key) {
-    bool exists;
-    hash_table_gen_get(ht, key, &exists);
-    if (!exists) {
+    hash_table_gen__rehash_step(ht, HASH_TABLE_REHASH_STEP);
+    ListGen **bucket;
+    if (hash_table_gen__search(ht, key, &bucket) == NULL) {
         return;
     }
-    unsigned int index = hash_int(key, ht->n_buckets);
-    ht->buckets[index] = list_gen_remove_by_key(ht->buckets[index], key);
+    *bucket = list_gen_remove_by_key(*bucket, key);
     ht->size--;
+    hash_table_gen__resize_if_needed(ht);
 }
 
 void* hash_table_gen_get(HashTableGen *ht, int key, bool *exists) {
-    unsigned int index = hash_int(key, ht->n_buckets);
-    ListGen *l = ht->buckets[index];
-    while (l) {
-        if (l->key == key) {
-            if (exists != NULL) {
-                *exists = true;
-            }
-            return l->data;
-        }
-        l = l->next;
-    }
+    ListGen *found = hash_table_gen__search(ht, key, NULL);
     if (exists != NULL) {
-        *exists = false;
+        *exists = found != NULL;
+    }
+    if (found == NULL) {
+        return NULL;
     }
-    return NULL;
+    return found->data;
 }
 
 size_t hash_table_gen_size(HashTableGen *ht) {
     return ht->size;
 }
 
-List* hash_table_gen_keys(HashTableGen *ht) {
-    List *keys = list_create();
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        ListGen *head = ht->buckets[i];
+static List* hash_table_gen__bucket_keys(List *keys, ListGen **buckets, size_t n_buckets) {
+    for (size_t i = 0; i < n_buckets; i++) {
+        ListGen *head = buckets[i];
         if (!list_gen_empty(head)) {
             do {
                 keys = list_insert(keys, head->key);
@@ -99,18 +187,30 @@ List* hash_table_gen_keys(HashTableGen *ht) {
     return keys;
 }
 
+List* hash_table_gen_keys(HashTableGen *ht) {
+    List *keys = list_create();
+    keys = hash_table_gen__bucket_keys(keys, ht->buckets, ht->n_buckets);
+    keys = hash_table_gen__bucket_keys(keys, ht->old_buckets, ht->old_n_buckets);
+    return keys;
+}
 
-void hash_table_gen_free(HashTableGen *ht, void (*free_data)(void *)) {
-    for (size_t i = 0; i < ht->n_buckets; i++) {
+
+static void hash_table_gen__free_buckets(ListGen **buckets, size_t n_buckets, void (*free_data)(void *)) {
+    for (size_t i = 0; i < n_buckets; i++) {
         if(free_data) {
-            ListGen *l = ht->buckets[i];
+            ListGen *l = buckets[i];
             while(l) {
                 free_data(l->data);
                 l = l->next;
             }
         }
-        list_gen_free(ht->buckets[i]);
+        list_gen_free(buckets[i]);
     }
-    free(ht->buckets);
+    free(buckets);
+}
+
+void hash_table_gen_free(HashTableGen *ht, void (*free_data)(void *)) {
+    hash_table_gen__free_buckets(ht->buckets, ht->n_buckets, free_data);
+    hash_table_gen__free_buckets(ht->old_buckets, ht->old_n_buckets, free_data);
     free(ht);
 }
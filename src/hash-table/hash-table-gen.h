@@ -17,17 +17,34 @@
 #include <stdbool.h>
 #include "../list/single/list-gen.h"
 #include "../list/single/list.h"
+#include "../utils/hash.h"
 
+/**
+ * @brief A hash table of int -> void* with separate chaining.
+ *
+ * Like HashTable, it grows and shrinks incrementally following the load
+ * factor (see HASH_TABLE_MAX_LOAD and HASH_TABLE_REHASH_STEP), and its
+ * number of buckets is a power of two indexed by the low bits of the hash.
+ */
 typedef struct HashTableGen HashTableGen;
 
 /**
  * @brief Creates a new generic hash table.
- * @param n_buckets The number of buckets.
+ * @param n_buckets The initial number of buckets.
  * @return A pointer to the new hash table.
  * @ingroup DataStructureMethods
  */
 HashTableGen* hash_table_gen_create(size_t n_buckets);
 
+/**
+ * @brief Creates a new generic hash table with a custom hash function.
+ * @param n_buckets The initial number of buckets.
+ * @param hash The hash function of the keys, NULL for hash_mix().
+ * @return A pointer to the new hash table.
+ * @ingroup DataStructureMethods
+ */
+HashTableGen* hash_table_gen_create_with_hash(size_t n_buckets, HashFunction hash);
+
 /**
  * @brief Checks if the hash table is empty.
  * @param ht The hash table.
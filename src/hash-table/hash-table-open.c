@@ -0,0 +1,536 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "hash-table-open.h"
+#include "hash-table.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define GROUP_WIDTH HASH_TABLE_OPEN_GROUP_WIDTH
+#define CTRL_EMPTY ((int8_t) -128)  // 0b10000000
+#define CTRL_DELETED ((int8_t) -2)  // 0b11111110
+#define SLOT_NOT_FOUND ((size_t) -1)
+
+// flat arrays of one generation of the table
+typedef struct OpenSlots {
+    size_t capacity;    // number of slots: power of two, multiple of GROUP_WIDTH
+    size_t growth_left; // inserts over empty slots left before a rehash
+    int8_t *ctrl;       // control byte per slot: EMPTY, DELETED or 7-bit hash
+    int *keys;
+    int *values;
+} OpenSlots;
+
+struct HashTableOpen {
+    size_t size;          // number of occupied slots, in both generations
+    size_t min_capacity;  // the table never shrinks below its initial capacity
+    OpenSlots slots;      // table receiving the inserts
+    OpenSlots old;        // table being migrated into slots (capacity 0 if none)
+    size_t migrate_group; // next group of old to migrate
+    HashFunction hash;    // NULL for the default mixer
+    bool mapped;          // slots owned by the caller, read-only
+    size_t resizes;       // rehashes started
+    size_t refs;          // atomic, tables sharing this one, see hash_table_open_share()
+};
+
+// bitmask with one bit per slot of a group
+typedef unsigned int GroupMask;
+
+static inline uint64_t hash_table_open__hash(HashTableOpen *t, int key) {
+    return hash_apply(t->hash, key);
+}
+
+static inline int8_t hash_table_open__h2(uint64_t h) {
+    return (int8_t)(h & 0x7F);
+}
+
+static inline size_t hash_table_open__h1(uint64_t h) {
+    return (size_t)(h >> 7);
+}
+
+static inline GroupMask group_match(const int8_t *group, int8_t byte) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte));
+    return (GroupMask) _mm_movemask_epi8(match);
+#else
+    GroupMask mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] == byte) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+static inline GroupMask group_match_empty(const int8_t *group) {
+    return group_match(group, CTRL_EMPTY);
+}
+
+// empty and deleted are the only control bytes with the sign bit set
+static inline GroupMask group_match_free(const int8_t *group) {
+#ifdef __SSE2__
+    __m128i ctrl = _mm_loadu_si128((const __m128i*) group);
+    return (GroupMask) _mm_movemask_epi8(ctrl);
+#else
+    GroupMask mask = 0;
+    for (int i = 0; i < GROUP_WIDTH; i++) {
+        if (group[i] < 0) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+static inline int group_mask_first(GroupMask mask) {
+    return __builtin_ctz(mask);
+}
+
+static size_t hash_table_open__round_capacity(size_t n) {
+    // keep the load factor under 7/8 for n elements
+    size_t needed = n + n / HASH_TABLE_OPEN_MAX_LOAD_NUM + 1;
+    size_t capacity = GROUP_WIDTH;
+    while (capacity < needed) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static void open_slots_alloc(OpenSlots *s, size_t capacity) {
+    s->capacity = capacity;
+    s->growth_left = capacity * HASH_TABLE_OPEN_MAX_LOAD_NUM / HASH_TABLE_OPEN_MAX_LOAD_DEN;
+    s->ctrl = (int8_t*) malloc(capacity * sizeof(int8_t));
+    s->keys = (int*) malloc(capacity * sizeof(int));
+    s->values = (int*) malloc(capacity * sizeof(int));
+    check_alloc(s->ctrl);
+    check_alloc(s->keys);
+    check_alloc(s->values);
+    memset(s->ctrl, CTRL_EMPTY, capacity * sizeof(int8_t));
+}
+
+static void open_slots_copy(OpenSlots *dst, const OpenSlots *src) {
+    if (src->capacity == 0) {
+        memset(dst, 0, sizeof(OpenSlots));
+        return;
+    }
+    open_slots_alloc(dst, src->capacity);
+    dst->growth_left = src->growth_left;
+    memcpy(dst->ctrl, src->ctrl, src->capacity * sizeof(int8_t));
+    memcpy(dst->keys, src->keys, src->capacity * sizeof(int));
+    memcpy(dst->values, src->values, src->capacity * sizeof(int));
+}
+
+static void open_slots_release(OpenSlots *s) {
+    free(s->ctrl);
+    free(s->keys);
+    free(s->values);
+    memset(s, 0, sizeof(OpenSlots));
+}
+
+// probe groups in triangular sequence: visits every group when the
+// number of groups is a power of two
+static size_t open_slots_find(const OpenSlots *s, int key, uint64_t h) {
+    size_t n_groups = s->capacity / GROUP_WIDTH;
+    size_t mask = n_groups - 1;
+    size_t g = hash_table_open__h1(h) & mask;
+    int8_t h2 = hash_table_open__h2(h);
+
+    for (size_t step = 0; step < n_groups; step++) {
+        const int8_t *group = s->ctrl + g * GROUP_WIDTH;
+        GroupMask match = group_match(group, h2);
+        while (match) {
+            size_t slot = g * GROUP_WIDTH + group_mask_first(match);
+            if (s->keys[slot] == key) {
+                return slot;
+            }
+            match &= match - 1;
+        }
+        if (group_match_empty(group)) {
+            return SLOT_NOT_FOUND;
+        }
+        g = (g + step + 1) & mask;
+    }
+    return SLOT_NOT_FOUND;
+}
+
+static size_t open_slots_find_free(const OpenSlots *s, uint64_t h) {
+    size_t n_groups = s->capacity / GROUP_WIDTH;
+    size_t mask = n_groups - 1;
+    size_t g = hash_table_open__h1(h) & mask;
+
+    for (size_t step = 0; step < n_groups; step++) {
+        GroupMask free_slots = group_match_free(s->ctrl + g * GROUP_WIDTH);
+        if (free_slots) {
+            return g * GROUP_WIDTH + group_mask_first(free_slots);
+        }
+        g = (g + step + 1) & mask;
+    }
+    return SLOT_NOT_FOUND;
+}
+
+static void open_slots_set(OpenSlots *s, size_t slot, uint64_t h, int key, int value) {
+    if (s->ctrl[slot] == CTRL_EMPTY && s->growth_left > 0) {
+        s->growth_left--;
+    }
+    s->ctrl[slot] = hash_table_open__h2(h);
+    s->keys[slot] = key;
+    s->values[slot] = value;
+}
+
+static void open_slots_erase(OpenSlots *s, size_t slot) {
+    // a group with an empty slot never made a probe sequence continue,
+    // so its slots can be released without leaving a tombstone
+    const int8_t *group = s->ctrl + (slot / GROUP_WIDTH) * GROUP_WIDTH;
+    if (group_match_empty(group)) {
+        s->ctrl[slot] = CTRL_EMPTY;
+        s->growth_left++;
+    } else {
+        s->ctrl[slot] = CTRL_DELETED;
+    }
+}
+
+static bool hash_table_open__rehashing(HashTableOpen *t) {
+    return t->old.capacity > 0;
+}
+
+// migrate a bounded number of groups of the old generation
+static void hash_table_open__rehash_step(HashTableOpen *t, size_t n_groups) {
+    if (!hash_table_open__rehashing(t)) {
+        return;
+    }
+
+    size_t old_groups = t->old.capacity / GROUP_WIDTH;
+    for (size_t k = 0; k < n_groups && t->migrate_group < old_groups; k++) {
+        size_t base = t->migrate_group * GROUP_WIDTH;
+        GroupMask full = ~group_match_free(t->old.ctrl + base) & 0xFFFFu;
+        while (full) {
+            size_t i = base + group_mask_first(full);
+            uint64_t h = hash_table_open__hash(t, t->old.keys[i]);
+            size_t slot = open_slots_find_free(&t->slots, h);
+            open_slots_set(&t->slots, slot, h, t->old.keys[i], t->old.values[i]);
+            t->old.ctrl[i] = CTRL_DELETED;
+            full &= full - 1;
+        }
+        t->migrate_group++;
+    }
+
+    if (t->migrate_group == old_groups) {
+        open_slots_release(&t->old);
+    }
+}
+
+// start moving the pairs to a new generation with the given capacity
+static void hash_table_open__rehash(HashTableOpen *t, size_t capacity) {
+    if (hash_table_open__rehashing(t)) {
+        hash_table_open__rehash_step(t, (size_t) -1);
+    }
+    t->old = t->slots;
+    t->migrate_group = 0;
+    t->resizes++;
+    open_slots_alloc(&t->slots, capacity);
+    hash_table_open__rehash_step(t, HASH_TABLE_OPEN_REHASH_STEP);
+}
+
+static size_t hash_table_open__find(HashTableOpen *t, int key, uint64_t h, OpenSlots **where) {
+    size_t slot = open_slots_find(&t->slots, key, h);
+    *where = &t->slots;
+    if (slot == SLOT_NOT_FOUND && hash_table_open__rehashing(t)) {
+        slot = open_slots_find(&t->old, key, h);
+        *where = &t->old;
+    }
+    return slot;
+}
+
+HashTableOpen* hash_table_open_create(size_t capacity) {
+    return hash_table_open_create_with_hash(capacity, NULL);
+}
+
+HashTableOpen* hash_table_open_create_with_hash(size_t capacity, HashFunction hash) {
+    HashTableOpen *t = (HashTableOpen*) malloc(sizeof(HashTableOpen));
+    check_alloc(t);
+    t->size = 0;
+    t->hash = hash;
+    t->mapped = false;
+    t->resizes = 0;
+    t->refs = 1;
+    t->min_capacity = hash_table_open__round_capacity(capacity);
+    t->migrate_group = 0;
+    open_slots_alloc(&t->slots, t->min_capacity);
+    memset(&t->old, 0, sizeof(OpenSlots));
+    return t;
+}
+
+HashTableOpen* hash_table_open_copy(HashTableOpen *t) {
+    HashTableOpen *copy = (HashTableOpen*) malloc(sizeof(HashTableOpen));
+    check_alloc(copy);
+    copy->size = t->size;
+    copy->min_capacity = t->min_capacity;
+    copy->migrate_group = t->migrate_group;
+    copy->hash = t->hash;
+    copy->mapped = false;
+    copy->resizes = t->resizes;
+    copy->refs = 1;
+    open_slots_copy(&copy->slots, &t->slots);
+    open_slots_copy(&copy->old, &t->old);
+    return copy;
+}
+
+// bring the first group probed by h to the cache
+static inline void hash_table_open__prefetch(HashTableOpen *t, uint64_t h) {
+    const OpenSlots *s = &t->slots;
+    size_t base = (hash_table_open__h1(h) & (s->capacity / GROUP_WIDTH - 1)) * GROUP_WIDTH;
+    __builtin_prefetch(s->ctrl + base);
+    __builtin_prefetch(s->keys + base);
+    __builtin_prefetch(s->values + base);
+}
+
+static void hash_table_open__check_writable(HashTableOpen *t) {
+    if (t->mapped) {
+        printf("hash_table_open: read-only table, write on a copy\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static bool hash_table_open__put(HashTableOpen *t, int key, int value, uint64_t h) {
+    hash_table_open__check_writable(t);
+    hash_table_open__rehash_step(t, HASH_TABLE_OPEN_REHASH_STEP);
+
+    OpenSlots *where;
+    size_t slot = hash_table_open__find(t, key, h, &where);
+    if (slot != SLOT_NOT_FOUND) {
+        where->values[slot] = value;
+        return false;
+    }
+
+    slot = open_slots_find_free(&t->slots, h);
+    if (t->slots.growth_left == 0 && t->slots.ctrl[slot] == CTRL_EMPTY) {
+        // double when crowded, otherwise only drop the tombstones
+        size_t capacity = t->slots.capacity;
+        if (t->size + 1 > capacity * HASH_TABLE_OPEN_MAX_LOAD_NUM / (2 * HASH_TABLE_OPEN_MAX_LOAD_DEN)) {
+            capacity <<= 1;
+        }
+        hash_table_open__rehash(t, capacity);
+        slot = open_slots_find_free(&t->slots, h);
+    }
+    open_slots_set(&t->slots, slot, h, key, value);
+    t->size++;
+    return true;
+}
+
+bool hash_table_open_put(HashTableOpen *t, int key, int value) {
+    return hash_table_open__put(t, key, value, hash_table_open__hash(t, key));
+}
+
+size_t hash_table_open_put_many(HashTableOpen *t, const int *keys, const int *values, size_t n) {
+    uint64_t hashes[HASH_TABLE_BATCH];
+    size_t added = 0;
+    for (size_t base = 0; base < n; base += HASH_TABLE_BATCH) {
+        size_t m = n - base < HASH_TABLE_BATCH ? n - base : HASH_TABLE_BATCH;
+        for (size_t i = 0; i < m; i++) {
+            hashes[i] = hash_table_open__hash(t, keys[base + i]);
+            hash_table_open__prefetch(t, hashes[i]);
+        }
+        for (size_t i = 0; i < m; i++) {
+            added += hash_table_open__put(t, keys[base + i], values[base + i], hashes[i]);
+        }
+    }
+    return added;
+}
+
+bool hash_table_open_remove(HashTableOpen *t, int key) {
+    hash_table_open__check_writable(t);
+    hash_table_open__rehash_step(t, HASH_TABLE_OPEN_REHASH_STEP);
+
+    OpenSlots *where;
+    size_t slot = hash_table_open__find(t, key, hash_table_open__hash(t, key), &where);
+    if (slot == SLOT_NOT_FOUND) {
+        return false;
+    }
+    open_slots_erase(where, slot);
+    t->size--;
+
+    size_t capacity = t->slots.capacity;
+    if (!hash_table_open__rehashing(t) && capacity > t->min_capacity
+        && t->size < capacity / HASH_TABLE_OPEN_MIN_LOAD_DEN) {
+        hash_table_open__rehash(t, capacity >> 1);
+    }
+    return true;
+}
+
+int hash_table_open_get(HashTableOpen *t, int key, bool *exists) {
+    OpenSlots *where;
+    size_t slot = hash_table_open__find(t, key, hash_table_open__hash(t, key), &where);
+    if (exists != NULL) {
+        *exists = slot != SLOT_NOT_FOUND;
+    }
+    if (slot == SLOT_NOT_FOUND) {
+        return -1;
+    }
+    return where->values[slot];
+}
+
+size_t hash_table_open_get_many(HashTableOpen *t, const int *keys, size_t n, int *values, bool *exists) {
+    uint64_t hashes[HASH_TABLE_BATCH];
+    size_t found = 0;
+    for (size_t base = 0; base < n; base += HASH_TABLE_BATCH) {
+        size_t m = n - base < HASH_TABLE_BATCH ? n - base : HASH_TABLE_BATCH;
+        for (size_t i = 0; i < m; i++) {
+            hashes[i] = hash_table_open__hash(t, keys[base + i]);
+            hash_table_open__prefetch(t, hashes[i]);
+        }
+        for (size_t i = 0; i < m; i++) {
+            OpenSlots *where;
+            size_t slot = hash_table_open__find(t, keys[base + i], hashes[i], &where);
+            if (values != NULL) {
+                values[base + i] = slot != SLOT_NOT_FOUND ? where->values[slot] : -1;
+            }
+            if (exists != NULL) {
+                exists[base + i] = slot != SLOT_NOT_FOUND;
+            }
+            found += slot != SLOT_NOT_FOUND;
+        }
+    }
+    return found;
+}
+
+size_t hash_table_open_size(HashTableOpen *t) {
+    return t->size;
+}
+
+size_t hash_table_open_capacity(HashTableOpen *t) {
+    return t->slots.capacity + t->old.capacity;
+}
+
+bool hash_table_open_rehashing(HashTableOpen *t) {
+    return hash_table_open__rehashing(t);
+}
+
+size_t hash_table_open_resizes(HashTableOpen *t) {
+    return t->resizes;
+}
+
+size_t hash_table_open_bytes(HashTableOpen *t) {
+    size_t slot_bytes = sizeof(int8_t) + 2 * sizeof(int);
+    return sizeof(HashTableOpen) + (t->slots.capacity + t->old.capacity) * slot_bytes;
+}
+
+// groups visited by a lookup of h before reaching the group of slot
+static size_t open_slots_probe_length(const OpenSlots *s, uint64_t h, size_t slot) {
+    size_t mask = s->capacity / GROUP_WIDTH - 1;
+    size_t g = hash_table_open__h1(h) & mask;
+    size_t step = 0;
+    while (g != slot / GROUP_WIDTH) {
+        g = (g + step + 1) & mask;
+        step++;
+    }
+    return step;
+}
+
+size_t hash_table_open_probe_lengths(HashTableOpen *t, size_t *histogram, size_t bins, size_t *total) {
+    const OpenSlots *generations[2] = {&t->slots, &t->old};
+    size_t max = 0;
+    size_t sum = 0;
+    for (int k = 0; k < 2; k++) {
+        const OpenSlots *s = generations[k];
+        for (size_t i = 0; i < s->capacity; i++) {
+            if (s->ctrl[i] < 0) {
+                continue;
+            }
+            size_t length = open_slots_probe_length(s, hash_table_open__hash(t, s->keys[i]), i);
+            histogram[length < bins ? length : bins - 1]++;
+            max = length > max ? length : max;
+            sum += length;
+        }
+    }
+    if (total != NULL) {
+        *total = sum;
+    }
+    return max;
+}
+
+bool hash_table_open_slot(HashTableOpen *t, size_t i, int *key, int *value) {
+    const OpenSlots *s = &t->slots;
+    if (i >= s->capacity) {
+        i -= s->capacity;
+        s = &t->old;
+    }
+    if (s->ctrl[i] < 0) {
+        return false;
+    }
+    if (key != NULL) {
+        *key = s->keys[i];
+    }
+    if (value != NULL) {
+        *value = s->values[i];
+    }
+    return true;
+}
+
+HashTableOpen* hash_table_open_map(const void *slots, size_t capacity, size_t size) {
+    HashTableOpen *t = (HashTableOpen*) malloc(sizeof(HashTableOpen));
+    check_alloc(t);
+    t->size = size;
+    t->min_capacity = capacity;
+    t->migrate_group = 0;
+    t->hash = NULL;
+    t->mapped = true;
+    t->resizes = 0;
+    t->refs = 1;
+    t->slots.capacity = capacity;
+    // no tombstones in a saved table: what a copy may still insert
+    t->slots.growth_left = capacity * HASH_TABLE_OPEN_MAX_LOAD_NUM / HASH_TABLE_OPEN_MAX_LOAD_DEN - size;
+    t->slots.ctrl = (int8_t*) slots;
+    t->slots.keys = (int*) (t->slots.ctrl + capacity);
+    t->slots.values = t->slots.keys + capacity;
+    memset(&t->old, 0, sizeof(OpenSlots));
+    return t;
+}
+
+void hash_table_open_arrays(HashTableOpen *t, const int8_t **ctrl, const int **keys, const int **values) {
+    assert(!hash_table_open__rehashing(t) && "hash table being rehashed");
+    *ctrl = t->slots.ctrl;
+    *keys = t->slots.keys;
+    *values = t->slots.values;
+}
+
+HashTableOpen* hash_table_open_share(HashTableOpen *t) {
+    __atomic_add_fetch(&t->refs, 1, __ATOMIC_RELAXED);
+    return t;
+}
+
+bool hash_table_open_shared(HashTableOpen *t) {
+    return __atomic_load_n(&t->refs, __ATOMIC_ACQUIRE) > 1;
+}
+
+void hash_table_open_free(HashTableOpen *t) {
+    if (__atomic_sub_fetch(&t->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+    if (t->mapped) {
+        free(t);
+        return;
+    }
+    open_slots_release(&t->slots);
+    open_slots_release(&t->old);
+    free(t);
+}
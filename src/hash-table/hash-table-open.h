@@ -0,0 +1,263 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef HASH_TABLE_OPEN_H
+#define HASH_TABLE_OPEN_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../utils/hash.h"
+
+/**
+ * @brief Number of slots probed at once by the open addressing engine.
+ *
+ * Each group of slots has one control byte per slot, so a whole group
+ * can be compared against a hash fragment with a single SSE2 instruction.
+ */
+#define HASH_TABLE_OPEN_GROUP_WIDTH 16
+
+/**
+ * @brief Maximum load factor of the open addressing engine (7/8).
+ */
+#define HASH_TABLE_OPEN_MAX_LOAD_NUM 7
+#define HASH_TABLE_OPEN_MAX_LOAD_DEN 8
+
+/**
+ * @brief The table shrinks when less than 1/16 of its slots are used.
+ */
+#define HASH_TABLE_OPEN_MIN_LOAD_DEN 16
+
+/**
+ * @brief Groups of slots migrated by each put/remove during a rehash.
+ */
+#ifndef HASH_TABLE_OPEN_REHASH_STEP
+#define HASH_TABLE_OPEN_REHASH_STEP 2
+#endif
+
+/**
+ * @brief An open addressing hash table of int -> int.
+ *
+ * Keys and values are stored inline in flat arrays, without any node
+ * allocation. A parallel array of control bytes holds 7 bits of the hash
+ * of every occupied slot (or a marker for empty/deleted slots). Lookups
+ * probe groups of HASH_TABLE_OPEN_GROUP_WIDTH control bytes at once and
+ * only touch the key array for slots whose fragment matches.
+ *
+ * The table grows when its load factor reaches 7/8 and shrinks when it
+ * falls under 1/16. Resizes are incremental: the previous generation of
+ * slots is kept alongside the new one and a few groups are migrated on
+ * each put/remove, so no single operation pays the whole rehash.
+ *
+ * This is the engine behind HASH_TABLE_OPEN_ADDRESSING tables, see
+ * hash_table_create_with_type().
+ */
+typedef struct HashTableOpen HashTableOpen;
+
+/**
+ * @brief Create a new open addressing hash table
+ * @param capacity hint of the expected number of elements
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTableOpen* hash_table_open_create(size_t capacity);
+
+/**
+ * @brief Create a new open addressing hash table with a custom hash function
+ *
+ * The top 57 bits of the hash select the first group to probe and the low
+ * 7 bits are stored in the control bytes, see HashFunction.
+ * @param capacity hint of the expected number of elements
+ * @param hash hash function of the keys, NULL for hash_mix()
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTableOpen* hash_table_open_create_with_hash(size_t capacity, HashFunction hash);
+
+/**
+ * @brief Create a open addressing hash table as copy of another
+ * @param t hash table to copy
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTableOpen* hash_table_open_copy(HashTableOpen *t);
+
+/**
+ * @brief Put a value associated to a key
+ * @param t hash table pointer
+ * @param key integer key
+ * @param value integer value to store
+ * @return true if the key is new, false if an existing value was updated
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_open_put(HashTableOpen *t, int key, int value);
+
+/**
+ * @brief Remove the value associated with a given key
+ * @param t hash table pointer
+ * @param key integer key
+ * @return true if the key was present, false otherwise
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_open_remove(HashTableOpen *t, int key);
+
+/**
+ * @brief Get a value in the hash table
+ * @param t hash table pointer
+ * @param key integer key
+ * @param exists bool pointer, set true if found false otherwise; null pointer does nothing
+ * @return the value or -1 if the key does not exist
+ * @ingroup DataStructureMethods
+ */
+int hash_table_open_get(HashTableOpen *t, int key, bool *exists);
+
+/**
+ * @brief Get the values of an array of keys, see hash_table_get_many()
+ * @param t hash table pointer
+ * @param keys array of n keys
+ * @param n number of keys
+ * @param values output array of n values, -1 for missing keys; may be NULL
+ * @param exists output array of n flags; may be NULL
+ * @return the number of keys found
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_get_many(HashTableOpen *t, const int *keys, size_t n, int *values, bool *exists);
+
+/**
+ * @brief Put an array of pairs, see hash_table_put_many()
+ * @param t hash table pointer
+ * @param keys array of n keys
+ * @param values array of n values
+ * @param n number of pairs
+ * @return the number of new keys
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_put_many(HashTableOpen *t, const int *keys, const int *values, size_t n);
+
+/**
+ * @brief Get the number of elements in the hash table
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_size(HashTableOpen *t);
+
+/**
+ * @brief Get the number of slots of the hash table
+ *
+ * During a rehash this includes the slots of the generation being migrated.
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_capacity(HashTableOpen *t);
+
+/**
+ * @brief Check if an incremental rehash is in progress
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_open_rehashing(HashTableOpen *t);
+
+/**
+ * @brief Get the number of rehashes started since the creation of the table
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_resizes(HashTableOpen *t);
+
+/**
+ * @brief Get the memory used by the hash table, in bytes
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_bytes(HashTableOpen *t);
+
+/**
+ * @brief Count the pairs of the hash table by probe length
+ *
+ * The probe length of a pair is the number of groups a lookup of its key
+ * visits before the group holding it: 0 when it is in its home group.
+ * @param t hash table pointer
+ * @param histogram array of bins counters, incremented; the last bin counts the longer probes
+ * @param bins number of bins, at least 1
+ * @param total output of the sum of the probe lengths (may be NULL)
+ * @return the longest probe length
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_open_probe_lengths(HashTableOpen *t, size_t *histogram, size_t bins, size_t *total);
+
+/**
+ * @brief Read the slot \p i of the hash table
+ * @param t hash table pointer
+ * @param i slot index, less than hash_table_open_capacity()
+ * @param key output of the slot key (may be NULL)
+ * @param value output of the slot value (may be NULL)
+ * @return true if the slot is occupied, false otherwise
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_open_slot(HashTableOpen *t, size_t i, int *key, int *value);
+
+/**
+ * @brief Create a read-only hash table over slots stored elsewhere
+ *
+ * The slots are laid out as hash_table_open_arrays() gives them, one after
+ * the other: capacity control bytes, capacity keys, then capacity values,
+ * hashed by hash_mix(). They are read in place, e.g. from a memory-mapped
+ * file, and are not freed with the table. Puts and removes are refused;
+ * hash_table_open_copy() gives a writable table.
+ * @param slots control bytes followed by the keys and the values
+ * @param capacity number of slots, a power of two multiple of HASH_TABLE_OPEN_GROUP_WIDTH
+ * @param size number of occupied slots
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTableOpen* hash_table_open_map(const void *slots, size_t capacity, size_t size);
+
+/**
+ * @brief Get the flat arrays of the hash table
+ *
+ * The table must not be rehashing, e.g. filled after a
+ * hash_table_open_create() with the expected number of elements.
+ * @param t hash table pointer
+ * @param ctrl output of the hash_table_open_capacity() control bytes
+ * @param keys output of the keys of the slots
+ * @param values output of the values of the slots
+ * @ingroup DataStructureMethods
+ */
+void hash_table_open_arrays(HashTableOpen *t, const int8_t **ctrl, const int **keys, const int **values);
+
+/**
+ * @brief Take a reference to a hash table shared by several owners
+ *
+ * The table must not be written while shared, see hash_table_open_shared():
+ * owners copy it with hash_table_open_copy() before their first write.
+ * Each reference is dropped by hash_table_open_free().
+ * @param t hash table pointer
+ * @return t
+ * @ingroup DataStructureMethods
+ */
+HashTableOpen* hash_table_open_share(HashTableOpen *t);
+
+/**
+ * @brief Check if the hash table has more than one owner
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_open_shared(HashTableOpen *t);
+
+/**
+ * @brief Free memory of the hash table, once its last owner frees it
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+void hash_table_open_free(HashTableOpen *t);
+
+#endif /* HASH_TABLE_OPEN_H */
@@ -0,0 +1,295 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "hash-table-perfect.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+#define PILOTS (1 << 16)  // pilots tried per bucket, they must fit in uint16_t
+#define MAX_SEEDS 64      // the construction restarts with a new seed on failure
+
+typedef struct PerfectPair {
+    int key;
+    int value;
+} PerfectPair;
+
+struct HashTablePerfect {
+    size_t size;        // number of keys n
+    size_t n_buckets;   // buckets of about HASH_TABLE_PERFECT_BUCKET_SIZE keys
+    size_t n_slots;     // slots addressed by the pilots, a bit more than n
+    uint64_t seed;
+    uint16_t *pilots;   // pilot of each bucket
+    uint32_t *remap;    // slot under n of each slot n + i used by a key
+    PerfectPair *pairs; // n pairs, indexed by the perfect hash of the key
+};
+
+// pair remembering its position in the input, to keep the last repeated key
+typedef struct PerfectInput {
+    int key;
+    int value;
+    size_t order;
+} PerfectInput;
+
+static int perfect_input_compare(const void *a, const void *b) {
+    const PerfectInput *x = (const PerfectInput*) a;
+    const PerfectInput *y = (const PerfectInput*) b;
+    if (x->key != y->key) {
+        return x->key < y->key ? -1 : 1;
+    }
+    return x->order < y->order ? -1 : x->order > y->order;
+}
+
+static inline uint64_t hash_table_perfect__hash(const HashTablePerfect *t, int key) {
+    return hash_mix64(t->seed ^ (uint32_t) key);
+}
+
+static inline size_t hash_table_perfect__bucket(const HashTablePerfect *t, uint64_t h) {
+    return hash_range((uint32_t)(h >> 32), (uint32_t) t->n_buckets);
+}
+
+static inline uint64_t hash_table_perfect__pilot_hash(const HashTablePerfect *t, uint16_t pilot) {
+    return hash_mix64(t->seed ^ pilot);
+}
+
+static inline size_t hash_table_perfect__position(const HashTablePerfect *t, uint64_t h, uint64_t pilot_hash) {
+    return hash_range((uint32_t)(h ^ pilot_hash), (uint32_t) t->n_slots);
+}
+
+// bitset of the slots taken during the construction, small enough to stay
+// in the cache while the pilots are searched
+static inline bool slot_taken(const uint64_t *taken, size_t p) {
+    return (taken[p / 64] >> (p % 64)) & 1;
+}
+
+static inline void slot_take(uint64_t *taken, size_t p) {
+    taken[p / 64] |= (uint64_t) 1 << (p % 64);
+}
+
+// search a pilot for every bucket, from the largest to the smallest;
+// false if some bucket has no pilot sending its keys to free slots
+static bool hash_table_perfect__place(HashTablePerfect *t, const uint64_t *hashes, uint64_t *taken) {
+    size_t n = t->size;
+    // counting sort of the keys by bucket
+    size_t *start = (size_t*) calloc(t->n_buckets + 1, sizeof(size_t));
+    size_t *by_bucket = (size_t*) malloc(n * sizeof(size_t));
+    check_alloc(start);
+    check_alloc(by_bucket);
+    for (size_t i = 0; i < n; i++) {
+        start[hash_table_perfect__bucket(t, hashes[i]) + 1]++;
+    }
+    size_t max_size = 0;
+    for (size_t b = 0; b < t->n_buckets; b++) {
+        max_size = start[b + 1] > max_size ? start[b + 1] : max_size;
+        start[b + 1] += start[b];
+    }
+    size_t *fill = (size_t*) malloc(t->n_buckets * sizeof(size_t));
+    check_alloc(fill);
+    memcpy(fill, start, t->n_buckets * sizeof(size_t));
+    for (size_t i = 0; i < n; i++) {
+        by_bucket[fill[hash_table_perfect__bucket(t, hashes[i])]++] = i;
+    }
+
+    // counting sort of the buckets by decreasing size
+    size_t *size_start = (size_t*) calloc(max_size + 2, sizeof(size_t));
+    size_t *order = (size_t*) malloc(t->n_buckets * sizeof(size_t));
+    check_alloc(size_start);
+    check_alloc(order);
+    for (size_t b = 0; b < t->n_buckets; b++) {
+        size_start[max_size - (start[b + 1] - start[b]) + 1]++;
+    }
+    for (size_t s = 0; s <= max_size; s++) {
+        size_start[s + 1] += size_start[s];
+    }
+    for (size_t b = 0; b < t->n_buckets; b++) {
+        order[size_start[max_size - (start[b + 1] - start[b])]++] = b;
+    }
+
+    size_t *positions = (size_t*) malloc((max_size + 1) * sizeof(size_t));
+    check_alloc(positions);
+    bool placed = true;
+    for (size_t k = 0; k < t->n_buckets && placed; k++) {
+        size_t b = order[k];
+        size_t bucket_size = start[b + 1] - start[b];
+        if (bucket_size == 0) {
+            break; // empty buckets come last, their pilot is never read
+        }
+        placed = false;
+        for (uint32_t pilot = 0; pilot < PILOTS && !placed; pilot++) {
+            uint64_t pilot_hash = hash_table_perfect__pilot_hash(t, (uint16_t) pilot);
+            placed = true;
+            for (size_t j = 0; j < bucket_size && placed; j++) {
+                size_t p = hash_table_perfect__position(t, hashes[by_bucket[start[b] + j]], pilot_hash);
+                placed = !slot_taken(taken, p);
+                for (size_t i = 0; i < j && placed; i++) {
+                    placed = positions[i] != p;
+                }
+                positions[j] = p;
+            }
+            if (placed) {
+                t->pilots[b] = (uint16_t) pilot;
+                for (size_t j = 0; j < bucket_size; j++) {
+                    slot_take(taken, positions[j]);
+                }
+            }
+        }
+    }
+
+    free(start);
+    free(by_bucket);
+    free(fill);
+    free(size_start);
+    free(order);
+    free(positions);
+    return placed;
+}
+
+// build over distinct keys, retrying with other seeds until every bucket is placed
+static void hash_table_perfect__build(HashTablePerfect *t, const PerfectInput *input) {
+    size_t n = t->size;
+    uint64_t *hashes = (uint64_t*) malloc(n * sizeof(uint64_t));
+    size_t taken_words = t->n_slots / 64 + 1;
+    uint64_t *taken = (uint64_t*) malloc(taken_words * sizeof(uint64_t));
+    check_alloc(hashes);
+    check_alloc(taken);
+
+    bool placed = false;
+    for (uint64_t attempt = 1; attempt <= MAX_SEEDS && !placed; attempt++) {
+        t->seed = hash_mix64(attempt);
+        for (size_t i = 0; i < n; i++) {
+            hashes[i] = hash_table_perfect__hash(t, input[i].key);
+        }
+        memset(taken, 0, taken_words * sizeof(uint64_t));
+        memset(t->pilots, 0, t->n_buckets * sizeof(uint16_t));
+        placed = hash_table_perfect__place(t, hashes, taken);
+    }
+    if (!placed) {
+        printf("hash_table_perfect: no perfect hash found for %zu keys\n", n);
+        exit(EXIT_FAILURE);
+    }
+
+    // fill the holes under n with the slots used past n
+    size_t hole = 0;
+    for (size_t p = n; p < t->n_slots; p++) {
+        if (slot_taken(taken, p)) {
+            while (slot_taken(taken, hole)) {
+                hole++;
+            }
+            t->remap[p - n] = (uint32_t) hole++;
+        }
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        uint16_t pilot = t->pilots[hash_table_perfect__bucket(t, hashes[i])];
+        size_t p = hash_table_perfect__position(t, hashes[i], hash_table_perfect__pilot_hash(t, pilot));
+        p = p < n ? p : t->remap[p - n];
+        t->pairs[p].key = input[i].key;
+        t->pairs[p].value = input[i].value;
+    }
+
+    free(hashes);
+    free(taken);
+}
+
+HashTablePerfect* hash_table_perfect_create(const int *keys, const int *values, size_t n) {
+    // sort by key to drop repeated keys, keeping the last one
+    PerfectInput *input = (PerfectInput*) malloc((n > 0 ? n : 1) * sizeof(PerfectInput));
+    check_alloc(input);
+    for (size_t i = 0; i < n; i++) {
+        input[i].key = keys[i];
+        input[i].value = values[i];
+        input[i].order = i;
+    }
+    qsort(input, n, sizeof(PerfectInput), perfect_input_compare);
+    size_t size = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i + 1 < n && input[i + 1].key == input[i].key) {
+            continue;
+        }
+        input[size++] = input[i];
+    }
+
+    HashTablePerfect *t = (HashTablePerfect*) malloc(sizeof(HashTablePerfect));
+    check_alloc(t);
+    t->size = size;
+    t->n_buckets = size / HASH_TABLE_PERFECT_BUCKET_SIZE + 1;
+    t->n_slots = size + size / 50 + 1;
+    t->seed = 0;
+    t->pilots = (uint16_t*) calloc(t->n_buckets, sizeof(uint16_t));
+    t->remap = (uint32_t*) calloc(t->n_slots - size, sizeof(uint32_t));
+    t->pairs = (PerfectPair*) malloc((size > 0 ? size : 1) * sizeof(PerfectPair));
+    check_alloc(t->pilots);
+    check_alloc(t->remap);
+    check_alloc(t->pairs);
+    if (size > 0) {
+        hash_table_perfect__build(t, input);
+    }
+    free(input);
+    return t;
+}
+
+HashTablePerfect* hash_table_perfect_from_hash_table(HashTable *ht) {
+    size_t n = hash_table_size(ht);
+    int *keys = (int*) malloc((n > 0 ? n : 1) * sizeof(int));
+    int *values = (int*) malloc((n > 0 ? n : 1) * sizeof(int));
+    check_alloc(keys);
+    check_alloc(values);
+    size_t i = 0;
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        keys[i] = c.key;
+        values[i++] = c.value;
+    }
+    HashTablePerfect *t = hash_table_perfect_create(keys, values, n);
+    free(keys);
+    free(values);
+    return t;
+}
+
+int hash_table_perfect_get(HashTablePerfect *t, int key, bool *exists) {
+    bool found = false;
+    int value = -1;
+    if (t->size > 0) {
+        uint64_t h = hash_table_perfect__hash(t, key);
+        uint16_t pilot = t->pilots[hash_table_perfect__bucket(t, h)];
+        size_t p = hash_table_perfect__position(t, h, hash_table_perfect__pilot_hash(t, pilot));
+        p = p < t->size ? p : t->remap[p - t->size];
+        found = t->pairs[p].key == key;
+        value = found ? t->pairs[p].value : -1;
+    }
+    if (exists != NULL) {
+        *exists = found;
+    }
+    return value;
+}
+
+size_t hash_table_perfect_size(HashTablePerfect *t) {
+    return t->size;
+}
+
+double hash_table_perfect_bits_per_key(HashTablePerfect *t) {
+    if (t->size == 0) {
+        return 0;
+    }
+    size_t bits = t->n_buckets * 16 + (t->n_slots - t->size) * 32;
+    return (double) bits / t->size;
+}
+
+void hash_table_perfect_free(HashTablePerfect *t) {
+    free(t->pilots);
+    free(t->remap);
+    free(t->pairs);
+    free(t);
+}
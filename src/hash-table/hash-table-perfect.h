@@ -0,0 +1,103 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef HASH_TABLE_PERFECT_H
+#define HASH_TABLE_PERFECT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "hash-table.h"
+
+/**
+ * @brief Average number of keys per bucket of the perfect hash.
+ *
+ * Each bucket stores a 16-bit pilot, so the hash function takes about
+ * 16 / HASH_TABLE_PERFECT_BUCKET_SIZE bits per key. Larger buckets use
+ * less memory but are harder to place.
+ */
+#ifndef HASH_TABLE_PERFECT_BUCKET_SIZE
+#define HASH_TABLE_PERFECT_BUCKET_SIZE 5
+#endif
+
+/**
+ * @brief An immutable hash table of int -> int over a minimal perfect hash.
+ *
+ * Built once from a fixed set of keys, it maps each of the n keys to its
+ * own slot in [0, n) with no collision, so the pairs are stored in a flat
+ * array without any empty slot, chain or probe.
+ *
+ * The construction follows CHD/PTHash: keys are split into buckets of about
+ * HASH_TABLE_PERFECT_BUCKET_SIZE keys and, from the largest bucket to the
+ * smallest, each bucket searches a pilot value that sends all of its keys
+ * to free slots. Slots are over-provisioned by 2% to make the search easy;
+ * the few keys landing past n are remapped to the holes under n.
+ *
+ * A lookup reads the pilot of the bucket of the key and then its pair,
+ * which is compared against the key: absent keys are reported as such.
+ * The hash function takes about 3.8 bits per key.
+ */
+typedef struct HashTablePerfect HashTablePerfect;
+
+/**
+ * @brief Build a perfect hash table from arrays of pairs
+ *
+ * Repeated keys keep the value of their last occurrence, as a sequence of
+ * hash_table_put() would do.
+ * @param keys array of n keys
+ * @param values array of n values
+ * @param n number of pairs, less than 2^32
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTablePerfect* hash_table_perfect_create(const int *keys, const int *values, size_t n);
+
+/**
+ * @brief Build a perfect hash table with the pairs of a hash table
+ * @param ht hash table pointer, not modified
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTablePerfect* hash_table_perfect_from_hash_table(HashTable *ht);
+
+/**
+ * @brief Get a value in the hash table
+ * @param t hash table pointer
+ * @param key integer key
+ * @param exists bool pointer, set true if found false otherwise; null pointer does nothing
+ * @return the value or -1 if the key does not exist
+ * @ingroup DataStructureMethods
+ */
+int hash_table_perfect_get(HashTablePerfect *t, int key, bool *exists);
+
+/**
+ * @brief Get the number of elements in the hash table
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_perfect_size(HashTablePerfect *t);
+
+/**
+ * @brief Get the memory used by the hash function, besides the pairs
+ * @param t hash table pointer
+ * @return bits per key of the pilots and remap arrays
+ * @ingroup DataStructureMethods
+ */
+double hash_table_perfect_bits_per_key(HashTablePerfect *t);
+
+/**
+ * @brief Free memory of the hash table
+ * @param t hash table pointer
+ * @ingroup DataStructureMethods
+ */
+void hash_table_perfect_free(HashTablePerfect *t);
+
+#endif /* HASH_TABLE_PERFECT_H */
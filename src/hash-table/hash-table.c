@@ -1,36 +1,477 @@
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "hash-table.h"
+#include "hash-table-open.h"
+#include "../filter/bloom-filter.h"
+#include "../filter/cuckoo-filter.h"
 #include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+// a chunk of buckets, shared by copies of a table until one of them
+// writes to it; the nodes of its chains belong to the chunk and the
+// chunk_size bucket heads are allocated right after it
+typedef struct BucketChunk {
+    size_t refs;   // atomic, number of bucket arrays pointing to the chunk
+} BucketChunk;
+
+// one generation of buckets, shared by copies of a table in the same way
+typedef struct Buckets {
+    size_t refs;          // atomic, number of tables pointing to the array
+    size_t n_buckets;     // always a power of two
+    size_t chunk_size;    // HASH_TABLE_COW_CHUNK, or n_buckets if smaller
+    int chunk_bits;       // log2(chunk_size)
+} Buckets;
+
+// the heads of a chunk and the chunks of an array follow their header,
+// their addresses are computed instead of loaded on every lookup
+static inline List** chunk_heads(const BucketChunk *c) {
+    return (List**) (c + 1);
+}
+
+// NULL for the chunks never written, all empty
+static inline BucketChunk** buckets_chunks(const Buckets *b) {
+    return (BucketChunk**) (b + 1);
+}
+
+// head of the buckets of the chunks never written
+static List *const no_list = NULL;
+
+static Buckets* buckets_alloc(size_t n_buckets) {
+    size_t chunk_size = n_buckets < HASH_TABLE_COW_CHUNK ? n_buckets : HASH_TABLE_COW_CHUNK;
+    size_t n_chunks = n_buckets / chunk_size;
+    Buckets *b = (Buckets*) calloc(1, sizeof(Buckets) + n_chunks * sizeof(BucketChunk*));
+    check_alloc(b);
+    b->refs = 1;
+    b->n_buckets = n_buckets;
+    b->chunk_size = chunk_size;
+    b->chunk_bits = __builtin_ctzll(chunk_size);
+    return b;
+}
+
+static BucketChunk* bucket_chunk_alloc(size_t chunk_size) {
+    BucketChunk *c = (BucketChunk*) calloc(1, sizeof(BucketChunk) + chunk_size * sizeof(List*));
+    check_alloc(c);
+    c->refs = 1;
+    return c;
+}
+
+static bool shared(size_t *refs) {
+    return __atomic_load_n(refs, __ATOMIC_ACQUIRE) > 1;
+}
+
+static bool release(size_t *refs) {
+    return __atomic_sub_fetch(refs, 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+static void bucket_chunk_release(BucketChunk *c, size_t chunk_size) {
+    if (c != NULL && release(&c->refs)) {
+        for (size_t i = 0; i < chunk_size; i++) {
+            list_free(chunk_heads(c)[i]);
+        }
+        free(c);
+    }
+}
+
+static void buckets_release(Buckets *b) {
+    if (b != NULL && release(&b->refs)) {
+        for (size_t i = 0; i < b->n_buckets >> b->chunk_bits; i++) {
+            bucket_chunk_release(buckets_chunks(b)[i], b->chunk_size);
+        }
+        free(b);
+    }
+}
+
+static inline List* const* buckets_head(const Buckets *b, size_t i) {
+    const BucketChunk *c = buckets_chunks(b)[i >> b->chunk_bits];
+    return c != NULL ? &chunk_heads(c)[i & (b->chunk_size - 1)] : &no_list;
+}
+
+// head of the bucket i for a write: the array and the chunk holding the
+// bucket are first copied if shared, so the write is seen by this table only
+static List** buckets_own(Buckets **array, size_t i) {
+    Buckets *b = *array;
+    size_t n_chunks = b->n_buckets >> b->chunk_bits;
+    if (shared(&b->refs)) {
+        Buckets *own = buckets_alloc(b->n_buckets);
+        for (size_t k = 0; k < n_chunks; k++) {
+            BucketChunk *c = buckets_chunks(b)[k];
+            if (c != NULL) {
+                __atomic_add_fetch(&c->refs, 1, __ATOMIC_RELAXED);
+            }
+            buckets_chunks(own)[k] = c;
+        }
+        buckets_release(b);
+        *array = b = own;
+    }
+
+    BucketChunk **chunk = &buckets_chunks(b)[i >> b->chunk_bits];
+    if (*chunk == NULL) {
+        *chunk = bucket_chunk_alloc(b->chunk_size);
+    } else if (shared(&(*chunk)->refs)) {
+        BucketChunk *own = bucket_chunk_alloc(b->chunk_size);
+        for (size_t k = 0; k < b->chunk_size; k++) {
+            chunk_heads(own)[k] = list_copy(chunk_heads(*chunk)[k]);
+        }
+        bucket_chunk_release(*chunk, b->chunk_size);
+        *chunk = own;
+    }
+    return &chunk_heads(*chunk)[i & (b->chunk_size - 1)];
+}
+
+// memory of the array and of its chunks
+static size_t buckets_bytes(const Buckets *b) {
+    size_t n_chunks = b->n_buckets >> b->chunk_bits;
+    size_t bytes = sizeof(Buckets) + n_chunks * sizeof(BucketChunk*);
+    for (size_t k = 0; k < n_chunks; k++) {
+        if (buckets_chunks(b)[k] != NULL) {
+            bytes += sizeof(BucketChunk) + b->chunk_size * sizeof(List*);
+        }
+    }
+    return bytes;
+}
 
 struct HashTable {
+    HashTableType type;  // storage engine
     size_t size;   // number of pairs key->data inside of hash table
-    size_t n_buckets;    // size of buckets
-    List **buckets; // hash-indexed buckets to set pairs on int
+    Buckets *buckets;       // hash-indexed buckets to set pairs on int
+    size_t min_buckets;     // the table never shrinks below its initial size
+    Buckets *old_buckets;   // buckets being migrated, NULL when not rehashing
+    size_t rehash_index;    // next bucket of old_buckets to migrate
+    HashTableOpen *open; // flat storage, only for HASH_TABLE_OPEN_ADDRESSING
+    HashFunction hash;   // NULL for the default mixer
+    size_t mutations;    // puts and removes, to detect invalidated cursors
+    void *mapping;         // snapshot of hash_table_open_mmap(), NULL otherwise
+    size_t mapping_length; // bytes of the mapping
+    size_t resizes;        // rehashes started
+    HashTableFilter filter; // kind of filter kept in front of the table
+    BloomFilter *bloom;     // filter of the keys, for HASH_TABLE_FILTER_BLOOM
+    CuckooFilter *cuckoo;   // filter of the keys, for HASH_TABLE_FILTER_CUCKOO
+    size_t stale;           // keys removed since the Bloom filter was built
+#ifdef HASH_TABLE_COUNTERS
+    HashTableCounters counters;
+#endif
 };
 
-static unsigned int hash_int(int key, size_t n_buckets) {
-    if (key < 0) {
-        key = -key;
-    }
-    return (unsigned int)(key % n_buckets);
+#ifdef HASH_TABLE_COUNTERS
+#define HASH_TABLE_COUNT(ht, counter, n) ((ht)->counters.counter += (n))
+#else
+#define HASH_TABLE_COUNT(ht, counter, n) ((void) 0)
+#endif
+
+#define SNAPSHOT_MAGIC "DSHTABLE"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+// header of a snapshot file, followed by the slots of an open addressing table
+typedef struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order; // SNAPSHOT_BYTE_ORDER as stored by the saving machine
+    uint32_t int_size;   // bytes of a key or a value
+    uint32_t reserved;
+    uint64_t size;       // number of pairs
+    uint64_t capacity;   // number of slots
+    uint64_t checksum;   // of the slots
+    char padding[16];    // slots start 64 bytes in, aligned for the group loads
+} SnapshotHeader;
+
+// smallest capacity of a filter, so small tables do not rebuild it often
+#define FILTER_MIN_CAPACITY 64
+
+// bucket of key: the low bits of the hash, n_buckets is a power of two
+static inline size_t hash_table__index(HashTable *ht, int key, size_t n_buckets) {
+    return (size_t) hash_apply(ht->hash, key) & (n_buckets - 1);
 }
 
-HashTable* hash_table_create(size_t n_buckets) {
+HashTable* hash_table_create_with_hash(size_t n_buckets, HashTableType type, HashFunction hash) {
     HashTable *ht = (HashTable*) malloc(sizeof(HashTable));
     check_alloc(ht);
 
-    ht->n_buckets = n_buckets;
+    ht->type = type;
     ht->size = 0;
-    ht->buckets = (List**) calloc(n_buckets, sizeof(List*));
-    if (!ht->buckets) {
-        free(ht);
-        return NULL;
+    ht->buckets = NULL;
+    ht->open = NULL;
+    ht->hash = hash;
+    ht->mutations = 0;
+    ht->mapping = NULL;
+    ht->mapping_length = 0;
+    ht->resizes = 0;
+    ht->filter = HASH_TABLE_FILTER_NONE;
+    ht->bloom = NULL;
+    ht->cuckoo = NULL;
+    ht->stale = 0;
+#ifdef HASH_TABLE_COUNTERS
+    memset(&ht->counters, 0, sizeof(HashTableCounters));
+#endif
+    if (type == HASH_TABLE_OPEN_ADDRESSING) {
+        ht->open = hash_table_open_create_with_hash(n_buckets, hash);
+        return ht;
     }
+
+    ht->buckets = buckets_alloc(hash_round_pow2(n_buckets));
+    ht->min_buckets = ht->buckets->n_buckets;
+    ht->old_buckets = NULL;
+    ht->rehash_index = 0;
     return ht;
 }
 
+// migrate up to n_steps non-empty buckets of the old generation,
+// bounding also the number of empty buckets visited
+static void hash_table__rehash_step(HashTable *ht, size_t n_steps) {
+    if (ht->old_buckets == NULL) {
+        return;
+    }
+
+    size_t old_n_buckets = ht->old_buckets->n_buckets;
+    size_t empty_visits = n_steps * 10;
+    while (n_steps > 0 && ht->rehash_index < old_n_buckets) {
+        if (*buckets_head(ht->old_buckets, ht->rehash_index) == NULL) {
+            ht->rehash_index++;
+            if (--empty_visits == 0) {
+                break;
+            }
+            continue;
+        }
+        // relink the nodes, no allocation needed unless the chunks are shared
+        List **old = buckets_own(&ht->old_buckets, ht->rehash_index++);
+        List *node = *old;
+        while (node != NULL) {
+            List *next = node->next;
+            List **head = buckets_own(&ht->buckets, hash_table__index(ht, node->key, ht->buckets->n_buckets));
+            node->next = *head;
+            *head = node;
+            node = next;
+        }
+        *old = NULL;
+        n_steps--;
+    }
+
+    if (ht->rehash_index == old_n_buckets) {
+        buckets_release(ht->old_buckets);
+        ht->old_buckets = NULL;
+        ht->rehash_index = 0;
+    }
+}
+
+// start moving the pairs to a new generation of n_buckets
+static void hash_table__rehash(HashTable *ht, size_t n_buckets) {
+    while (ht->old_buckets != NULL) {
+        hash_table__rehash_step(ht, HASH_TABLE_REHASH_STEP);
+    }
+    ht->old_buckets = ht->buckets;
+    ht->rehash_index = 0;
+    ht->buckets = buckets_alloc(n_buckets);
+    ht->resizes++;
+}
+
+// grow or shrink according to the load factor
+static void hash_table__resize_if_needed(HashTable *ht) {
+    if (ht->old_buckets != NULL) {
+        return;
+    }
+    size_t n_buckets = ht->buckets->n_buckets;
+    if (ht->size > n_buckets * HASH_TABLE_MAX_LOAD) {
+        hash_table__rehash(ht, n_buckets * 2);
+    } else if (n_buckets > ht->min_buckets
+               && ht->size * HASH_TABLE_SHRINK_RATIO < n_buckets) {
+        n_buckets /= 2;
+        hash_table__rehash(ht, n_buckets > ht->min_buckets ? n_buckets : ht->min_buckets);
+    }
+}
+
+// find the node of key: in the new buckets or, during a rehash,
+// in a bucket of the old generation not migrated yet (then *in_old is set)
+static List* hash_table__search(HashTable *ht, int key, bool *in_old) {
+    size_t index = hash_table__index(ht, key, ht->buckets->n_buckets);
+    List *found = list_search_by_key(*buckets_head(ht->buckets, index), key);
+    bool old = false;
+    if (found == NULL && ht->old_buckets != NULL) {
+        index = hash_table__index(ht, key, ht->old_buckets->n_buckets);
+        found = list_search_by_key(*buckets_head(ht->old_buckets, index), key);
+        old = found != NULL;
+    }
+    if (in_old != NULL) {
+        *in_old = old;
+    }
+    return found;
+}
+
+// head of the bucket of key in a generation, private to ht for a write
+static List** hash_table__own_bucket(HashTable *ht, int key, bool in_old) {
+    Buckets **array = in_old ? &ht->old_buckets : &ht->buckets;
+    return buckets_own(array, hash_table__index(ht, key, (*array)->n_buckets));
+}
+
+// the open addressing engine is shared whole by copies: copy it before a write
+static void hash_table__own_open(HashTable *ht) {
+    if (hash_table_open_shared(ht->open)) {
+        HashTableOpen *own = hash_table_open_copy(ht->open);
+        hash_table_open_free(ht->open);
+        ht->open = own;
+    }
+}
+
+static void hash_table__free_filter(HashTable *ht) {
+    if (ht->bloom != NULL) {
+        bloom_filter_free(ht->bloom);
+    }
+    if (ht->cuckoo != NULL) {
+        cuckoo_filter_free(ht->cuckoo);
+    }
+    ht->bloom = NULL;
+    ht->cuckoo = NULL;
+}
+
+// build the filter from the keys of the table, with room for as many more
+static void hash_table__build_filter(HashTable *ht) {
+    hash_table__free_filter(ht);
+    size_t capacity = 2 * ht->size > FILTER_MIN_CAPACITY ? 2 * ht->size : FILTER_MIN_CAPACITY;
+    bool built = false;
+    while (!built) {
+        built = true;
+        if (ht->filter == HASH_TABLE_FILTER_BLOOM) {
+            ht->bloom = bloom_filter_create(capacity, BLOOM_FILTER_BITS_PER_KEY);
+        } else {
+            ht->cuckoo = cuckoo_filter_create(capacity);
+        }
+        HashTableCursor c = hash_table_cursor(ht);
+        while (built && hash_table_cursor_next(&c)) {
+            if (ht->bloom != NULL) {
+                bloom_filter_add(ht->bloom, c.key);
+            } else {
+                built = cuckoo_filter_add(ht->cuckoo, c.key);
+            }
+        }
+        if (!built) {
+            hash_table__free_filter(ht);
+            capacity *= 2;
+        }
+    }
+    ht->stale = 0;
+}
+
+// true when key is surely not in the table
+static inline bool hash_table__filter_rejects(HashTable *ht, int key) {
+    switch (ht->filter) {
+    case HASH_TABLE_FILTER_BLOOM:
+        return !bloom_filter_contains(ht->bloom, key);
+    case HASH_TABLE_FILTER_CUCKOO:
+        return !cuckoo_filter_contains(ht->cuckoo, key);
+    default:
+        return false;
+    }
+}
+
+// follow the insert of a new key, already in the table
+static void hash_table__filter_add(HashTable *ht, int key) {
+    if (ht->filter == HASH_TABLE_FILTER_BLOOM) {
+        if (bloom_filter_size(ht->bloom) < bloom_filter_capacity(ht->bloom)) {
+            bloom_filter_add(ht->bloom, key);
+        } else {
+            hash_table__build_filter(ht);
+        }
+    } else if (ht->filter == HASH_TABLE_FILTER_CUCKOO && !cuckoo_filter_add(ht->cuckoo, key)) {
+        hash_table__build_filter(ht);
+    }
+}
+
+// follow the removal of a key, rebuilding the filter once mostly stale or
+// much larger than the table
+static void hash_table__filter_remove(HashTable *ht, int key) {
+    if (ht->filter == HASH_TABLE_FILTER_BLOOM) {
+        if (++ht->stale > ht->size && ht->stale >= FILTER_MIN_CAPACITY) {
+            hash_table__build_filter(ht);
+        }
+    } else if (ht->filter == HASH_TABLE_FILTER_CUCKOO) {
+        cuckoo_filter_remove(ht->cuckoo, key);
+        size_t capacity = cuckoo_filter_capacity(ht->cuckoo);
+        if (capacity > FILTER_MIN_CAPACITY && ht->size * 8 < capacity) {
+            hash_table__build_filter(ht);
+        }
+    }
+}
+
+static size_t hash_table__filter_bytes(HashTable *ht) {
+    if (ht->bloom != NULL) {
+        return bloom_filter_bytes(ht->bloom);
+    }
+    return ht->cuckoo != NULL ? cuckoo_filter_bytes(ht->cuckoo) : 0;
+}
+
+HashTable* hash_table_create(size_t n_buckets) {
+    return hash_table_create_with_type(n_buckets, HASH_TABLE_DEFAULT_TYPE);
+}
+
+HashTable* hash_table_create_with_type(size_t n_buckets, HashTableType type) {
+    return hash_table_create_with_hash(n_buckets, type, NULL);
+}
+
+HashTableType hash_table_type(HashTable *ht) {
+    return ht->type;
+}
+
+HashTableCursor hash_table_cursor(HashTable *ht) {
+    HashTableCursor c = {ht, 0, SIZE_MAX, NULL, ht->mutations, 0, 0};
+    return c;
+}
+
+HashTableCursor hash_table_cursor_part(HashTable *ht, size_t part, size_t parts) {
+    size_t n;
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        n = hash_table_open_capacity(ht->open);
+    } else {
+        n = ht->buckets->n_buckets + (ht->old_buckets != NULL ? ht->old_buckets->n_buckets : 0);
+    }
+    HashTableCursor c = hash_table_cursor(ht);
+    c.index = n / parts * part + (part < n % parts ? part : n % parts);
+    c.end = c.index + n / parts + (part < n % parts);
+    return c;
+}
+
+bool hash_table_cursor_next(HashTableCursor *c) {
+    HashTable *ht = c->ht;
+    assert(c->mutations == ht->mutations && "hash table modified during a walk");
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        size_t capacity = hash_table_open_capacity(ht->open);
+        capacity = capacity < c->end ? capacity : c->end;
+        while (c->index < capacity) {
+            if (hash_table_open_slot(ht->open, c->index++, &c->key, &c->value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // new buckets first, then the old ones not migrated yet
+    size_t n_buckets = ht->buckets->n_buckets;
+    size_t old_n_buckets = ht->old_buckets != NULL ? ht->old_buckets->n_buckets : 0;
+    while (c->node == NULL) {
+        if (c->index >= c->end) {
+            return false;
+        } else if (c->index < n_buckets) {
+            c->node = *buckets_head(ht->buckets, c->index++);
+        } else if (c->index < n_buckets + old_n_buckets) {
+            c->node = *buckets_head(ht->old_buckets, c->index++ - n_buckets);
+        } else {
+            return false;
+        }
+    }
+    c->key = c->node->key;
+    c->value = c->node->data;
+    c->node = c->node->next;
+    return true;
+}
+
 bool hash_table_empty(HashTable *ht) {
     if (!ht) {
         return true;
@@ -41,61 +482,298 @@ bool hash_table_empty(HashTable *ht) {
 }
 
 HashTable* hash_table_copy(HashTable *ht) {
-    HashTable *ht_copy = hash_table_create(ht->n_buckets);
-    ht_copy->size = ht->size;
-    for (size_t i = 0; i < ht_copy->n_buckets; i++) {
-        ht_copy->buckets[i] = list_copy(ht->buckets[i]);
+    HashTable *ht_copy = (HashTable*) malloc(sizeof(HashTable));
+    check_alloc(ht_copy);
+    *ht_copy = *ht;
+    ht_copy->mutations = 0;
+    ht_copy->mapping = NULL;
+#ifdef HASH_TABLE_COUNTERS
+    memset(&ht_copy->counters, 0, sizeof(HashTableCounters));
+#endif
+    if (ht->bloom != NULL) {
+        ht_copy->bloom = bloom_filter_copy(ht->bloom);
+    }
+    if (ht->cuckoo != NULL) {
+        ht_copy->cuckoo = cuckoo_filter_copy(ht->cuckoo);
+    }
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        // a mapped snapshot is unmapped with ht: copy its slots now
+        ht_copy->open = ht->mapping != NULL ? hash_table_open_copy(ht->open) : hash_table_open_share(ht->open);
+        return ht_copy;
+    }
+
+    __atomic_add_fetch(&ht->buckets->refs, 1, __ATOMIC_RELAXED);
+    if (ht->old_buckets != NULL) {
+        __atomic_add_fetch(&ht->old_buckets->refs, 1, __ATOMIC_RELAXED);
     }
     return ht_copy;
 }
 
+void hash_table_use_filter(HashTable *ht, HashTableFilter filter) {
+    hash_table__free_filter(ht);
+    ht->filter = filter;
+    if (filter != HASH_TABLE_FILTER_NONE) {
+        hash_table__build_filter(ht);
+    }
+}
+
 void hash_table_put(HashTable *ht, int key, int value) {
-    unsigned int index = hash_int(key, ht->n_buckets);
+    ht->mutations++;
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        hash_table__own_open(ht);
+        bool inserted = hash_table_open_put(ht->open, key, value);
+        ht->size += inserted;
+        HASH_TABLE_COUNT(ht, put_inserts, inserted);
+        HASH_TABLE_COUNT(ht, put_updates, !inserted);
+        if (inserted) {
+            hash_table__filter_add(ht, key);
+        }
+        return;
+    }
 
-    List *found = list_search_by_key(ht->buckets[index], key);
+    hash_table__rehash_step(ht, HASH_TABLE_REHASH_STEP);
+    bool in_old;
+    bool found = hash_table__search(ht, key, &in_old) != NULL;
+    HASH_TABLE_COUNT(ht, put_inserts, !found);
+    HASH_TABLE_COUNT(ht, put_updates, found);
 
-    if (found != NULL) {
-        found->data = value;
+    // the node found may be shared with a copy: search it again once owned
+    List **bucket = hash_table__own_bucket(ht, key, in_old);
+    if (found) {
+        list_search_by_key(*bucket, key)->data = value;
     } else {
-        ht->buckets[index] = list_insert_with_key(ht->buckets[index], key, value);
+        *bucket = list_insert_with_key(*bucket, key, value);
         ht->size++;
+        hash_table__filter_add(ht, key);
+        hash_table__resize_if_needed(ht);
+    }
+}
+
+// groups are ranges of chunks of buckets, which open addressing does not have
+static void hash_table__check_groups(HashTable *ht) {
+    if (ht->type != HASH_TABLE_CHAINING) {
+        printf("hash_table: groups of buckets need a chaining table, see hash_table_create_with_type()\n");
+        exit(EXIT_FAILURE);
     }
 }
 
+size_t hash_table_group(HashTable *ht, int key, size_t n_groups) {
+    hash_table__check_groups(ht);
+    const Buckets *b = ht->buckets;
+    size_t n_chunks = b->n_buckets >> b->chunk_bits;
+    return (hash_table__index(ht, key, b->n_buckets) >> b->chunk_bits) * n_groups / n_chunks;
+}
+
+void hash_table_put_group(HashTable *ht, const int *keys, size_t n, int value) {
+    hash_table__check_groups(ht);
+    assert(ht->old_buckets == NULL && ht->filter == HASH_TABLE_FILTER_NONE);
+    size_t inserted = 0;
+    for (size_t i = 0; i < n; i++) {
+        List **bucket = buckets_own(&ht->buckets, hash_table__index(ht, keys[i], ht->buckets->n_buckets));
+        List *found = list_search_by_key(*bucket, keys[i]);
+        if (found != NULL) {
+            found->data = value;
+        } else {
+            *bucket = list_insert_with_key(*bucket, keys[i], value);
+            inserted++;
+        }
+    }
+    __atomic_add_fetch(&ht->size, inserted, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&ht->mutations, 1, __ATOMIC_RELAXED);
+}
+
 void hash_table_remove(HashTable *ht, int key) {
-    bool exists;
-    hash_table_get(ht, key, &exists);
-    if (!exists) {
+    ht->mutations++;
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        bool present = true;
+        if (hash_table_open_shared(ht->open)) {
+            // copy the shared engine only when there is a pair to remove
+            hash_table_open_get(ht->open, key, &present);
+            if (present) {
+                hash_table__own_open(ht);
+            }
+        }
+        bool removed = present && hash_table_open_remove(ht->open, key);
+        ht->size -= removed;
+        HASH_TABLE_COUNT(ht, remove_hits, removed);
+        HASH_TABLE_COUNT(ht, remove_misses, !removed);
+        if (removed) {
+            hash_table__filter_remove(ht, key);
+        }
         return;
     }
-    unsigned int index = hash_int(key, ht->n_buckets);
-    ht->buckets[index] = list_remove_by_key(ht->buckets[index], key);
+
+    hash_table__rehash_step(ht, HASH_TABLE_REHASH_STEP);
+    bool in_old;
+    bool found = hash_table__search(ht, key, &in_old) != NULL;
+    HASH_TABLE_COUNT(ht, remove_hits, found);
+    HASH_TABLE_COUNT(ht, remove_misses, !found);
+    if (!found) {
+        return;
+    }
+    List **bucket = hash_table__own_bucket(ht, key, in_old);
+    *bucket = list_remove_by_key(*bucket, key);
     ht->size--;
+    hash_table__filter_remove(ht, key);
+    hash_table__resize_if_needed(ht);
 }
 
 int hash_table_get(HashTable *ht, int key, bool *exists) {
-    unsigned int index = hash_int(key, ht->n_buckets);
-    List *l = ht->buckets[index];
-    while (l) {
-        if (l->key == key) {
+    bool found;
+    int value;
+    if (hash_table__filter_rejects(ht, key)) {
+        found = false;
+        value = -1;
+    } else if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        value = hash_table_open_get(ht->open, key, &found);
+    } else {
+        List *node = hash_table__search(ht, key, NULL);
+        found = node != NULL;
+        value = found ? node->data : -1;
+    }
+    HASH_TABLE_COUNT(ht, get_hits, found);
+    HASH_TABLE_COUNT(ht, get_misses, !found);
+    if (exists != NULL) {
+        *exists = found;
+    }
+    return value;
+}
+
+// index the buckets of a batch of keys and bring them to the cache,
+// first the bucket heads and then the first node of each chain
+static void hash_table__prefetch_batch(HashTable *ht, const int *keys, size_t m, List *const **heads) {
+    for (size_t i = 0; i < m; i++) {
+        heads[i] = buckets_head(ht->buckets, hash_table__index(ht, keys[i], ht->buckets->n_buckets));
+        __builtin_prefetch(heads[i]);
+    }
+    for (size_t i = 0; i < m; i++) {
+        __builtin_prefetch(*heads[i]);
+    }
+}
+
+// hash_table_get_many() on the engine, without the filter
+static void hash_table__get_many(HashTable *ht, const int *keys, size_t n, int *values, bool *exists) {
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        size_t hits = hash_table_open_get_many(ht->open, keys, n, values, exists);
+        HASH_TABLE_COUNT(ht, get_hits, hits);
+        HASH_TABLE_COUNT(ht, get_misses, n - hits);
+        (void) hits;
+        return;
+    }
+
+    List *const *heads[HASH_TABLE_BATCH];
+    for (size_t base = 0; base < n; base += HASH_TABLE_BATCH) {
+        size_t m = n - base < HASH_TABLE_BATCH ? n - base : HASH_TABLE_BATCH;
+        hash_table__prefetch_batch(ht, keys + base, m, heads);
+        for (size_t i = 0; i < m; i++) {
+            List *found = list_search_by_key(*heads[i], keys[base + i]);
+            if (found == NULL && ht->old_buckets != NULL) {
+                found = hash_table__search(ht, keys[base + i], NULL);
+            }
+            HASH_TABLE_COUNT(ht, get_hits, found != NULL);
+            HASH_TABLE_COUNT(ht, get_misses, found == NULL);
+            if (values != NULL) {
+                values[base + i] = found != NULL ? found->data : -1;
+            }
             if (exists != NULL) {
-                *exists = true;
+                exists[base + i] = found != NULL;
             }
-            return l->data;
         }
-        l = l->next;
     }
-    if (exists != NULL) {
-        *exists = false;
+}
+
+void hash_table_get_many(HashTable *ht, const int *keys, size_t n, int *values, bool *exists) {
+    if (ht->filter == HASH_TABLE_FILTER_NONE) {
+        hash_table__get_many(ht, keys, n, values, exists);
+        return;
+    }
+
+    // search in batches the keys accepted by the filter
+    int batch_keys[HASH_TABLE_BATCH];
+    int batch_values[HASH_TABLE_BATCH];
+    bool batch_exists[HASH_TABLE_BATCH];
+    size_t positions[HASH_TABLE_BATCH];
+    size_t m = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (hash_table__filter_rejects(ht, keys[i])) {
+            HASH_TABLE_COUNT(ht, get_misses, 1);
+            if (values != NULL) {
+                values[i] = -1;
+            }
+            if (exists != NULL) {
+                exists[i] = false;
+            }
+        } else {
+            positions[m] = i;
+            batch_keys[m++] = keys[i];
+        }
+        if (m == HASH_TABLE_BATCH || (i + 1 == n && m > 0)) {
+            hash_table__get_many(ht, batch_keys, m, batch_values, batch_exists);
+            for (size_t j = 0; j < m; j++) {
+                if (values != NULL) {
+                    values[positions[j]] = batch_values[j];
+                }
+                if (exists != NULL) {
+                    exists[positions[j]] = batch_exists[j];
+                }
+            }
+            m = 0;
+        }
+    }
+}
+
+void hash_table_put_many(HashTable *ht, const int *keys, const int *values, size_t n) {
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING && ht->filter != HASH_TABLE_FILTER_NONE) {
+        // the engine does not tell which keys were new to the filter
+        for (size_t i = 0; i < n; i++) {
+            hash_table_put(ht, keys[i], values[i]);
+        }
+        return;
+    }
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        hash_table__own_open(ht);
+        size_t inserted = hash_table_open_put_many(ht->open, keys, values, n);
+        ht->mutations += n;
+        ht->size += inserted;
+        HASH_TABLE_COUNT(ht, put_inserts, inserted);
+        HASH_TABLE_COUNT(ht, put_updates, n - inserted);
+        return;
+    }
+
+    // a put may resize the table: the prefetched buckets are only a hint
+    List *const *heads[HASH_TABLE_BATCH];
+    for (size_t base = 0; base < n; base += HASH_TABLE_BATCH) {
+        size_t m = n - base < HASH_TABLE_BATCH ? n - base : HASH_TABLE_BATCH;
+        hash_table__prefetch_batch(ht, keys + base, m, heads);
+        for (size_t i = 0; i < m; i++) {
+            hash_table_put(ht, keys[base + i], values[base + i]);
+        }
     }
-    return -1;
 }
 
 void hash_table_print(HashTable *ht) {
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        if (!list_empty(ht->buckets[i])) {
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        int key, value;
+        for (size_t i = 0; i < hash_table_open_capacity(ht->open); i++) {
+            if (hash_table_open_slot(ht->open, i, &key, &value)) {
+                printf("[%zu]: [%d->%d]\n", i, key, value);
+            }
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < ht->buckets->n_buckets; i++) {
+        List *bucket = *buckets_head(ht->buckets, i);
+        if (!list_empty(bucket)) {
             printf("[%zu]: ", i);
-            list_println(ht->buckets[i]);
+            list_println(bucket);
+        }
+    }
+    for (size_t i = 0; ht->old_buckets != NULL && i < ht->old_buckets->n_buckets; i++) {
+        List *bucket = *buckets_head(ht->old_buckets, i);
+        if (!list_empty(bucket)) {
+            printf("[old %zu]: ", i);
+            list_println(bucket);
         }
     }
 }
@@ -104,63 +782,169 @@ size_t hash_table_size(HashTable *ht) {
     return ht->size;
 }
 
+// histogram of the chain lengths of the buckets [from, n_buckets)
+static void hash_table__chain_lengths(const Buckets *b, size_t from, HashTableStats *stats, size_t *visits) {
+    for (size_t i = from; i < b->n_buckets; i++) {
+        size_t length = 0;
+        for (List *node = *buckets_head(b, i); node != NULL; node = node->next) {
+            length++;
+        }
+        stats->histogram[length < HASH_TABLE_STATS_BINS ? length : HASH_TABLE_STATS_BINS - 1]++;
+        stats->max_length = length > stats->max_length ? length : stats->max_length;
+        *visits += length * (length + 1) / 2; // finding every pair of the chain
+    }
+}
+
+HashTableStats hash_table_stats(HashTable *ht) {
+    HashTableStats stats;
+    memset(&stats, 0, sizeof(HashTableStats));
+    stats.type = ht->type;
+    stats.size = ht->size;
+#ifdef HASH_TABLE_COUNTERS
+    stats.counted = true;
+    stats.counters = ht->counters;
+#endif
+
+    size_t visits = 0;
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        stats.n_buckets = hash_table_open_capacity(ht->open);
+        stats.max_length = hash_table_open_probe_lengths(ht->open, stats.histogram, HASH_TABLE_STATS_BINS, &visits);
+        stats.resizes = hash_table_open_resizes(ht->open);
+        stats.bytes = sizeof(HashTable) + hash_table_open_bytes(ht->open);
+        stats.rehashing = hash_table_open_rehashing(ht->open);
+    } else {
+        // the old buckets already migrated are no longer in use
+        stats.n_buckets = ht->buckets->n_buckets;
+        stats.bytes = sizeof(HashTable) + buckets_bytes(ht->buckets) + ht->size * sizeof(List);
+        hash_table__chain_lengths(ht->buckets, 0, &stats, &visits);
+        if (ht->old_buckets != NULL) {
+            stats.n_buckets += ht->old_buckets->n_buckets - ht->rehash_index;
+            stats.bytes += buckets_bytes(ht->old_buckets);
+            hash_table__chain_lengths(ht->old_buckets, ht->rehash_index, &stats, &visits);
+        }
+        stats.resizes = ht->resizes;
+        stats.rehashing = ht->old_buckets != NULL;
+    }
+    stats.bytes += hash_table__filter_bytes(ht);
+    stats.load_factor = stats.n_buckets > 0 ? (double) stats.size / stats.n_buckets : 0;
+    stats.mean_length = stats.size > 0 ? (double) visits / stats.size : 0;
+    return stats;
+}
+
+void hash_table_stats_print(const HashTableStats *stats, HashTableStatsFormat format, FILE *out) {
+    const char *type = stats->type == HASH_TABLE_CHAINING ? "chaining" : "open_addressing";
+    const HashTableCounters *c = &stats->counters;
+    switch (format) {
+    case HASH_TABLE_STATS_TEXT: {
+        fprintf(out, "type: %s\n", type);
+        fprintf(out, "size: %zu\n", stats->size);
+        fprintf(out, "buckets: %zu\n", stats->n_buckets);
+        fprintf(out, "load factor: %.3f\n", stats->load_factor);
+        fprintf(out, "mean length: %.3f\n", stats->mean_length);
+        fprintf(out, "max length: %zu\n", stats->max_length);
+        fprintf(out, "resizes: %zu%s\n", stats->resizes, stats->rehashing ? " (rehashing)" : "");
+        fprintf(out, "bytes: %zu\n", stats->bytes);
+        if (stats->counted) {
+            fprintf(out, "get: %zu hits, %zu misses\n", c->get_hits, c->get_misses);
+            fprintf(out, "put: %zu inserts, %zu updates\n", c->put_inserts, c->put_updates);
+            fprintf(out, "remove: %zu hits, %zu misses\n", c->remove_hits, c->remove_misses);
+        }
+        fprintf(out, "%s:\n", stats->type == HASH_TABLE_CHAINING ? "buckets by length" : "pairs by probe length");
+        size_t peak = 1;
+        for (size_t i = 0; i < HASH_TABLE_STATS_BINS; i++) {
+            peak = stats->histogram[i] > peak ? stats->histogram[i] : peak;
+        }
+        for (size_t i = 0; i < HASH_TABLE_STATS_BINS; i++) {
+            fprintf(out, "%4zu%s %10zu ", i, i + 1 < HASH_TABLE_STATS_BINS ? " " : "+", stats->histogram[i]);
+            for (size_t bar = 0; bar < (stats->histogram[i] * 40 + peak - 1) / peak; bar++) {
+                fputc('#', out);
+            }
+            fputc('\n', out);
+        }
+        break;
+    }
+    case HASH_TABLE_STATS_CSV:
+        fprintf(out, "type,size,buckets,load_factor,mean_length,max_length,resizes,rehashing,bytes,"
+                "get_hits,get_misses,put_inserts,put_updates,remove_hits,remove_misses");
+        for (size_t i = 0; i < HASH_TABLE_STATS_BINS; i++) {
+            fprintf(out, ",length_%zu", i);
+        }
+        fprintf(out, "\n%s,%zu,%zu,%.6f,%.6f,%zu,%zu,%d,%zu",
+                type, stats->size, stats->n_buckets, stats->load_factor, stats->mean_length,
+                stats->max_length, stats->resizes, stats->rehashing, stats->bytes);
+        if (stats->counted) {
+            fprintf(out, ",%zu,%zu,%zu,%zu,%zu,%zu", c->get_hits, c->get_misses,
+                    c->put_inserts, c->put_updates, c->remove_hits, c->remove_misses);
+        } else {
+            fprintf(out, ",,,,,,"); // empty cells: not counted
+        }
+        for (size_t i = 0; i < HASH_TABLE_STATS_BINS; i++) {
+            fprintf(out, ",%zu", stats->histogram[i]);
+        }
+        fputc('\n', out);
+        break;
+    case HASH_TABLE_STATS_JSON:
+        fprintf(out, "{\"type\": \"%s\", \"size\": %zu, \"buckets\": %zu, "
+                "\"load_factor\": %.6f, \"mean_length\": %.6f, \"max_length\": %zu, "
+                "\"resizes\": %zu, \"rehashing\": %s, \"bytes\": %zu, ",
+                type, stats->size, stats->n_buckets, stats->load_factor, stats->mean_length,
+                stats->max_length, stats->resizes, stats->rehashing ? "true" : "false", stats->bytes);
+        if (stats->counted) {
+            fprintf(out, "\"counters\": {\"get_hits\": %zu, \"get_misses\": %zu, "
+                    "\"put_inserts\": %zu, \"put_updates\": %zu, "
+                    "\"remove_hits\": %zu, \"remove_misses\": %zu}, ",
+                    c->get_hits, c->get_misses, c->put_inserts, c->put_updates, c->remove_hits, c->remove_misses);
+        } else {
+            fprintf(out, "\"counters\": null, ");
+        }
+        fprintf(out, "\"histogram\": [");
+        for (size_t i = 0; i < HASH_TABLE_STATS_BINS; i++) {
+            fprintf(out, "%s%zu", i > 0 ? ", " : "", stats->histogram[i]);
+        }
+        fprintf(out, "]}\n");
+        break;
+    }
+}
+
 void hash_table_print_items(HashTable *ht) {
     printf("{");
     size_t k = 0;
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        List *head = ht->buckets[i];
-        if (!list_empty(head)) {
-            do {
-                printf("%d->%d", head->key, head->data);
-                head = head->next;
-                if (k < (ht->size - 1)) {
-                    printf(", ");
-                }
-                k++;
-            } while (head);
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        printf("%d->%d", c.key, c.value);
+        if (k < (ht->size - 1)) {
+            printf(", ");
         }
+        k++;
     }
     printf("}\n");
 }
 
 List* hash_table_keys(HashTable *ht) {
     List *keys = list_create();
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        List *head = ht->buckets[i];
-        if (!list_empty(head)) {
-            do {
-                keys = list_append(keys, head->key);
-                head = head->next;
-            } while (head);
-        }
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        keys = list_insert(keys, c.key);
     }
+    // inserted at the head to keep it linear, restore the walk order
+    list_reverse(&keys);
     return keys;
 }
 
 List* hash_table_items(HashTable *ht) {
     List *keys = list_create();
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        List *head = ht->buckets[i];
-        if (!list_empty(head)) {
-            do {
-                keys = list_insert_with_key(keys, head->key, head->data);
-                head = head->next;
-            } while (head);
-        }
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        keys = list_insert_with_key(keys, c.key, c.value);
     }
     return keys;
 }
 
 List* hash_table_values(HashTable *ht) {
     List *keys = list_create();
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        List *head = ht->buckets[i];
-        if (!list_empty(head)) {
-            do {
-                keys = list_insert(keys, head->data);
-                head = head->next;
-            } while (head);
-        }
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        keys = list_insert(keys, c.value);
     }
     return keys;
 }
@@ -173,35 +957,207 @@ void hash_table_print_keys(HashTable *ht) {
 }
 
 
+// chain of the 64-bit words of data, n is a multiple of 8
+static uint64_t hash_table__checksum(const void *data, size_t n, uint64_t h) {
+    const unsigned char *bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < n; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(uint64_t));
+        h = hash_mix64(h ^ word);
+    }
+    return h;
+}
+
+bool hash_table_save(HashTable *ht, const char *path) {
+    // compact copy hashed by hash_mix(): one generation, no tombstone
+    HashTableOpen *t = hash_table_open_create(ht->size);
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        hash_table_open_put(t, c.key, c.value);
+    }
+    const int8_t *ctrl;
+    const int *keys, *values;
+    hash_table_open_arrays(t, &ctrl, &keys, &values);
+    size_t capacity = hash_table_open_capacity(t);
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(SnapshotHeader));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.int_size = sizeof(int);
+    header.size = ht->size;
+    header.capacity = capacity;
+    header.checksum = hash_table__checksum(ctrl, capacity * sizeof(int8_t), 0);
+    header.checksum = hash_table__checksum(keys, capacity * sizeof(int), header.checksum);
+    header.checksum = hash_table__checksum(values, capacity * sizeof(int), header.checksum);
+
+    char *tmp_path = (char*) malloc(strlen(path) + sizeof(".tmp"));
+    check_alloc(tmp_path);
+    sprintf(tmp_path, "%s.tmp", path);
+    FILE *f = fopen(tmp_path, "wb");
+    bool ok = f != NULL
+        && fwrite(&header, sizeof(SnapshotHeader), 1, f) == 1
+        && fwrite(ctrl, sizeof(int8_t), capacity, f) == capacity
+        && fwrite(keys, sizeof(int), capacity, f) == capacity
+        && fwrite(values, sizeof(int), capacity, f) == capacity;
+    ok = f != NULL && fclose(f) == 0 && ok;
+    ok = ok && rename(tmp_path, path) == 0;
+    if (!ok) {
+        printf("hash_table_save: cannot write %s\n", path);
+        remove(tmp_path);
+    }
+
+    free(tmp_path);
+    hash_table_open_free(t);
+    return ok;
+}
+
+// NULL if the header describes a snapshot of length bytes readable here
+static const char* hash_table__check_snapshot(const SnapshotHeader *header, size_t length) {
+    if (length < sizeof(SnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        return "not a hash table snapshot";
+    }
+    if (header->version != SNAPSHOT_VERSION) {
+        return "unsupported snapshot version";
+    }
+    if (header->byte_order != SNAPSHOT_BYTE_ORDER || header->int_size != sizeof(int)) {
+        return "snapshot saved by an incompatible machine";
+    }
+    uint64_t capacity = header->capacity;
+    if (capacity < HASH_TABLE_OPEN_GROUP_WIDTH || (capacity & (capacity - 1)) != 0
+        || header->size > capacity * HASH_TABLE_OPEN_MAX_LOAD_NUM / HASH_TABLE_OPEN_MAX_LOAD_DEN
+        || length - sizeof(SnapshotHeader) != capacity * (sizeof(int8_t) + 2 * sizeof(int))) {
+        return "truncated or malformed snapshot";
+    }
+    return NULL;
+}
+
+HashTable* hash_table_open_mmap(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("hash_table_open_mmap: cannot open %s\n", path);
+        return NULL;
+    }
+    struct stat st;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        mapping = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        printf("hash_table_open_mmap: cannot map %s\n", path);
+        return NULL;
+    }
+
+    size_t length = (size_t) st.st_size;
+    const SnapshotHeader *header = (const SnapshotHeader*) mapping;
+    const char *error = hash_table__check_snapshot(header, length);
+    if (error != NULL) {
+        printf("hash_table_open_mmap: %s: %s\n", path, error);
+        munmap(mapping, length);
+        return NULL;
+    }
+    // lookups jump around the file: no read-ahead around the faulting page
+    posix_madvise(mapping, length, POSIX_MADV_RANDOM);
+
+    HashTable *ht = hash_table_create_with_hash(0, HASH_TABLE_OPEN_ADDRESSING, NULL);
+    hash_table_open_free(ht->open);
+    ht->open = hash_table_open_map(header + 1, header->capacity, header->size);
+    ht->size = header->size;
+    ht->mapping = mapping;
+    ht->mapping_length = length;
+    return ht;
+}
+
+bool hash_table_verify_snapshot(HashTable *ht) {
+    if (ht->mapping == NULL) {
+        return true;
+    }
+    const SnapshotHeader *header = (const SnapshotHeader*) ht->mapping;
+    size_t n = ht->mapping_length - sizeof(SnapshotHeader);
+    return hash_table__checksum(header + 1, n, 0) == header->checksum;
+}
+
 void hash_table_free(HashTable *ht) {
-    for (size_t i = 0; i < ht->n_buckets; i++) {
-        list_free(ht->buckets[i]);
+    hash_table__free_filter(ht);
+    if (ht->type == HASH_TABLE_OPEN_ADDRESSING) {
+        hash_table_open_free(ht->open);
+        if (ht->mapping != NULL) {
+            munmap(ht->mapping, ht->mapping_length);
+        }
+        free(ht);
+        return;
     }
-    free(ht->buckets);
+
+    buckets_release(ht->buckets);
+    buckets_release(ht->old_buckets);
     free(ht);
 }
 
+// state of an iterator: the cursor and the storage of the current pair
+typedef struct HashTableIteratorState {
+    HashTableCursor cursor;
+    List pair;     // key and data of the pair returned by iterator_next()
+    bool has_next; // the cursor already stands on the next pair
+} HashTableIteratorState;
+
+// move the pair under the cursor to the state and look ahead the next one
+static List* hash_table_iterator__advance(Iterator *it) {
+    HashTableIteratorState *state = (HashTableIteratorState*) it->container;
+    if (!state->has_next) {
+        return NULL;
+    }
+    state->pair.key = state->cursor.key;
+    state->pair.data = state->cursor.value;
+    state->has_next = hash_table_cursor_next(&state->cursor);
+    return &state->pair;
+}
+
+static void* hash_table_iterator_next_item(Iterator *it) {
+    return hash_table_iterator__advance(it);
+}
+
+static void* hash_table_iterator_next_key(Iterator *it) {
+    List *pair = hash_table_iterator__advance(it);
+    return pair != NULL ? &pair->key : NULL;
+}
+
+static void* hash_table_iterator_next_value(Iterator *it) {
+    List *pair = hash_table_iterator__advance(it);
+    return pair != NULL ? &pair->data : NULL;
+}
+
+static bool hash_table_iterator_done(Iterator *it) {
+    return !((HashTableIteratorState*) it->container)->has_next;
+}
+
 static void hash_table_iterator_free(Iterator *it) {
-    list_free((List*) it->begin);
+    free(it->begin);
     free(it);
 }
 
+static Iterator* hash_table_iterator(HashTable *ht, void* (*next)(Iterator*)) {
+    HashTableIteratorState *state = (HashTableIteratorState*) malloc(sizeof(HashTableIteratorState));
+    check_alloc(state);
+    state->cursor = hash_table_cursor(ht);
+    state->pair.next = NULL;
+    state->has_next = hash_table_cursor_next(&state->cursor);
+    return iterator_create(state, next, &hash_table_iterator_free, &hash_table_iterator_done);
+}
+
 Iterator* hash_table_iterator_items(HashTable *ht) {
-    Iterator *it = list_iterator(hash_table_items(ht));
-    it->free = &hash_table_iterator_free;
-    return it;
+    return hash_table_iterator(ht, &hash_table_iterator_next_item);
 }
 
 Iterator* hash_table_iterator_keys(HashTable *ht) {
-    // NOTE: values of list from produced hash_table_keys are produced
-    // on field list->data, and not list->keys
-    Iterator *it = list_iterator_data(hash_table_keys(ht));
-    it->free = &hash_table_iterator_free;
-    return it;
+    return hash_table_iterator(ht, &hash_table_iterator_next_key);
 }
 
 Iterator* hash_table_iterator_values(HashTable *ht) {
-    Iterator *it = list_iterator_data(hash_table_values(ht));
-    it->free = &hash_table_iterator_free;
-    return it;
+    return hash_table_iterator(ht, &hash_table_iterator_next_value);
+}
+
+Iterator* hash_table_iterator_data(HashTable *ht) {
+    return hash_table_iterator_values(ht);
 }
@@ -13,28 +13,201 @@
 #ifndef HASH_TABLE_H
 #define HASH_TABLE_H
 
+#include <stdio.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include "../list/single/list.h"
 #include "../iterator/iterator.h"
+#include "../utils/hash.h"
 
 /**
  * @brief A basic implementation of a hash table.
  *
- * This implementation uses a separate chaining strategy to handle collisions.
- * The hash table is composed of an array of buckets, where each bucket is a
- * linked list of key-value pairs.
+ * By default this implementation uses a separate chaining strategy to handle
+ * collisions. The hash table is composed of an array of buckets, where each
+ * bucket is a linked list of key-value pairs.
+ *
+ * Alternatively, the pairs can be stored inline by an open addressing engine
+ * (see HashTableType), which avoids a node allocation per pair and probes
+ * several slots at once on lookups.
+ *
+ * Both engines resize themselves following the load factor. The resize is
+ * incremental: the old generation is kept while a bounded number of its
+ * buckets is migrated on each put/remove, so there is no latency spike.
+ * Lookups never migrate, they search both generations during a rehash.
+ *
+ * Keys are hashed by hash_mix() unless a custom HashFunction is given at
+ * creation. The number of buckets is always a power of two, so the bucket
+ * of a key is taken from the low bits of its hash instead of a modulo.
  */
 typedef struct HashTable HashTable;
 
+/**
+ * @brief Storage engine of a hash table.
+ */
+typedef enum HashTableType {
+    HASH_TABLE_CHAINING,        /**< array of buckets of linked lists */
+    HASH_TABLE_OPEN_ADDRESSING  /**< flat arrays probed by groups of slots */
+} HashTableType;
+
+/**
+ * @brief Filter kept in front of a hash table, see hash_table_use_filter().
+ */
+typedef enum HashTableFilter {
+    HASH_TABLE_FILTER_NONE,   /**< every lookup searches the table */
+    HASH_TABLE_FILTER_BLOOM,  /**< blocked Bloom filter, rebuilt after many removals */
+    HASH_TABLE_FILTER_CUCKOO  /**< cuckoo filter, updated by the removals */
+} HashTableFilter;
+
+/**
+ * @brief Engine used by hash_table_create(), and so by Set and PQueue.
+ *
+ * Can be overridden at build time, e.g.:
+ * -DHASH_TABLE_DEFAULT_TYPE=HASH_TABLE_OPEN_ADDRESSING
+ */
+#ifndef HASH_TABLE_DEFAULT_TYPE
+#define HASH_TABLE_DEFAULT_TYPE HASH_TABLE_CHAINING
+#endif
+
+/**
+ * @brief Average number of pairs per bucket that triggers a growth.
+ */
+#ifndef HASH_TABLE_MAX_LOAD
+#define HASH_TABLE_MAX_LOAD 1
+#endif
+
+/**
+ * @brief Shrink when the average number of pairs per bucket drops under
+ * 1/HASH_TABLE_SHRINK_RATIO (never under the initial number of buckets).
+ */
+#ifndef HASH_TABLE_SHRINK_RATIO
+#define HASH_TABLE_SHRINK_RATIO 8
+#endif
+
+/**
+ * @brief Non-empty buckets migrated by each put/remove during a rehash.
+ */
+#ifndef HASH_TABLE_REHASH_STEP
+#define HASH_TABLE_REHASH_STEP 4
+#endif
+
+/**
+ * @brief Keys hashed and prefetched together by the batched operations.
+ *
+ * hash_table_get_many() and hash_table_put_many() hash a batch of keys and
+ * prefetch their buckets before resolving any of them, so the cache misses
+ * of the batch overlap instead of being paid one after the other.
+ */
+#ifndef HASH_TABLE_BATCH
+#define HASH_TABLE_BATCH 16
+#endif
+
+/**
+ * @brief Buckets per chunk shared by the copies of a chaining hash table.
+ *
+ * hash_table_copy() shares the buckets with the original. The first write
+ * of either table to a chunk copies that chunk alone, with its chains. Must
+ * be a power of two.
+ */
+#ifndef HASH_TABLE_COW_CHUNK
+#define HASH_TABLE_COW_CHUNK 256
+#endif
+
+/**
+ * @brief Number of bins of the length histogram of HashTableStats.
+ */
+#ifndef HASH_TABLE_STATS_BINS
+#define HASH_TABLE_STATS_BINS 16
+#endif
+
+/**
+ * @brief Hits and misses of the operations on a hash table.
+ *
+ * Only counted when the library is built with -DHASH_TABLE_COUNTERS,
+ * otherwise the counting compiles away and they are all zero. Counting
+ * makes hash_table_get() write to the table: concurrent gets then race.
+ */
+typedef struct HashTableCounters {
+    size_t get_hits;       /**< gets, batched or not, of present keys */
+    size_t get_misses;     /**< gets of missing keys */
+    size_t put_inserts;    /**< puts of new keys */
+    size_t put_updates;    /**< puts of present keys */
+    size_t remove_hits;    /**< removes of present keys */
+    size_t remove_misses;  /**< removes of missing keys */
+} HashTableCounters;
+
+/**
+ * @brief Snapshot of the shape of a hash table, see hash_table_stats().
+ *
+ * The length of a pair is the work of a lookup finding it: for chaining,
+ * the histogram counts the buckets by number of pairs; for open addressing,
+ * it counts the pairs by number of groups probed before their own group.
+ * A mean length far above the expected one for the load factor, about
+ * 1 + load / 2 nodes for chaining and 0 groups for open addressing, points
+ * to a hash function that clusters the keys.
+ */
+typedef struct HashTableStats {
+    HashTableType type;
+    size_t size;            /**< number of pairs */
+    size_t n_buckets;       /**< buckets or slots in use, of both generations during a rehash */
+    double load_factor;     /**< size / n_buckets */
+    size_t histogram[HASH_TABLE_STATS_BINS]; /**< the last bin counts the longer lengths */
+    double mean_length;     /**< average length of a pair: nodes visited (chaining) or groups probed before its own (open addressing) */
+    size_t max_length;      /**< longest chain or probe */
+    size_t resizes;         /**< rehashes started since the creation */
+    size_t bytes;           /**< memory used, nodes and filter included */
+    bool rehashing;         /**< an incremental resize is in progress */
+    bool counted;           /**< built with HASH_TABLE_COUNTERS, else counters are not printed */
+    HashTableCounters counters;
+} HashTableStats;
+
+/**
+ * @brief Output formats of hash_table_stats_print().
+ */
+typedef enum HashTableStatsFormat {
+    HASH_TABLE_STATS_TEXT, /**< one field per line and a bar chart of the histogram */
+    HASH_TABLE_STATS_CSV,  /**< a header line and a line of values */
+    HASH_TABLE_STATS_JSON  /**< one object */
+} HashTableStatsFormat;
+
 /**
  * @brief Create a new hash table instance
- * @param n_buckets number of buckets in the hash table
+ * @param n_buckets initial number of buckets in the hash table (rounded up to a power of two)
  * @return pointer to the newly created hash table
  * @ingroup DataStructureMethods
  */
 HashTable* hash_table_create(size_t n_buckets);
 
+/**
+ * @brief Create a new hash table instance with a given storage engine
+ * @param n_buckets number of buckets (for open addressing: expected number of elements)
+ * @param type storage engine of the hash table
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTable* hash_table_create_with_type(size_t n_buckets, HashTableType type);
+
+/**
+ * @brief Create a new hash table instance with a custom hash function
+ *
+ * Useful when the key distribution is known, e.g. hash_identity() for small
+ * dense keys. Copies of the table keep the same hash function.
+ * @param n_buckets number of buckets (for open addressing: expected number of elements)
+ * @param type storage engine of the hash table
+ * @param hash hash function of the keys, NULL for hash_mix()
+ * @return pointer to the newly created hash table
+ * @ingroup DataStructureMethods
+ */
+HashTable* hash_table_create_with_hash(size_t n_buckets, HashTableType type, HashFunction hash);
+
+/**
+ * @brief Get the storage engine of the hash table
+ * @param ht hash table pointer
+ * @return the type of the hash table
+ * @ingroup DataStructureMethods
+ */
+HashTableType hash_table_type(HashTable *ht);
+
 /**
  * @brief Check if hash table is empty
  * @param ht hash table pointer
@@ -45,12 +218,42 @@ bool hash_table_empty(HashTable *ht);
 
 /**
  * @brief Create a hash table as copy of another
+ *
+ * The copy is copy-on-write and takes O(1): both tables share their
+ * storage until one of them writes to it, so read-only copies are free.
+ * With chaining, a write copies the bucket array and the chunk of
+ * HASH_TABLE_COW_CHUNK buckets it touches; with open addressing, the first
+ * write copies the slots. The copy of a table opened by
+ * hash_table_open_mmap() is made in memory right away.
+ *
+ * Copies sharing storage can be used from different threads, the sharing
+ * is reference-counted atomically. A filter set by hash_table_use_filter()
+ * is copied right away.
  * @param ht hash table to copy
  * @return pointer to the newly created hash table
  * @ingroup DataStructureMethods
  */
 HashTable* hash_table_copy(HashTable *ht);
 
+/**
+ * @brief Keep a filter of the keys in front of the hash table
+ *
+ * A lookup of a key that the filter rejects returns right away, without
+ * touching the buckets, so misses cost a single cache line. Present keys,
+ * and the few absent keys the filter accepts, are searched as usual.
+ *
+ * The filter is built from the keys of the table and then follows its puts
+ * and removes, being rebuilt when the table outgrows it. A Bloom filter
+ * keeps the removed keys until it is rebuilt, after as many removals as
+ * there are keys left; a cuckoo filter removes them at once but takes
+ * more memory. Inserts pay for the filter update, and hash_table_put_many()
+ * puts the pairs of an open addressing table one at a time.
+ * @param ht hash table pointer
+ * @param filter kind of filter, HASH_TABLE_FILTER_NONE to drop the filter
+ * @ingroup DataStructureMethods
+ */
+void hash_table_use_filter(HashTable *ht, HashTableFilter filter);
+
 /**
  * @brief Put a value associated to a key
  * @param ht hash table pointer
@@ -77,6 +280,33 @@ void hash_table_remove(HashTable *ht, int key);
   */
 int hash_table_get(HashTable *ht, int key, bool *exists);
 
+/**
+ * @brief Get the values of an array of keys
+ *
+ * Same results as calling hash_table_get() for each key, but the memory
+ * accesses of HASH_TABLE_BATCH keys are issued together.
+ * @param ht hash table pointer
+ * @param keys array of n keys
+ * @param n number of keys
+ * @param values output array of n values, -1 for missing keys; may be NULL
+ * @param exists output array of n flags, true if the key was found; may be NULL
+ * @ingroup DataStructureMethods
+ */
+void hash_table_get_many(HashTable *ht, const int *keys, size_t n, int *values, bool *exists);
+
+/**
+ * @brief Put an array of pairs, in order
+ *
+ * Same result as calling hash_table_put() for each pair, with the buckets
+ * of HASH_TABLE_BATCH keys prefetched together.
+ * @param ht hash table pointer
+ * @param keys array of n keys
+ * @param values array of n values
+ * @param n number of pairs
+ * @ingroup DataStructureMethods
+ */
+void hash_table_put_many(HashTable *ht, const int *keys, const int *values, size_t n);
+
 
 /**
  * @brief Get the number of elements in the hash table
@@ -115,10 +345,175 @@ void hash_table_print_keys(HashTable *ht);
  */
 List* hash_table_keys(HashTable *ht);
 
+/**
+ * @brief Group of buckets of a key, for a fill of the table by many threads
+ *
+ * The buckets are split into n_groups ranges of whole chunks of
+ * HASH_TABLE_COW_CHUNK buckets, see hash_table_put_group(). The program
+ * exits if the table is not a chaining one.
+ * @param ht chaining hash table pointer
+ * @param key key of the pair
+ * @param n_groups number of groups
+ * @return the group of the key, below n_groups
+ * @ingroup DataStructureMethods
+ */
+size_t hash_table_group(HashTable *ht, int key, size_t n_groups);
+
+/**
+ * @brief Put keys of one group of buckets, all with the same value
+ *
+ * The keys must all be of the same group, see hash_table_group(). Calls
+ * with keys of different groups write to different chunks of buckets, and
+ * may run at the same time from many threads on a chaining table which
+ * shares no buckets with a copy, is not rehashing and has no filter, such
+ * as a table fresh from hash_table_create_with_type(n, HASH_TABLE_CHAINING),
+ * and exits on a table of another type. The table does not grow
+ * meanwhile: create it with about as many buckets as keys.
+ * @param ht chaining hash table pointer
+ * @param keys array of n keys
+ * @param n number of keys
+ * @param value value of every key
+ * @ingroup DataStructureMethods
+ */
+void hash_table_put_group(HashTable *ht, const int *keys, size_t n, int value);
+
+/**
+ * @brief Cursor over the pairs of a hash table.
+ *
+ * A cursor walks the buckets (or slots) of the table in place, without
+ * copying the pairs, and lives on the stack:
+ *
+ *     HashTableCursor c = hash_table_cursor(ht);
+ *     while (hash_table_cursor_next(&c)) {
+ *         use(c.key, c.value);
+ *     }
+ *
+ * Invalidation: any hash_table_put() or hash_table_remove() on the table,
+ * even the update of an existing key, may migrate pairs during a rehash,
+ * so the walk could skip or repeat pairs. A cursor must not be advanced
+ * after such a call; builds without NDEBUG assert on it. HashTable is not
+ * thread-safe: a walk concurrent with a write from another thread is
+ * undefined (see HashTableConcurrent). Concurrent walks and gets are fine.
+ */
+typedef struct HashTableCursor {
+    HashTable *ht;
+    size_t index;      /**< next bucket or slot to visit */
+    size_t end;        /**< one past the last bucket or slot to visit */
+    List *node;        /**< next node of the current bucket */
+    size_t mutations;  /**< writes on ht when the walk started */
+    int key;           /**< key of the current pair */
+    int value;         /**< value of the current pair */
+} HashTableCursor;
+
+/**
+ * @brief Start a walk over the pairs of the hash table
+ * @param ht hash table pointer
+ * @return a cursor placed before the first pair
+ * @ingroup DataStructureMethods
+ */
+HashTableCursor hash_table_cursor(HashTable *ht);
+
+/**
+ * @brief Start a walk over a part of the pairs of the hash table
+ *
+ * The buckets (or slots) are split into parts ranges of about the same
+ * length, so that the cursors of the parts 0 to parts - 1 walk each pair
+ * once. Concurrent walks of the parts split a pass over a large table
+ * between threads.
+ * @param ht hash table pointer
+ * @param part index of the part, below parts
+ * @param parts number of parts
+ * @return a cursor placed before the first pair of the part
+ * @ingroup DataStructureMethods
+ */
+HashTableCursor hash_table_cursor_part(HashTable *ht, size_t part, size_t parts);
+
+/**
+ * @brief Move the cursor to the next pair
+ * @param c cursor pointer, its key and value are set to the new pair
+ * @return false when there are no more pairs, true otherwise
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_cursor_next(HashTableCursor *c);
+
+/**
+ * @brief Iterators over the keys, values or items of the hash table.
+ *
+ * They walk the table with a HashTableCursor, the only allocation is the
+ * iterator itself. The pointer returned by iterator_next() is valid until
+ * the next call: keys and values are int*, items are List* with key and data
+ * (and no next). The invalidation rules of HashTableCursor apply.
+ * @param ht hash table pointer
+ * @return pointer to the new iterator
+ * @ingroup DataStructureMethods
+ */
 Iterator* hash_table_iterator_keys(HashTable *ht);
+Iterator* hash_table_iterator_values(HashTable *ht);
 Iterator* hash_table_iterator_data(HashTable *ht);
 Iterator* hash_table_iterator_items(HashTable *ht);
 
+/**
+ * @brief Measure the shape of the hash table
+ *
+ * Walks every bucket or slot: O(n) for chaining, O(n * probe length) for
+ * open addressing.
+ * @param ht hash table pointer
+ * @return the stats of the table
+ * @ingroup DataStructureMethods
+ */
+HashTableStats hash_table_stats(HashTable *ht);
+
+/**
+ * @brief Print the stats of a hash table
+ * @param stats pointer to the stats of hash_table_stats()
+ * @param format text, CSV or JSON
+ * @param out output stream, e.g. stdout
+ * @ingroup DataStructureMethods
+ */
+void hash_table_stats_print(const HashTableStats *stats, HashTableStatsFormat format, FILE *out);
+
+/**
+ * @brief Save a snapshot of the hash table to a file
+ *
+ * The file is a 64-byte header (magic, version, byte order, size, capacity
+ * and a checksum of the rest) followed by the flat slots of an open
+ * addressing table hashed by hash_mix(): control bytes, keys and values.
+ * It holds no pointer, so it can be mapped at any address and read in
+ * place by hash_table_open_mmap(). The file is written under a temporary
+ * name and then renamed, a crash never leaves a partial snapshot at path.
+ * @param ht hash table pointer, of any engine and hash function
+ * @param path file to write, replaced if it exists
+ * @return true on success, false on I/O error
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_save(HashTable *ht, const char *path);
+
+/**
+ * @brief Open a snapshot saved by hash_table_save() without loading it
+ *
+ * The file is memory-mapped and its slots are probed in place: the table
+ * is queryable right away and pages are read from disk as lookups touch
+ * them. Only the header is checked; see hash_table_verify_snapshot().
+ *
+ * The table is read-only: hash_table_put() and hash_table_remove() exit
+ * with an error, while hash_table_copy() gives a writable table in memory.
+ * It must not be used after the file is truncated or rewritten in place.
+ * @param path file written by hash_table_save()
+ * @return pointer to the mapped hash table, NULL if the file is missing or invalid
+ * @ingroup DataStructureMethods
+ */
+HashTable* hash_table_open_mmap(const char *path);
+
+/**
+ * @brief Check the slots of a mapped snapshot against its checksum
+ *
+ * Reads the whole file, so it faults in every page.
+ * @param ht hash table pointer
+ * @return false if the snapshot is corrupted; true otherwise, and for the tables not opened by hash_table_open_mmap()
+ * @ingroup DataStructureMethods
+ */
+bool hash_table_verify_snapshot(HashTable *ht);
+
 /**
  * @brief Free memory of hash table and its contents
  * @param ht hash table pointer
@@ -1,6 +1,13 @@
 #include <stdio.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
 #include "hash-table.h"
+#include "hash-table-gen.h"
+#include "hash-table-concurrent.h"
+#include "hash-table-perfect.h"
 
 
 void test_hash_table_remove(HashTable *ht, int key) {
@@ -48,8 +55,74 @@ void test_hash_table_copy(HashTable *ht) {
 }
 
 
-HashTable* hash_table_setup() {
-    HashTable *ht = hash_table_create(10);
+#define COW_TABLES 3
+#define COW_KEYS 2000
+
+// copies share storage until written: random writes on a table, its copy
+// and a copy of the copy, each checked against its own model
+void test_hash_table_copy_on_write(HashTableType type) {
+    printf("\n== Copy-on-write copies (type=%d)\n", type);
+    HashTable *tables[COW_TABLES];
+    int *models[COW_TABLES]; // value of each key, -1 if missing
+    tables[0] = hash_table_create_with_type(1, type);
+    models[0] = (int*) malloc(COW_KEYS * sizeof(int));
+    for (int k = 0; k < COW_KEYS; k++) {
+        models[0][k] = -1;
+    }
+    for (int k = 0; k < COW_KEYS / 2; k++) {
+        hash_table_put(tables[0], k * 3 % COW_KEYS, k);
+        models[0][k * 3 % COW_KEYS] = k;
+    }
+
+    srand(7);
+    for (int round = 0; round < 4; round++) {
+        // copy in the middle of the writes, possibly during a rehash
+        for (int t = 1; t < COW_TABLES; t++) {
+            if (round > 0) {
+                hash_table_free(tables[t]);
+                free(models[t]);
+            }
+            tables[t] = hash_table_copy(tables[t - 1]);
+            models[t] = (int*) malloc(COW_KEYS * sizeof(int));
+            memcpy(models[t], models[t - 1], COW_KEYS * sizeof(int));
+        }
+        for (int op = 0; op < 3000; op++) {
+            int t = rand() % COW_TABLES;
+            int key = rand() % COW_KEYS;
+            if (rand() % 3 == 0) {
+                hash_table_remove(tables[t], key);
+                models[t][key] = -1;
+            } else {
+                hash_table_put(tables[t], key, op);
+                models[t][key] = op;
+            }
+        }
+        for (int t = 0; t < COW_TABLES; t++) {
+            size_t size = 0;
+            for (int k = 0; k < COW_KEYS; k++) {
+                assert(hash_table_get(tables[t], k, NULL) == models[t][k]);
+                size += models[t][k] != -1;
+            }
+            assert(hash_table_size(tables[t]) == size);
+        }
+    }
+
+    // a copy outlives its original
+    hash_table_free(tables[0]);
+    for (int k = 0; k < COW_KEYS; k++) {
+        assert(hash_table_get(tables[1], k, NULL) == models[1][k]);
+    }
+    for (int t = 1; t < COW_TABLES; t++) {
+        hash_table_free(tables[t]);
+    }
+    for (int t = 0; t < COW_TABLES; t++) {
+        free(models[t]);
+    }
+}
+
+
+HashTable* hash_table_setup(HashTableType type) {
+    HashTable *ht = hash_table_create_with_type(10, type);
 
     hash_table_put(ht, 1, 111);
     hash_table_put(ht, 10, 110);
@@ -64,8 +137,8 @@ HashTable* hash_table_setup() {
     return ht;
 }
 
-void test_hash_table_empty() {
-    HashTable *ht = hash_table_create(5);
+void test_hash_table_empty(HashTableType type) {
+    HashTable *ht = hash_table_create_with_type(5, type);
     assert(hash_table_empty(ht) == true);
     hash_table_put(ht, 1, 1);
     assert(hash_table_empty(ht) == false);
@@ -74,17 +147,652 @@ void test_hash_table_empty() {
     hash_table_free(ht);
 }
 
-int main(void) {
+// compare open addressing against chaining over a workload with
+// negative, strided and extreme keys, growth and tombstones
+void test_hash_table_open_addressing() {
+    printf("\n== Open addressing engine against chaining engine\n");
+    HashTable *chaining = hash_table_create_with_type(16, HASH_TABLE_CHAINING);
+    HashTable *open = hash_table_create_with_type(16, HASH_TABLE_OPEN_ADDRESSING);
+    assert(hash_table_type(open) == HASH_TABLE_OPEN_ADDRESSING);
+
+    for (int i = -500; i < 1500; i++) {
+        hash_table_put(chaining, i * 37, i);
+        hash_table_put(open, i * 37, i);
+    }
+    hash_table_put(chaining, INT_MAX, 2);
+    hash_table_put(open, INT_MAX, 2);
+
+    for (int i = -500; i < 1500; i += 3) {
+        hash_table_remove(chaining, i * 37);
+        hash_table_remove(open, i * 37);
+    }
+    // reinsert over tombstones
+    for (int i = -500; i < 1500; i += 6) {
+        hash_table_put(chaining, i * 37, -i);
+        hash_table_put(open, i * 37, -i);
+    }
+
+    assert(hash_table_size(open) == hash_table_size(chaining));
+    hash_table_put(open, INT_MIN, 1);
+    hash_table_remove(open, INT_MIN);
+    hash_table_put(open, INT_MIN, 1);
+    for (int i = -600; i < 1600; i++) {
+        bool exists_chaining, exists_open;
+        int v_chaining = hash_table_get(chaining, i * 37, &exists_chaining);
+        int v_open = hash_table_get(open, i * 37, &exists_open);
+        assert(exists_chaining == exists_open);
+        assert(v_chaining == v_open);
+    }
+    assert(hash_table_get(open, INT_MIN, NULL) == 1);
+    assert(hash_table_get(open, INT_MAX, NULL) == 2);
+    printf("size after growth and removals: %zu\n", hash_table_size(open));
+
+    HashTable *open_copy = hash_table_copy(open);
+    hash_table_put(open_copy, INT_MIN, 3);
+    assert(hash_table_get(open, INT_MIN, NULL) == 1);
+    assert(hash_table_get(open_copy, INT_MIN, NULL) == 3);
+    assert(hash_table_size(open_copy) == hash_table_size(open));
+    assert(hash_table_size(open) == hash_table_size(chaining) + 1);
+
+    hash_table_free(open_copy);
+    hash_table_free(open);
+    hash_table_free(chaining);
+}
+
+// check every key while the table grows from a single bucket and
+// shrinks back, so lookups also happen in the middle of rehashes
+void test_hash_table_rehash(HashTableType type) {
+    printf("\n== Incremental rehash (type=%d)\n", type);
+    HashTable *ht = hash_table_create_with_type(1, type);
+    int n = 5000;
+
+    for (int i = 0; i < n; i++) {
+        hash_table_put(ht, i * 7, i);
+        assert(hash_table_get(ht, i * 7, NULL) == i);
+        assert(hash_table_get(ht, (i / 2) * 7, NULL) == i / 2);
+    }
+    assert(hash_table_size(ht) == (size_t) n);
+
+    List *keys = hash_table_keys(ht);
+    assert(list_length(keys) == n);
+    list_free(keys);
+
+    for (int i = 0; i < n - 10; i++) {
+        hash_table_remove(ht, i * 7);
+        bool exists;
+        hash_table_get(ht, i * 7, &exists);
+        assert(!exists);
+        assert(hash_table_get(ht, (n - 1) * 7, NULL) == n - 1);
+        if (i % 500 == 0) {
+            HashTable *copy = hash_table_copy(ht);
+            assert(hash_table_size(copy) == hash_table_size(ht));
+            assert(hash_table_get(copy, (i + 1) * 7, NULL) == i + 1);
+            hash_table_free(copy);
+        }
+    }
+    assert(hash_table_size(ht) == 10);
+    printf("remaining items: ");
+    hash_table_print_items(ht);
+    hash_table_free(ht);
+}
+
+void test_hash_table_gen_rehash() {
+    printf("\n== Incremental rehash of HashTableGen\n");
+    HashTableGen *ht = hash_table_gen_create(1);
+    int n = 5000;
+    int *values = (int*) malloc(n * sizeof(int));
+
+    for (int i = 0; i < n; i++) {
+        values[i] = i;
+        hash_table_gen_put(ht, -i, &values[i]);
+        assert(*(int*) hash_table_gen_get(ht, -i, NULL) == i);
+    }
+    List *keys = hash_table_gen_keys(ht);
+    assert(list_length(keys) == n);
+    list_free(keys);
+
+    for (int i = 0; i < n - 1; i++) {
+        hash_table_gen_remove(ht, -i);
+        bool exists;
+        hash_table_gen_get(ht, -i, &exists);
+        assert(!exists);
+        assert(*(int*) hash_table_gen_get(ht, -(n - 1), NULL) == n - 1);
+    }
+    assert(hash_table_gen_size(ht) == 1);
+
+    hash_table_gen_free(ht, NULL);
+    free(values);
+}
+
+static int hash_calls = 0;
+
+// worst case hash: every key collides
+static uint64_t hash_constant(int key) {
+    (void) key;
+    hash_calls++;
+    return 42;
+}
+
+// custom hash functions and keys whose negation overflows
+void test_hash_table_hash_function(HashTableType type) {
+    printf("\n== Custom hash function (type=%d)\n", type);
+    HashTable *ht = hash_table_create_with_hash(3, type, &hash_constant);
+    for (int i = -100; i < 100; i++) {
+        hash_table_put(ht, i, i * 2);
+    }
+    hash_table_put(ht, INT_MIN, 1);
+    hash_table_put(ht, INT_MAX, 2);
+    assert(hash_calls > 0);
+    assert(hash_table_size(ht) == 202);
+
+    HashTable *copy = hash_table_copy(ht);
+    hash_calls = 0;
+    for (int i = -100; i < 100; i++) {
+        assert(hash_table_get(copy, i, NULL) == i * 2);
+    }
+    assert(hash_calls > 0);
+    hash_table_remove(copy, INT_MIN);
+    assert(hash_table_get(ht, INT_MIN, NULL) == 1);
+    assert(hash_table_get(copy, INT_MAX, NULL) == 2);
+    hash_table_free(copy);
+    hash_table_free(ht);
+
+    // default mixer
+    ht = hash_table_create_with_type(0, type);
+    hash_table_put(ht, INT_MIN, 1);
+    hash_table_put(ht, -INT_MAX, 2);
+    assert(hash_table_get(ht, INT_MIN, NULL) == 1);
+    hash_table_remove(ht, INT_MIN);
+    bool exists;
+    hash_table_get(ht, INT_MIN, &exists);
+    assert(!exists);
+    assert(hash_table_get(ht, -INT_MAX, NULL) == 2);
+    hash_table_free(ht);
+
+    HashTableGen *gen = hash_table_gen_create_with_hash(5, &hash_identity);
+    int value = 7;
+    hash_table_gen_put(gen, INT_MIN, &value);
+    hash_table_gen_put(gen, 0, &value);
+    assert(hash_table_gen_get(gen, INT_MIN, NULL) == &value);
+    assert(hash_table_gen_size(gen) == 2);
+    hash_table_gen_free(gen, NULL);
+}
+
+// walk every pair exactly once, also in the middle of a rehash
+void test_hash_table_cursor(HashTableType type) {
+    printf("\n== Cursor and iterators (type=%d)\n", type);
+    HashTable *ht = hash_table_create_with_type(1, type);
+    HashTableCursor c = hash_table_cursor(ht);
+    assert(!hash_table_cursor_next(&c));
+
+    int n = 3000;
+    long expected = 0;
+    for (int i = 0; i < n; i++) {
+        hash_table_put(ht, i, -i);
+        expected += i;
+        if (i % 997 != 0) {
+            continue;
+        }
+        long sum = 0;
+        size_t count = 0;
+        c = hash_table_cursor(ht);
+        while (hash_table_cursor_next(&c)) {
+            assert(c.value == -c.key);
+            sum += c.key;
+            count++;
+        }
+        assert(count == hash_table_size(ht));
+        assert(sum == expected);
+    }
+
+    Iterator *keys = hash_table_iterator_keys(ht);
+    Iterator *values = hash_table_iterator_values(ht);
+    Iterator *items = hash_table_iterator_items(ht);
+    int count = 0;
+    while (!iterator_done(keys)) {
+        int key = *(int*) iterator_next(keys);
+        int value = *(int*) iterator_next(values);
+        List *item = (List*) iterator_next(items);
+        assert(value == -key);
+        assert(item->key == key && item->data == value);
+        count++;
+    }
+    assert(count == n);
+    assert(iterator_done(values) && iterator_done(items));
+    assert(iterator_next(keys) == NULL);
+    iterator_free(keys);
+    iterator_free(values);
+    iterator_free(items);
+
+    // the parts walk each pair once between them
+    for (size_t parts = 1; parts <= 64; parts *= 4) {
+        long sum = 0;
+        count = 0;
+        for (size_t part = 0; part < parts; part++) {
+            c = hash_table_cursor_part(ht, part, parts);
+            while (hash_table_cursor_next(&c)) {
+                sum += c.key;
+                count++;
+            }
+        }
+        assert(count == n && sum == expected);
+    }
+    hash_table_free(ht);
+}
+
+// a table filled by groups of buckets holds the same pairs
+void test_hash_table_groups() {
+    printf("\n== Fill by groups of buckets\n");
+    int n = 5000;
+    size_t n_groups = 8;
+    HashTable *ht = hash_table_create_with_type(n, HASH_TABLE_CHAINING);
+    int *groups = (int*) malloc(n_groups * n * sizeof(int));
+    size_t *lengths = (size_t*) calloc(n_groups, sizeof(size_t));
+    for (int i = 0; i < n; i++) {
+        size_t g = hash_table_group(ht, 3 * i, n_groups);
+        assert(g < n_groups);
+        groups[g * n + lengths[g]++] = 3 * i;
+    }
+    for (size_t g = n_groups; g-- > 0;) {
+        hash_table_put_group(ht, groups + g * n, lengths[g], 7);
+    }
+    hash_table_put_group(ht, groups, lengths[0], 7);
+    assert(hash_table_size(ht) == (size_t) n);
+    for (int i = 0; i < 3 * n; i++) {
+        bool exists;
+        int value = hash_table_get(ht, i, &exists);
+        assert(exists == (i % 3 == 0) && (!exists || value == 7));
+    }
+    hash_table_put(ht, -1, 1);
+    assert(hash_table_size(ht) == (size_t) n + 1);
+    free(groups);
+    free(lengths);
+    hash_table_free(ht);
+}
+
+// batched operations match the one at a time ones
+void test_hash_table_many(HashTableType type) {
+    printf("\n== Batched get and put (type=%d)\n", type);
+    int n = 1000;
+    int *keys = (int*) malloc(n * sizeof(int));
+    int *values = (int*) malloc(n * sizeof(int));
+    bool *exists = (bool*) malloc(n * sizeof(bool));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (i % 700) * 13 - 3000; // repeated keys: the last put wins
+        values[i] = i;
+    }
+
+    HashTable *ht = hash_table_create_with_type(1, type);
+    HashTable *single = hash_table_create_with_type(1, type);
+    hash_table_put_many(ht, keys, values, n);
+    for (int i = 0; i < n; i++) {
+        hash_table_put(single, keys[i], values[i]);
+    }
+    assert(hash_table_size(ht) == 700);
+    assert(hash_table_size(ht) == hash_table_size(single));
 
-    HashTable *ht = hash_table_setup();
+    for (int i = 0; i < n; i++) {
+        keys[i] = i * 13 - 3100;
+    }
+    hash_table_get_many(ht, keys, n, values, exists);
+    for (int i = 0; i < n; i++) {
+        bool exists_single;
+        assert(values[i] == hash_table_get(single, keys[i], &exists_single));
+        assert(exists[i] == exists_single);
+    }
+    hash_table_get_many(ht, keys, n, NULL, exists);
+    hash_table_get_many(ht, keys, 0, values, NULL);
+
+    hash_table_free(single);
+    hash_table_free(ht);
+    free(keys);
+    free(values);
+    free(exists);
+}
+
+// the histogram accounts for every bucket or pair
+void test_hash_table_stats(HashTableType type) {
+    printf("\n== Stats (type=%d)\n", type);
+    int n = 3000;
+    HashTable *ht = hash_table_create_with_type(1, type);
+    for (int i = 0; i < n; i++) {
+        hash_table_put(ht, i * 31, i);
+    }
+    hash_table_put(ht, 0, 0);
+    hash_table_remove(ht, 31);
+    hash_table_remove(ht, 1);
+    hash_table_get(ht, 62, NULL);
+    hash_table_get(ht, 63, NULL);
+
+    HashTableStats stats = hash_table_stats(ht);
+    assert(stats.type == type);
+    assert(stats.size == (size_t) n - 1);
+    assert(stats.load_factor == (double) stats.size / stats.n_buckets);
+    assert(stats.resizes > 0);
+    assert(stats.bytes > stats.size * 2 * sizeof(int));
+    size_t total = 0, weighted = 0;
+    for (size_t i = 0; i < HASH_TABLE_STATS_BINS; i++) {
+        total += stats.histogram[i];
+        weighted += i * stats.histogram[i];
+    }
+    if (type == HASH_TABLE_CHAINING) {
+        assert(total == stats.n_buckets);
+        assert(weighted <= stats.size && stats.mean_length >= 1);
+    } else {
+        assert(total == stats.size);
+        assert((double) weighted <= stats.mean_length * stats.size);
+    }
+    assert(stats.max_length < HASH_TABLE_STATS_BINS);
+#ifdef HASH_TABLE_COUNTERS
+    assert(stats.counted);
+    assert(stats.counters.put_inserts == (size_t) n && stats.counters.put_updates == 1);
+    assert(stats.counters.remove_hits == 1 && stats.counters.remove_misses == 1);
+    assert(stats.counters.get_hits == 1 && stats.counters.get_misses == 1);
+#else
+    assert(!stats.counted && stats.counters.get_hits == 0 && stats.counters.put_inserts == 0);
+#endif
+
+    hash_table_stats_print(&stats, HASH_TABLE_STATS_TEXT, stdout);
+    hash_table_stats_print(&stats, HASH_TABLE_STATS_CSV, stdout);
+    hash_table_stats_print(&stats, HASH_TABLE_STATS_JSON, stdout);
+    hash_table_free(ht);
+
+    // every key in one bucket: the histogram shows it
+    ht = hash_table_create_with_hash(64, type, hash_constant);
+    for (int i = 0; i < 20; i++) {
+        hash_table_put(ht, i, i);
+    }
+    stats = hash_table_stats(ht);
+    assert(stats.max_length >= (type == HASH_TABLE_CHAINING ? 20 : 1));
+    hash_table_free(ht);
+}
+
+#define SNAPSHOT_PATH "hash-table-test.snapshot"
+
+// flip one byte of a file
+static void corrupt_file(const char *path, long offset) {
+    FILE *f = fopen(path, "r+b");
+    fseek(f, offset, SEEK_SET);
+    int byte = fgetc(f);
+    fseek(f, offset, SEEK_SET);
+    fputc(byte ^ 0xFF, f);
+    fclose(f);
+}
+
+// a saved table reopened by mmap answers as the original one
+void test_hash_table_snapshot(HashTableType type) {
+    printf("\n== Snapshot save and mmap (type=%d)\n", type);
+    int n = 5000;
+    HashTable *ht = hash_table_create_with_type(1, type);
+    for (int i = 0; i < n; i++) {
+        hash_table_put(ht, i * 7 - n, i);
+    }
+    hash_table_put(ht, INT_MIN, 42);
+    hash_table_remove(ht, 0);
+    bool saved = hash_table_save(ht, SNAPSHOT_PATH);
+    assert(saved);
+
+    HashTable *mapped = hash_table_open_mmap(SNAPSHOT_PATH);
+    assert(mapped != NULL);
+    assert(hash_table_verify_snapshot(mapped));
+    assert(hash_table_size(mapped) == hash_table_size(ht));
+    for (int key = -n - 10; key < 7 * n; key++) {
+        bool exists, exists_mapped;
+        int value = hash_table_get(ht, key, &exists);
+        assert(hash_table_get(mapped, key, &exists_mapped) == value);
+        assert(exists == exists_mapped);
+    }
+    assert(hash_table_get(mapped, INT_MIN, NULL) == 42);
+    size_t count = 0;
+    HashTableCursor c = hash_table_cursor(mapped);
+    while (hash_table_cursor_next(&c)) {
+        assert(hash_table_get(ht, c.key, NULL) == c.value);
+        count++;
+    }
+    assert(count == hash_table_size(ht));
+
+    // a copy is writable and leaves the snapshot untouched
+    HashTable *copy = hash_table_copy(mapped);
+    hash_table_put(copy, 1, 1);
+    hash_table_remove(copy, INT_MIN);
+    assert(hash_table_get(copy, 1, NULL) == 1);
+    assert(hash_table_get(mapped, INT_MIN, NULL) == 42);
+    hash_table_free(copy);
+    hash_table_free(mapped);
+
+    // corrupted slots are caught by the checksum, a bad header on open
+    corrupt_file(SNAPSHOT_PATH, 100);
+    mapped = hash_table_open_mmap(SNAPSHOT_PATH);
+    assert(mapped != NULL && !hash_table_verify_snapshot(mapped));
+    hash_table_free(mapped);
+    corrupt_file(SNAPSHOT_PATH, 0);
+    assert(hash_table_open_mmap(SNAPSHOT_PATH) == NULL);
+    assert(hash_table_open_mmap("missing.snapshot") == NULL);
+
+    // an empty table
+    hash_table_free(ht);
+    ht = hash_table_create_with_type(1, type);
+    saved = hash_table_save(ht, SNAPSHOT_PATH);
+    assert(saved);
+    mapped = hash_table_open_mmap(SNAPSHOT_PATH);
+    assert(mapped != NULL && hash_table_empty(mapped));
+    assert(hash_table_get(mapped, 0, NULL) == -1);
+    hash_table_free(mapped);
+    hash_table_free(ht);
+    remove(SNAPSHOT_PATH);
+}
+
+void test_hash_table_perfect() {
+    printf("\n== Minimal perfect hash table\n");
+    int n = 100000;
+    int *keys = (int*) malloc((n + 2) * sizeof(int));
+    int *values = (int*) malloc((n + 2) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        keys[i] = (i - n / 2) * 64;
+        values[i] = i;
+    }
+    // repeated key: the last value wins
+    keys[n] = INT_MIN; values[n] = 1;
+    keys[n + 1] = INT_MIN; values[n + 1] = 2;
+
+    HashTablePerfect *t = hash_table_perfect_create(keys, values, n + 2);
+    assert(hash_table_perfect_size(t) == (size_t) n + 1);
+    for (int i = 0; i < n; i++) {
+        bool exists;
+        assert(hash_table_perfect_get(t, keys[i], &exists) == i && exists);
+        hash_table_perfect_get(t, keys[i] + 1, &exists);
+        assert(!exists);
+    }
+    assert(hash_table_perfect_get(t, INT_MIN, NULL) == 2);
+    assert(hash_table_perfect_get(t, INT_MAX, NULL) == -1);
+    printf("bits per key: %.2f\n", hash_table_perfect_bits_per_key(t));
+    assert(hash_table_perfect_bits_per_key(t) < 4);
+    hash_table_perfect_free(t);
+
+    HashTable *ht = hash_table_setup(HASH_TABLE_CHAINING);
+    t = hash_table_perfect_from_hash_table(ht);
+    assert(hash_table_perfect_size(t) == hash_table_size(ht));
+    HashTableCursor c = hash_table_cursor(ht);
+    while (hash_table_cursor_next(&c)) {
+        assert(hash_table_perfect_get(t, c.key, NULL) == c.value);
+    }
+    hash_table_perfect_free(t);
+    hash_table_free(ht);
+
+    t = hash_table_perfect_create(keys, values, 0);
+    bool exists = true;
+    assert(hash_table_perfect_get(t, 0, &exists) == -1 && !exists);
+    hash_table_perfect_free(t);
+    free(keys);
+    free(values);
+}
+
+#define CONCURRENT_WRITERS 4
+#define CONCURRENT_READERS 2
+#define CONCURRENT_KEYS 20000
+
+typedef struct ConcurrentWorker {
+    HashTableConcurrent *t;
+    int id;
+} ConcurrentWorker;
+
+// put a range of keys, update them and remove the odd ones
+static void* concurrent_writer(void *arg) {
+    ConcurrentWorker *w = (ConcurrentWorker*) arg;
+    int begin = w->id * CONCURRENT_KEYS;
+    for (int k = begin; k < begin + CONCURRENT_KEYS; k++) {
+        hash_table_concurrent_put(w->t, k, k);
+        hash_table_concurrent_put(w->t, k, 2 * k);
+    }
+    for (int k = begin + 1; k < begin + CONCURRENT_KEYS; k += 2) {
+        hash_table_concurrent_remove(w->t, k);
+    }
+    return NULL;
+}
+
+// readers only ever see absent keys or one of the values written
+static void* concurrent_reader(void *arg) {
+    ConcurrentWorker *w = (ConcurrentWorker*) arg;
+    for (int round = 0; round < 3; round++) {
+        for (int k = 0; k < CONCURRENT_WRITERS * CONCURRENT_KEYS; k++) {
+            bool exists;
+            int value = hash_table_concurrent_get(w->t, k, &exists);
+            assert(!exists || value == k || value == 2 * k);
+        }
+    }
+    return NULL;
+}
+
+void test_hash_table_concurrent() {
+    printf("\n== Concurrent hash table: %d writers, %d readers\n",
+           CONCURRENT_WRITERS, CONCURRENT_READERS);
+    HashTableConcurrent *t = hash_table_concurrent_create(0);
+    pthread_t threads[CONCURRENT_WRITERS + CONCURRENT_READERS];
+    ConcurrentWorker workers[CONCURRENT_WRITERS + CONCURRENT_READERS];
+
+    for (int i = 0; i < CONCURRENT_WRITERS + CONCURRENT_READERS; i++) {
+        workers[i].t = t;
+        workers[i].id = i;
+        void* (*routine)(void*) = i < CONCURRENT_WRITERS ? concurrent_writer : concurrent_reader;
+        int created = pthread_create(&threads[i], NULL, routine, &workers[i]);
+        assert(created == 0);
+    }
+    for (int i = 0; i < CONCURRENT_WRITERS + CONCURRENT_READERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    assert(hash_table_concurrent_size(t) == CONCURRENT_WRITERS * CONCURRENT_KEYS / 2);
+    hash_table_concurrent_reclaim(t);
+    for (int k = 0; k < CONCURRENT_WRITERS * CONCURRENT_KEYS; k++) {
+        bool exists;
+        int value = hash_table_concurrent_get(t, k, &exists);
+        assert(exists == (k % 2 == 0));
+        assert(!exists || value == 2 * k);
+    }
+    hash_table_concurrent_remove(t, INT_MIN);
+    hash_table_concurrent_put(t, INT_MIN, 1);
+    assert(hash_table_concurrent_get(t, INT_MIN, NULL) == 1);
+    printf("size: %zu\n", hash_table_concurrent_size(t));
+    hash_table_concurrent_free(t);
+}
+
+void test_hash_table(HashTableType type) {
+    HashTable *ht = hash_table_setup(type);
     test_hash_table_get(ht, 9, 999);
     test_hash_table_remove(ht, 10);
     test_hash_table_remove(ht, 1);
     test_hash_table_insert_with_update(ht, 0);
     test_hash_table_copy(ht);
-    test_hash_table_empty();
+    test_hash_table_empty(type);
+    hash_table_free(ht);
+}
+#define FILTER_KEYS 5000
 
+// a table with a filter answers as without: random puts and removes (with
+// rebuilds of the filter), batched gets, puts and a copy, against a model
+void test_hash_table_filter(HashTableType type, HashTableFilter filter) {
+    printf("\n== Filter in front of the table (type=%d, filter=%d)\n", type, filter);
+    HashTable *ht = hash_table_create_with_type(1, type);
+    int *model = (int*) malloc(FILTER_KEYS * sizeof(int));
+    for (int k = 0; k < FILTER_KEYS; k++) {
+        model[k] = -1;
+    }
+    for (int k = 0; k < FILTER_KEYS; k += 4) {
+        hash_table_put(ht, k, k);
+        model[k] = k;
+    }
+    size_t bytes = hash_table_stats(ht).bytes;
+    hash_table_use_filter(ht, filter);
+    assert(hash_table_stats(ht).bytes > bytes);
 
+    srand(11);
+    for (int op = 0; op < 4 * FILTER_KEYS; op++) {
+        int key = rand() % FILTER_KEYS;
+        // removals dominate in the second half, shrinking the table
+        if (rand() % 4 < (op < 2 * FILTER_KEYS ? 1 : 3)) {
+            hash_table_remove(ht, key);
+            model[key] = -1;
+        } else {
+            hash_table_put(ht, key, op);
+            model[key] = op;
+        }
+    }
+    int keys[FILTER_KEYS];
+    int values[FILTER_KEYS];
+    bool exists[FILTER_KEYS];
+    for (int k = 0; k < FILTER_KEYS; k++) {
+        keys[k] = k;
+        assert(hash_table_get(ht, k, NULL) == model[k]);
+    }
+    hash_table_get_many(ht, keys, FILTER_KEYS, values, exists);
+    for (int k = 0; k < FILTER_KEYS; k++) {
+        assert(values[k] == model[k]);
+        assert(exists[k] == (model[k] != -1));
+    }
+
+    // the copy keeps its own filter
+    HashTable *copy = hash_table_copy(ht);
+    hash_table_put_many(copy, keys, keys, FILTER_KEYS);
+    for (int k = 0; k < FILTER_KEYS; k++) {
+        assert(hash_table_get(copy, k, NULL) == k);
+        assert(hash_table_get(ht, k, NULL) == model[k]);
+    }
+    assert(hash_table_size(copy) == FILTER_KEYS);
+
+    hash_table_use_filter(ht, HASH_TABLE_FILTER_NONE);
+    for (int k = 0; k < FILTER_KEYS; k++) {
+        assert(hash_table_get(ht, k, NULL) == model[k]);
+    }
+    hash_table_free(copy);
     hash_table_free(ht);
+    free(model);
+}
+
+int main(void) {
+    test_hash_table(HASH_TABLE_CHAINING);
+    test_hash_table(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_open_addressing();
+    test_hash_table_rehash(HASH_TABLE_CHAINING);
+    test_hash_table_rehash(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_gen_rehash();
+    test_hash_table_hash_function(HASH_TABLE_CHAINING);
+    test_hash_table_hash_function(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_concurrent();
+    test_hash_table_cursor(HASH_TABLE_CHAINING);
+    test_hash_table_cursor(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_groups();
+    test_hash_table_many(HASH_TABLE_CHAINING);
+    test_hash_table_many(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_copy_on_write(HASH_TABLE_CHAINING);
+    test_hash_table_copy_on_write(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_stats(HASH_TABLE_CHAINING);
+    test_hash_table_stats(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_snapshot(HASH_TABLE_CHAINING);
+    test_hash_table_snapshot(HASH_TABLE_OPEN_ADDRESSING);
+    test_hash_table_perfect();
+    test_hash_table_filter(HASH_TABLE_CHAINING, HASH_TABLE_FILTER_BLOOM);
+    test_hash_table_filter(HASH_TABLE_CHAINING, HASH_TABLE_FILTER_CUCKOO);
+    test_hash_table_filter(HASH_TABLE_OPEN_ADDRESSING, HASH_TABLE_FILTER_BLOOM);
+    test_hash_table_filter(HASH_TABLE_OPEN_ADDRESSING, HASH_TABLE_FILTER_CUCKOO);
     return 0;
 }
@@ -0,0 +1,147 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Node allocation of the lists as the containers built over them use it:
+ * hash buckets (insert by key, remove by key, free), a queue of a BFS
+ * (append at the tail, pop the head), a stack (push and pop the head) and
+ * the copy of short chains made by copy-on-write hash tables. The same
+ * source is built twice, once with malloc and once with -DLIST_POOL.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "list.h"
+
+#define N_NODES (1 << 21)
+#define N_BUCKETS (1 << 20)
+#define QUEUE_WINDOW 4096
+#define STACK_DEPTH 1024
+#define CHAIN_LENGTH 8
+
+#ifdef LIST_POOL
+#define ALLOCATOR "pool"
+#else
+#define ALLOCATOR "malloc"
+#endif
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *workload, double seconds, long n) {
+    printf("%s;%s;%.1f\n", ALLOCATOR, workload, seconds * 1e9 / n);
+}
+
+static void benchmark_buckets(void) {
+    List **buckets = (List**) calloc(N_BUCKETS, sizeof(List*));
+    int *keys = (int*) malloc(N_NODES * sizeof(int));
+    for (int i = 0; i < N_NODES; i++) {
+        keys[i] = rand();
+    }
+
+    double start = now_seconds();
+    for (int i = 0; i < N_NODES; i++) {
+        List **b = &buckets[keys[i] % N_BUCKETS];
+        *b = list_insert_with_key(*b, keys[i], i);
+    }
+    report("bucket-insert", now_seconds() - start, N_NODES);
+
+    start = now_seconds();
+    for (int i = 0; i < N_NODES; i += 2) {
+        List **b = &buckets[keys[i] % N_BUCKETS];
+        *b = list_remove_by_key(*b, keys[i]);
+    }
+    report("bucket-remove", now_seconds() - start, N_NODES / 2);
+
+    start = now_seconds();
+    for (int i = 0; i < N_BUCKETS; i++) {
+        list_free(buckets[i]);
+    }
+    report("bucket-free", now_seconds() - start, N_NODES / 2);
+
+    free(buckets);
+    free(keys);
+}
+
+static void benchmark_queue(void) {
+    List *head = list__new_node(0);
+    List *tail = head;
+    for (int i = 1; i < QUEUE_WINDOW; i++) {
+        tail->next = list__new_node(i);
+        tail = tail->next;
+    }
+
+    long checksum = 0;
+    double start = now_seconds();
+    for (int i = 0; i < N_NODES; i++) {
+        tail->next = list__new_node(i);
+        tail = tail->next;
+        checksum += list_pop_head(&head);
+    }
+    report("queue", now_seconds() - start, N_NODES);
+
+    list_free(head);
+    if (checksum < 0) {
+        puts("queue checksum overflow");
+    }
+}
+
+static void benchmark_stack(void) {
+    long checksum = 0;
+    double start = now_seconds();
+    for (int round = 0; round < N_NODES / STACK_DEPTH; round++) {
+        List *s = list_create();
+        for (int i = 0; i < STACK_DEPTH; i++) {
+            s = list_insert(s, i);
+        }
+        while (!list_empty(s)) {
+            checksum += list_pop_head(&s);
+        }
+    }
+    report("stack", now_seconds() - start, N_NODES);
+    if (checksum < 0) {
+        puts("stack checksum overflow");
+    }
+}
+
+static void benchmark_copy(void) {
+    List *chain = list_create();
+    for (int i = 0; i < CHAIN_LENGTH; i++) {
+        chain = list_insert_with_key(chain, i, i);
+    }
+
+    double start = now_seconds();
+    for (int round = 0; round < N_NODES / CHAIN_LENGTH; round++) {
+        List *copy = list_copy(chain);
+        list_free(copy);
+    }
+    report("copy-free", now_seconds() - start, N_NODES);
+
+    list_free(chain);
+}
+
+int main(void) {
+    srand(42);
+    printf("== %d nodes\n", N_NODES);
+    printf("Allocator;Workload;ns/node\n");
+    benchmark_buckets();
+    benchmark_queue();
+    benchmark_stack();
+    benchmark_copy();
+    return 0;
+}
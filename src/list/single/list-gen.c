@@ -1,6 +1,38 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "list-gen.h"
+#include "list-pool.h"
+
+#ifdef LIST_POOL
+// nodes of the lists created on this thread, see list-pool.h
+static __thread ListPool *list_gen__pool = NULL;
+
+static ListGen* list_gen__alloc_node(void) {
+    if (list_gen__pool == NULL) {
+        list_gen__pool = list_pool_thread(sizeof(ListGen));
+    }
+    return (ListGen*) list_pool_alloc(list_gen__pool);
+}
+
+static void list_gen__free_node(ListGen *node) {
+    if (list_gen__pool == NULL) {
+        list_gen__pool = list_pool_thread(sizeof(ListGen));
+    }
+    list_pool_release(list_gen__pool, node);
+}
+#else
+static ListGen* list_gen__alloc_node(void) {
+    ListGen *node = (ListGen*) malloc(sizeof(ListGen));
+    if (node == NULL) {
+        exit(1);
+    }
+    return node;
+}
+
+static void list_gen__free_node(ListGen *node) {
+    free(node);
+}
+#endif
 
 ListGen* list_gen_create() {
     return NULL;
@@ -11,20 +43,14 @@ bool list_gen_empty(ListGen *l) {
 }
 
 ListGen* list_gen_insert(ListGen *l, void *data) {
-    ListGen *new_node = (ListGen*) malloc(sizeof(ListGen));
-    if (new_node == NULL) {
-        exit(1);
-    }
+    ListGen *new_node = list_gen__alloc_node();
     new_node->data = data;
     new_node->next = l;
     return new_node;
 }
 
 ListGen* list_gen_insert_with_key(ListGen *l, int key, void *data) {
-    ListGen *new_node = (ListGen*) malloc(sizeof(ListGen));
-    if (new_node == NULL) {
-        exit(1);
-    }
+    ListGen *new_node = list_gen__alloc_node();
     new_node->key = key;
     new_node->data = data;
     new_node->next = l;
@@ -49,7 +75,7 @@ ListGen* list_gen_remove(ListGen *l, void *data) {
         prev->next = current->next;
     }
 
-    free(current);
+    list_gen__free_node(current);
     return l;
 }
 
@@ -71,7 +97,7 @@ ListGen* list_gen_remove_by_key(ListGen *l, int key) {
         prev->next = current->next;
     }
 
-    free(current);
+    list_gen__free_node(current);
     return l;
 }
 
@@ -103,7 +129,7 @@ void list_gen_free(ListGen *l) {
     ListGen *current = l;
     while (current != NULL) {
         ListGen *next = current->next;
-        free(current);
+        list_gen__free_node(current);
         current = next;
     }
 }
@@ -118,10 +144,7 @@ ListGen* list_gen_copy(ListGen *l) {
     ListGen *new_current = NULL;
 
     while(current != NULL) {
-        ListGen *new_node = (ListGen*) malloc(sizeof(ListGen));
-        if (new_node == NULL) {
-            exit(1);
-        }
+        ListGen *new_node = list_gen__alloc_node();
         new_node->key = current->key;
         new_node->data = current->data;
         new_node->next = NULL;
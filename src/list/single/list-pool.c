@@ -0,0 +1,137 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "list-pool.h"
+#include "../../utils/check_alloc.h"
+
+// free nodes and slabs are linked through their first word
+typedef struct PoolLink {
+    struct PoolLink *next;
+} PoolLink;
+
+struct ListPool {
+    size_t node_size;  // rounded up to a multiple of a pointer
+    PoolLink *free;    // released nodes, reused first
+    PoolLink *slabs;   // every slab of the pool
+    char *fresh;       // nodes of the last slab never allocated
+    size_t n_fresh;
+    size_t n_slabs;
+    ListPool *next;    // next pool of the same thread, or of the orphans
+};
+
+// pools of the threads that exited, taken over by the next threads
+static ListPool *list_pool__orphans = NULL;
+static pthread_mutex_t list_pool__orphans_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t list_pool__key;
+static pthread_once_t list_pool__key_once = PTHREAD_ONCE_INIT;
+
+ListPool* list_pool_create(size_t node_size) {
+    ListPool *pool = (ListPool*) malloc(sizeof(ListPool));
+    check_alloc(pool);
+    size_t align = sizeof(PoolLink);
+    pool->node_size = (node_size + align - 1) / align * align;
+    pool->free = NULL;
+    pool->slabs = NULL;
+    pool->fresh = NULL;
+    pool->n_fresh = 0;
+    pool->n_slabs = 0;
+    pool->next = NULL;
+    return pool;
+}
+
+// carve the next nodes from a new slab, its header being the first link
+static void list_pool__grow(ListPool *pool) {
+    PoolLink *slab = (PoolLink*) malloc(sizeof(PoolLink) + LIST_POOL_SLAB * pool->node_size);
+    check_alloc(slab);
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->fresh = (char*) (slab + 1);
+    pool->n_fresh = LIST_POOL_SLAB;
+    pool->n_slabs++;
+}
+
+void* list_pool_alloc(ListPool *pool) {
+    if (pool->free != NULL) {
+        PoolLink *node = pool->free;
+        pool->free = node->next;
+        return node;
+    }
+    if (pool->n_fresh == 0) {
+        list_pool__grow(pool);
+    }
+    void *node = pool->fresh;
+    pool->fresh += pool->node_size;
+    pool->n_fresh--;
+    return node;
+}
+
+void list_pool_release(ListPool *pool, void *node) {
+    PoolLink *link = (PoolLink*) node;
+    link->next = pool->free;
+    pool->free = link;
+}
+
+size_t list_pool_bytes(ListPool *pool) {
+    return sizeof(ListPool) + pool->n_slabs * (sizeof(PoolLink) + LIST_POOL_SLAB * pool->node_size);
+}
+
+void list_pool_free(ListPool *pool) {
+    PoolLink *slab = pool->slabs;
+    while (slab != NULL) {
+        PoolLink *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(pool);
+}
+
+// nodes of the pools of a thread may still be in lists of other threads
+// when it exits, so its pools are kept for the next threads to reuse
+static void list_pool__orphan(void *pools) {
+    ListPool *pool = (ListPool*) pools;
+    pthread_mutex_lock(&list_pool__orphans_lock);
+    while (pool != NULL) {
+        ListPool *next = pool->next;
+        pool->next = list_pool__orphans;
+        list_pool__orphans = pool;
+        pool = next;
+    }
+    pthread_mutex_unlock(&list_pool__orphans_lock);
+}
+
+static void list_pool__create_key(void) {
+    pthread_key_create(&list_pool__key, &list_pool__orphan);
+}
+
+ListPool* list_pool_thread(size_t node_size) {
+    pthread_once(&list_pool__key_once, &list_pool__create_key);
+    size_t align = sizeof(PoolLink);
+    size_t size = (node_size + align - 1) / align * align;
+    ListPool *pool = NULL;
+    pthread_mutex_lock(&list_pool__orphans_lock);
+    for (ListPool **orphan = &list_pool__orphans; *orphan != NULL; orphan = &(*orphan)->next) {
+        if ((*orphan)->node_size == size) {
+            pool = *orphan;
+            *orphan = pool->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&list_pool__orphans_lock);
+    if (pool == NULL) {
+        pool = list_pool_create(node_size);
+    }
+    pool->next = (ListPool*) pthread_getspecific(list_pool__key);
+    pthread_setspecific(list_pool__key, pool);
+    return pool;
+}
@@ -0,0 +1,99 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef LIST_POOL_H
+#define LIST_POOL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Number of nodes carved from each slab of a ListPool.
+ */
+#ifndef LIST_POOL_SLAB
+#define LIST_POOL_SLAB 1024
+#endif
+
+/**
+ * @brief A slab allocator of fixed-size list nodes.
+ *
+ * Nodes are carved from slabs of LIST_POOL_SLAB nodes allocated with a
+ * single malloc, and released nodes are kept in a free-list to be reused
+ * by the next allocations, so allocating and releasing a node is a pointer
+ * swap instead of a call to malloc or free. The slabs are given back to
+ * the system all at once by list_pool_free().
+ *
+ * When list.c and list-gen.c are compiled with -DLIST_POOL, the nodes of
+ * List and ListGen come from a pool private to each thread instead of
+ * malloc, and so do the nodes of the hash buckets, queues and stacks built
+ * over them. A node released by another thread joins the pool of that
+ * thread. The pools of a thread are handed over by list_pool_thread() to
+ * the threads started after it exits, as their nodes may still be in use.
+ *
+ * A pool is not thread-safe.
+ */
+typedef struct ListPool ListPool;
+
+/**
+ * @brief Create an empty pool, no slab is allocated before the first node
+ * @param node_size size of the nodes, as sizeof(List)
+ * @return pointer to the newly created pool
+ * @ingroup DataStructureMethods
+ */
+ListPool* list_pool_create(size_t node_size);
+
+/**
+ * @brief Get a pool private to the calling thread
+ *
+ * The pool is created on the first call of each thread, or taken over
+ * from a thread that exited with a pool of the same node size. When the
+ * thread exits, its pools are kept, slabs and released nodes included,
+ * for the next threads to take over instead of being freed.
+ * @param node_size size of the nodes, as sizeof(List)
+ * @return pointer to a pool of the thread, to be cached by the caller
+ * @ingroup DataStructureMethods
+ */
+ListPool* list_pool_thread(size_t node_size);
+
+/**
+ * @brief Allocate a node, uninitialized
+ * @param pool pool pointer
+ * @return pointer to a node of the size of the pool
+ * @ingroup DataStructureMethods
+ */
+void* list_pool_alloc(ListPool *pool);
+
+/**
+ * @brief Give a node back to the pool, to be reused by the next allocation
+ * @param pool pool pointer
+ * @param node node allocated by any pool of the same node size
+ * @ingroup DataStructureMethods
+ */
+void list_pool_release(ListPool *pool, void *node);
+
+/**
+ * @brief Get the memory of the slabs of the pool
+ * @param pool pool pointer
+ * @return bytes allocated by the pool, in use or free
+ * @ingroup DataStructureMethods
+ */
+size_t list_pool_bytes(ListPool *pool);
+
+/**
+ * @brief Free the pool and all of its slabs at once
+ *
+ * Every node allocated by the pool is freed, whether it was released or not.
+ * @param pool pool pointer
+ * @ingroup DataStructureMethods
+ */
+void list_pool_free(ListPool *pool);
+
+#endif /* LIST_POOL_H */
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <limits.h>
 #include "list.h"
+#include "list-pool.h"
 #include "../../utils/check_alloc.h"
 
 
@@ -33,10 +34,38 @@ int list_empty(List *l) {
     return l == EMPTY_LIST;
 }
 
+#ifdef LIST_POOL
+// nodes of the lists created on this thread, see list-pool.h
+static __thread ListPool *list__pool = NULL;
+
+static List* list__alloc_node(void) {
+    if (list__pool == NULL) {
+        list__pool = list_pool_thread(sizeof(List));
+    }
+    return (List*) list_pool_alloc(list__pool);
+}
+
+static void list__free_node(List *l) {
+    if (list__pool == NULL) {
+        list__pool = list_pool_thread(sizeof(List));
+    }
+    list_pool_release(list__pool, l);
+}
+#else
+static List* list__alloc_node(void) {
+    List *l = (List*) malloc(sizeof(List));
+    check_alloc(l);
+    return l;
+}
+
+static void list__free_node(List *l) {
+    free(l);
+}
+#endif
+
 // util function
 List* list__new_node(int data) {
-    List* l = (List *) malloc(sizeof(List));
-    check_alloc(l);
+    List* l = list__alloc_node();
     l->data = data;
     l->key = INT_MIN;
     l->next = list_create();
@@ -44,8 +73,7 @@ List* list__new_node(int data) {
 }
 
 List* list__new_node_with_key(int key, int data) {
-    List* l = (List *) malloc(sizeof(List));
-    check_alloc(l);
+    List* l = list__alloc_node();
     l->key = key;
     l->data = data;
     l->next = list_create();
@@ -124,7 +152,7 @@ int list_pop_head(List** l) {
         int head = (*l)->data;
         List* head_pointer = *l;
         *l = (*l)->next;
-        free(head_pointer);
+        list__free_node(head_pointer);
         return head;
     } else {
         printf("Exception: pop head on empty list\n");
@@ -246,7 +274,7 @@ List* list_remove(List *l, int data) {
     if (!list_empty(l)) {
         if (l->data == data) {
             List* next = l->next;
-            free(l);
+            list__free_node(l);
             l = next;
         } else {
             l->next = list_remove(l->next, data);
@@ -259,7 +287,7 @@ List* list_remove_by_key_data(List *l, int key, int data) {
     if (!list_empty(l)) {
         if (l->key == key && l->data == data) {
             List* next = l->next;
-            free(l);
+            list__free_node(l);
             l = next;
         } else {
             l->next = list_remove_by_key_data(l->next, key, data);
@@ -272,7 +300,7 @@ List* list_remove_by_key(List *l, int key){
     if (!list_empty(l)) {
         if (l->key == key) {
             List* next = l->next;
-            free(l);
+            list__free_node(l);
             l = next;
         } else {
             l->next = list_remove_by_key(l->next, key);
@@ -282,9 +310,11 @@ List* list_remove_by_key(List *l, int key){
 }
 
 void list_free(List *l) {
-    if (!list_empty(l)) {
-        list_free(l->next);
-        free(l);
+    // iterative, so that long lists do not exhaust the stack
+    while (!list_empty(l)) {
+        List *next = l->next;
+        list__free_node(l);
+        l = next;
     }
 }
 
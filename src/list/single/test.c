@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include "list.h"
+#include "list-pool.h"
 #include "../../console/console.h"
 
 void test_basic_functions(void) {
@@ -283,6 +284,36 @@ void test_list_sort() {
     list_free(l_expected);
 }
 
+void test_list_pool() {
+    puts("== list pool should reuse released nodes and grow by slabs");
+    ListPool *pool = list_pool_create(sizeof(List));
+    List *a = (List*) list_pool_alloc(pool);
+    List *b = (List*) list_pool_alloc(pool);
+    assert(a != b);
+    size_t bytes = list_pool_bytes(pool);
+
+    list_pool_release(pool, a);
+    assert(list_pool_alloc(pool) == a);
+
+    // a chain longer than a slab, left unreleased to the bulk free
+    List *l = b;
+    l->key = 0;
+    l->data = 0;
+    l->next = EMPTY_LIST;
+    for (int i = 1; i < 3 * LIST_POOL_SLAB; i++) {
+        List *node = (List*) list_pool_alloc(pool);
+        node->key = i;
+        node->data = i;
+        node->next = l;
+        l = node;
+    }
+    assert(list_length(l) == 3 * LIST_POOL_SLAB);
+    assert(list_sum(l) == 3 * LIST_POOL_SLAB * (3 * LIST_POOL_SLAB - 1) / 2);
+    assert(list_pool_bytes(pool) >= 3 * bytes);
+    printf("pool bytes for %d nodes: %zu\n", 3 * LIST_POOL_SLAB + 1, list_pool_bytes(pool));
+    list_pool_free(pool);
+}
+
 int main(void) {
     test_basic_functions();
     test_list_init();
@@ -301,6 +332,7 @@ int main(void) {
     test_jarbas();
     test_list_iterator();
     test_list_sort();
+    test_list_pool();
 #ifdef _WIN32
     pause();
 #endif
@@ -0,0 +1,96 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Scaling of the parallel set operations from 1 to max_threads threads,
+ * against the sequential ones: two hash table sets of n random elements
+ * sharing half of them, and two bitsets of n dense elements.
+ *
+ * Usage: ./benchmark-parallel.out [max_threads] [n]
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "set.h"
+#include "thread-pool.h"
+
+#define DEFAULT_MAX_THREADS 16
+#define DEFAULT_N (1 << 21)
+
+typedef Set* (*Operation)(Set*, Set*);
+typedef Set* (*ParallelOperation)(Set*, Set*, ThreadPool*);
+
+static const char *op_names[] = {"union", "intersection", "difference"};
+static const Operation operations[] = {set_union, set_intersection, set_difference};
+static const ParallelOperation parallel_operations[] = {set_union_parallel, set_intersection_parallel,
+                                                        set_difference_parallel};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void benchmark_sets(const char *name, Set *a, Set *b, int max_threads) {
+    for (int op = 0; op < 3; op++) {
+        double start = now_seconds();
+        Set *result = operations[op](a, b);
+        double sequential = now_seconds() - start;
+        int size = set_size(result);
+        set_free(result);
+        printf("%s;%s;sequential;%.1f;1.00\n", name, op_names[op], sequential * 1e3);
+        for (int n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+            ThreadPool *pool = thread_pool_create(n_threads);
+            start = now_seconds();
+            result = parallel_operations[op](a, b, pool);
+            double elapsed = now_seconds() - start;
+            if (set_size(result) != size) {
+                printf("unexpected result\n");
+            }
+            set_free(result);
+            thread_pool_free(pool);
+            printf("%s;%s;%d;%.1f;%.2f\n", name, op_names[op], n_threads, elapsed * 1e3, sequential / elapsed);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+    int n = argc > 2 ? atoi(argv[2]) : DEFAULT_N;
+    srand(42);
+
+    printf("== %d elements per set\n", n);
+    printf("Sets;Operation;Threads;Time(ms);Speedup\n");
+    Set *a = set_create_with_type(SET_BITSET), *b = set_create_with_type(SET_BITSET);
+    for (int i = 0; i < 2 * n; i++) {
+        if (i % 4 < 2) set_add(a, i);
+        if (i % 4 > 0) set_add(b, i);
+    }
+    benchmark_sets("bitset", a, b, max_threads);
+    set_free(a);
+    set_free(b);
+
+    a = set_create_with_type(SET_HASH_TABLE);
+    b = set_create_with_type(SET_HASH_TABLE);
+    for (int i = 0; i < n; i++) {
+        int x = rand();
+        set_add(a, x);
+        set_add(b, i % 2 == 0 ? x : rand());
+    }
+    benchmark_sets("hash-table", a, b, max_threads);
+    set_free(a);
+    set_free(b);
+    return 0;
+}
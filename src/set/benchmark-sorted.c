@@ -0,0 +1,98 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Intersections of k posting lists, as in the queries of an inverted index:
+ * the list i holds each integer of [0, UNIVERSE) with probability
+ * 0.5 * 0.85^i, and a query intersects the first k lists. Hash table sets
+ * are intersected pairwise from the shortest, bitsets word by word, and
+ * sorted sets by sorted_set_intersection_many().
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "set.h"
+#include "sorted-set.h"
+
+#define UNIVERSE (1 << 20)
+#define LISTS 32
+#define REPEAT 5
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// intersection of the first k sets, shortest first, in microseconds
+static double time_sets(Set **sets, int k, int *size) {
+    double start = now_seconds();
+    for (int r = 0; r < REPEAT; r++) {
+        Set *result = set_intersection(sets[k - 1], sets[k - 2]);
+        for (int i = k - 3; i >= 0 && set_size(result) > 0; i--) {
+            Set *next = set_intersection(result, sets[i]);
+            set_free(result);
+            result = next;
+        }
+        *size = set_size(result);
+        set_free(result);
+    }
+    return (now_seconds() - start) * 1e6 / REPEAT;
+}
+
+static double time_sorted(SortedSet **sets, int k, int *size) {
+    double start = now_seconds();
+    for (int r = 0; r < REPEAT; r++) {
+        SortedSet *result = sorted_set_intersection_many((const SortedSet *const*) sets, k);
+        *size = (int) sorted_set_size(result);
+        sorted_set_free(result);
+    }
+    return (now_seconds() - start) * 1e6 / REPEAT;
+}
+
+int main(void) {
+    Set *hash[LISTS], *bitset[LISTS];
+    SortedSet *sorted[LISTS];
+    srand(42);
+    double p = 0.5;
+    for (int i = 0; i < LISTS; i++, p *= 0.85) {
+        hash[i] = set_create_with_type(SET_HASH_TABLE);
+        bitset[i] = set_create_with_type(SET_BITSET);
+        for (int x = 0; x < UNIVERSE; x++) {
+            if (rand() < p * RAND_MAX) {
+                set_add(hash[i], x);
+                set_add(bitset[i], x);
+            }
+        }
+        sorted[i] = sorted_set_from_set(bitset[i]);
+    }
+    printf("k;shortest;result;hash-table(us);bitset(us);sorted(us)\n");
+    for (int k = 2; k <= LISTS; k *= 2) {
+        int size_hash, size_bitset, size_sorted;
+        double t_hash = time_sets(hash, k, &size_hash);
+        double t_bitset = time_sets(bitset, k, &size_bitset);
+        double t_sorted = time_sorted(sorted, k, &size_sorted);
+        if (size_hash != size_bitset || size_hash != size_sorted) {
+            printf("unexpected result\n");
+        }
+        printf("%d;%d;%d;%.0f;%.0f;%.0f\n", k, set_size(hash[k - 1]), size_sorted, t_hash, t_bitset, t_sorted);
+    }
+    for (int i = 0; i < LISTS; i++) {
+        set_free(hash[i]);
+        set_free(bitset[i]);
+        sorted_set_free(sorted[i]);
+    }
+    return 0;
+}
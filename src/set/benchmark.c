@@ -0,0 +1,96 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Memory, insertion, membership and set algebra of the hash table, bitset
+ * and Roaring representations of a set, over dense elements: the set A holds
+ * the multiples of 2 and B the multiples of 3, N elements each. Build with
+ * CFLAGS=-mavx2 for the vector loops of the bitset.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "set.h"
+
+#define N_LOOKUPS (1 << 22)
+#define SIZES 3
+
+static const int sizes[SIZES] = {1 << 12, 1 << 16, 1 << 20};
+static const char *names[] = {"hash-table", "bitset", "roaring"};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// time of an operation combining a and b, in microseconds
+static double time_op(Set* (*op)(Set*, Set*), Set *a, Set *b) {
+    double start = now_seconds();
+    Set *result = op(a, b);
+    double elapsed = now_seconds() - start;
+    set_free(result);
+    return elapsed * 1e6;
+}
+
+static void benchmark_size(SetType type, int n, const int *lookups) {
+    double start = now_seconds();
+    Set *a = set_create_with_type(type);
+    Set *b = set_create_with_type(type);
+    for (int i = 0; i < n; i++) {
+        set_add(a, 2 * i);
+        set_add(b, 3 * i);
+    }
+    double add = (now_seconds() - start) / (2.0 * n);
+    long found = 0;
+    start = now_seconds();
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        found += set_contains(a, lookups[i] % (3 * n));
+    }
+    double contains = (now_seconds() - start) / N_LOOKUPS;
+    double union_us = time_op(set_union, a, b);
+    double intersection_us = time_op(set_intersection, a, b);
+    double difference_us = time_op(set_difference, a, b);
+    start = now_seconds();
+    bool subset = set_subset(a, a);
+    double subset_us = (now_seconds() - start) * 1e6;
+    HashTableStats stats = set_stats(a);
+    printf("%s;%d;%.1f;%.1f;%.1f;%.0f;%.0f;%.0f;%.0f\n", names[type], n,
+           (double) stats.bytes / n, add * 1e9, contains * 1e9,
+           union_us, intersection_us, difference_us, subset_us);
+    if (found < 0 || !subset) {
+        printf("unexpected result\n");
+    }
+    set_free(a);
+    set_free(b);
+}
+
+int main(void) {
+    int *lookups = (int*) malloc(N_LOOKUPS * sizeof(int));
+    srand(42);
+    for (int i = 0; i < N_LOOKUPS; i++) {
+        lookups[i] = rand();
+    }
+    printf("set;n;bytes/element;add(ns);contains(ns);union(us);intersection(us);difference(us);subset(us)\n");
+    for (int s = 0; s < SIZES; s++) {
+        // bitset first: the allocator is slowed down for a while after
+        // the nodes of a large hash table are freed
+        benchmark_size(SET_BITSET, sizes[s], lookups);
+        benchmark_size(SET_ROARING, sizes[s], lookups);
+        benchmark_size(SET_HASH_TABLE, sizes[s], lookups);
+    }
+    free(lookups);
+    return 0;
+}
@@ -0,0 +1,1091 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "roaring.h"
+#include "../utils/check_alloc.h"
+
+#define ARRAY_MAX 4096           // integers of an array container, a bitmap above
+#define BITMAP_WORDS 1024        // 65536 bits
+#define BITMAP_BYTES (BITMAP_WORDS * sizeof(uint64_t))
+#define COOKIE 12347             // serialization with run containers
+#define COOKIE_NO_RUN 12346      // serialization without run containers
+#define NO_OFFSET_THRESHOLD 4    // fewer containers with runs are serialized without offsets
+
+enum { ARRAY, BITMAP, RUN };
+
+typedef struct Container {
+    uint16_t *values;      // ARRAY: sorted integers, RUN: start and length - 1 of each run
+    uint64_t *words;       // BITMAP
+    uint32_t cardinality;
+    uint32_t length;       // integers of an array, runs of a run container
+    uint32_t capacity;     // uint16_t allocated in values
+    uint8_t type;
+} Container;
+
+struct Roaring {
+    uint16_t *keys;        // 16 high bits of the integers of each container, increasing
+    Container *containers;
+    size_t n;
+    size_t capacity;
+    size_t size;
+};
+
+
+static Container container__array(void) {
+    Container c = {NULL, NULL, 0, 0, 0, ARRAY};
+    return c;
+}
+
+static void container__reserve(Container *c, uint32_t n) {
+    if (n <= c->capacity) {
+        return;
+    }
+    uint32_t capacity = c->capacity > 0 ? c->capacity : 4;
+    while (capacity < n) {
+        capacity *= 2;
+    }
+    c->values = (uint16_t*) realloc(c->values, capacity * sizeof(uint16_t));
+    check_alloc(c->values);
+    c->capacity = capacity;
+}
+
+static uint64_t* container__alloc_words(void) {
+    uint64_t *words = (uint64_t*) calloc(BITMAP_WORDS, sizeof(uint64_t));
+    check_alloc(words);
+    return words;
+}
+
+static void container__free(Container *c) {
+    free(c->values);
+    free(c->words);
+}
+
+static Container container__copy(const Container *c) {
+    Container copy = *c;
+    if (c->type == BITMAP) {
+        copy.words = (uint64_t*) malloc(BITMAP_BYTES);
+        check_alloc(copy.words);
+        memcpy(copy.words, c->words, BITMAP_BYTES);
+        return copy;
+    }
+    copy.capacity = c->type == RUN ? 2 * c->length : c->length;
+    copy.values = NULL;
+    if (copy.capacity > 0) {
+        copy.values = (uint16_t*) malloc(copy.capacity * sizeof(uint16_t));
+        check_alloc(copy.values);
+        memcpy(copy.values, c->values, copy.capacity * sizeof(uint16_t));
+    }
+    return copy;
+}
+
+// index of the first value of the array not below x
+static uint32_t array__lower_bound(const uint16_t *values, uint32_t n, uint16_t x) {
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (values[mid] < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// array__lower_bound() from an index, by steps doubling from there, so that
+// a walk over a much longer array skips most of it
+static uint32_t array__gallop(const uint16_t *values, uint32_t from, uint32_t n, uint16_t x) {
+    uint32_t lo = from, hi = from, step = 1;
+    while (hi < n && values[hi] < x) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = hi < n ? hi : n;
+    return lo + array__lower_bound(values + lo, hi - lo, x);
+}
+
+static inline uint32_t run__start(const Container *c, uint32_t i) {
+    return c->values[2 * i];
+}
+
+static inline uint32_t run__end(const Container *c, uint32_t i) {
+    return (uint32_t) c->values[2 * i] + c->values[2 * i + 1];
+}
+
+// index of the last run starting at or before x, -1 if none
+static int32_t run__find(const Container *c, uint16_t x) {
+    int32_t lo = 0, hi = (int32_t) c->length - 1, found = -1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (run__start(c, mid) <= x) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return found;
+}
+
+static bool container__contains(const Container *c, uint16_t x) {
+    switch (c->type) {
+    case ARRAY: {
+        uint32_t i = array__lower_bound(c->values, c->length, x);
+        return i < c->length && c->values[i] == x;
+    }
+    case BITMAP:
+        return c->words[x / 64] >> (x % 64) & 1;
+    default: {
+        int32_t i = run__find(c, x);
+        return i >= 0 && x <= run__end(c, i);
+    }
+    }
+}
+
+// set the bits from start to end, both included
+static void words__set_range(uint64_t *words, uint32_t start, uint32_t end) {
+    uint32_t first = start / 64, last = end / 64;
+    uint64_t head = ~0ULL << (start % 64);
+    uint64_t tail = ~0ULL >> (63 - end % 64);
+    if (first == last) {
+        words[first] |= head & tail;
+        return;
+    }
+    words[first] |= head;
+    for (uint32_t i = first + 1; i < last; i++) {
+        words[i] = ~0ULL;
+    }
+    words[last] |= tail;
+}
+
+static uint32_t words__popcount(const uint64_t *words) {
+    uint32_t count = 0;
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+// or the integers of the container into the words
+static void container__fill(const Container *c, uint64_t *words) {
+    switch (c->type) {
+    case ARRAY:
+        for (uint32_t i = 0; i < c->length; i++) {
+            words[c->values[i] / 64] |= (uint64_t) 1 << (c->values[i] % 64);
+        }
+        break;
+    case BITMAP:
+        for (int i = 0; i < BITMAP_WORDS; i++) {
+            words[i] |= c->words[i];
+        }
+        break;
+    default:
+        for (uint32_t i = 0; i < c->length; i++) {
+            words__set_range(words, run__start(c, i), run__end(c, i));
+        }
+    }
+}
+
+// the words as a bitmap or, if they are few, an array; the words are kept
+// by the bitmap or freed
+static Container container__from_words(uint64_t *words, uint32_t cardinality) {
+    Container c = container__array();
+    c.cardinality = cardinality;
+    if (cardinality > ARRAY_MAX) {
+        c.type = BITMAP;
+        c.words = words;
+        return c;
+    }
+    container__reserve(&c, cardinality);
+    for (uint32_t i = 0; i < BITMAP_WORDS; i++) {
+        for (uint64_t bits = words[i]; bits != 0; bits &= bits - 1) {
+            c.values[c.length++] = (uint16_t) (i * 64 + __builtin_ctzll(bits));
+        }
+    }
+    free(words);
+    return c;
+}
+
+// turn the container into the array or bitmap of its integers
+static void container__decompress(Container *c) {
+    uint64_t *words = container__alloc_words();
+    container__fill(c, words);
+    uint32_t cardinality = c->cardinality;
+    container__free(c);
+    *c = container__from_words(words, cardinality);
+}
+
+// bytes of the container in the serialization, a measure of its memory
+static size_t container__bytes(uint8_t type, uint32_t cardinality, uint32_t runs) {
+    switch (type) {
+    case ARRAY:
+        return 2 * (size_t) cardinality;
+    case BITMAP:
+        return BITMAP_BYTES;
+    default:
+        return 2 + 4 * (size_t) runs;
+    }
+}
+
+// a run container larger than its array or bitmap is not a good choice anymore
+static void container__fit_runs(Container *c) {
+    uint8_t other = c->cardinality > ARRAY_MAX ? BITMAP : ARRAY;
+    if (c->type == RUN && container__bytes(RUN, 0, c->length) > container__bytes(other, c->cardinality, 0)) {
+        container__decompress(c);
+    }
+}
+
+static void run__insert(Container *c, uint32_t i, uint16_t start, uint16_t length) {
+    container__reserve(c, 2 * (c->length + 1));
+    memmove(c->values + 2 * (i + 1), c->values + 2 * i, (c->length - i) * 2 * sizeof(uint16_t));
+    c->values[2 * i] = start;
+    c->values[2 * i + 1] = length;
+    c->length++;
+}
+
+static void run__delete(Container *c, uint32_t i) {
+    memmove(c->values + 2 * i, c->values + 2 * (i + 1), (c->length - i - 1) * 2 * sizeof(uint16_t));
+    c->length--;
+}
+
+static bool run__add(Container *c, uint16_t x) {
+    int32_t i = run__find(c, x);
+    if (i >= 0 && x <= run__end(c, i)) {
+        return false;
+    }
+    bool joins_previous = i >= 0 && run__end(c, i) + 1 == x;
+    bool joins_next = (uint32_t) (i + 1) < c->length && run__start(c, i + 1) == (uint32_t) x + 1;
+    if (joins_previous && joins_next) {
+        c->values[2 * i + 1] = (uint16_t) (run__end(c, i + 1) - run__start(c, i));
+        run__delete(c, i + 1);
+    } else if (joins_previous) {
+        c->values[2 * i + 1]++;
+    } else if (joins_next) {
+        c->values[2 * (i + 1)]--;
+        c->values[2 * (i + 1) + 1]++;
+    } else {
+        run__insert(c, i + 1, x, 0);
+    }
+    c->cardinality++;
+    container__fit_runs(c);
+    return true;
+}
+
+static bool run__remove(Container *c, uint16_t x) {
+    int32_t i = run__find(c, x);
+    if (i < 0 || x > run__end(c, i)) {
+        return false;
+    }
+    uint32_t start = run__start(c, i), end = run__end(c, i);
+    if (start == end) {
+        run__delete(c, i);
+    } else if (x == start) {
+        c->values[2 * i]++;
+        c->values[2 * i + 1]--;
+    } else if (x == end) {
+        c->values[2 * i + 1]--;
+    } else {
+        c->values[2 * i + 1] = (uint16_t) (x - 1 - start);
+        run__insert(c, i + 1, (uint16_t) (x + 1), (uint16_t) (end - x - 1));
+    }
+    c->cardinality--;
+    container__fit_runs(c);
+    return true;
+}
+
+static bool container__add(Container *c, uint16_t x) {
+    switch (c->type) {
+    case ARRAY: {
+        uint32_t i = array__lower_bound(c->values, c->length, x);
+        if (i < c->length && c->values[i] == x) {
+            return false;
+        }
+        if (c->length == ARRAY_MAX) {
+            uint64_t *words = container__alloc_words();
+            container__fill(c, words);
+            free(c->values);
+            c->values = NULL;
+            c->length = c->capacity = 0;
+            c->words = words;
+            c->type = BITMAP;
+            return container__add(c, x);
+        }
+        container__reserve(c, c->length + 1);
+        memmove(c->values + i + 1, c->values + i, (c->length - i) * sizeof(uint16_t));
+        c->values[i] = x;
+        c->length++;
+        c->cardinality++;
+        return true;
+    }
+    case BITMAP: {
+        uint64_t bit = (uint64_t) 1 << (x % 64);
+        if (c->words[x / 64] & bit) {
+            return false;
+        }
+        c->words[x / 64] |= bit;
+        c->cardinality++;
+        return true;
+    }
+    default:
+        return run__add(c, x);
+    }
+}
+
+static bool container__remove(Container *c, uint16_t x) {
+    switch (c->type) {
+    case ARRAY: {
+        uint32_t i = array__lower_bound(c->values, c->length, x);
+        if (i == c->length || c->values[i] != x) {
+            return false;
+        }
+        memmove(c->values + i, c->values + i + 1, (c->length - i - 1) * sizeof(uint16_t));
+        c->length--;
+        c->cardinality--;
+        return true;
+    }
+    case BITMAP: {
+        uint64_t bit = (uint64_t) 1 << (x % 64);
+        if (!(c->words[x / 64] & bit)) {
+            return false;
+        }
+        c->words[x / 64] &= ~bit;
+        c->cardinality--;
+        if (c->cardinality <= ARRAY_MAX) {
+            *c = container__from_words(c->words, c->cardinality);
+        }
+        return true;
+    }
+    default:
+        return run__remove(c, x);
+    }
+}
+
+static uint32_t container__count_runs(const Container *c) {
+    uint32_t runs = 0;
+    switch (c->type) {
+    case ARRAY:
+        for (uint32_t i = 0; i < c->length; i++) {
+            runs += i == 0 || c->values[i] != c->values[i - 1] + 1;
+        }
+        return runs;
+    case BITMAP: {
+        uint64_t carry = 0; // last bit of the previous word
+        for (int i = 0; i < BITMAP_WORDS; i++) {
+            uint64_t w = c->words[i];
+            runs += __builtin_popcountll(w & ~(w << 1 | carry));
+            carry = w >> 63;
+        }
+        return runs;
+    }
+    default:
+        return c->length;
+    }
+}
+
+// the runs of set bits of the words
+static Container container__runs_from_words(const uint64_t *words, uint32_t cardinality, uint32_t runs) {
+    Container c = container__array();
+    c.type = RUN;
+    c.cardinality = cardinality;
+    container__reserve(&c, 2 * runs);
+    uint32_t i = 0;
+    uint64_t current = words[0];
+    while (true) {
+        while (current == 0 && i < BITMAP_WORDS - 1) {
+            current = words[++i];
+        }
+        if (current == 0) {
+            break;
+        }
+        uint32_t start = i * 64 + __builtin_ctzll(current);
+        uint64_t filled = current | (current - 1); // ones up to the end of the run
+        while (filled == ~0ULL && i < BITMAP_WORDS - 1) {
+            filled = words[++i];
+        }
+        uint32_t end = filled == ~0ULL ? 65536 : i * 64 + __builtin_ctzll(~filled);
+        c.values[2 * c.length] = (uint16_t) start;
+        c.values[2 * c.length + 1] = (uint16_t) (end - start - 1);
+        c.length++;
+        if (filled == ~0ULL) {
+            break;
+        }
+        current = filled & (filled + 1); // bits after the run
+    }
+    return c;
+}
+
+static void container__optimize(Container *c) {
+    uint32_t runs = container__count_runs(c);
+    uint8_t other = c->cardinality > ARRAY_MAX ? BITMAP : ARRAY;
+    if (c->type != RUN && container__bytes(RUN, 0, runs) < container__bytes(other, c->cardinality, 0)) {
+        uint64_t *words = c->words;
+        if (c->type == ARRAY) {
+            words = container__alloc_words();
+            container__fill(c, words);
+        }
+        Container run = container__runs_from_words(words, c->cardinality, runs);
+        if (c->type == ARRAY) {
+            free(words);
+        }
+        container__free(c);
+        *c = run;
+    } else {
+        container__fit_runs(c);
+    }
+}
+
+// the words of the container, filled in tmp unless it is a bitmap
+static const uint64_t* container__words(const Container *c, uint64_t *tmp) {
+    if (c->type == BITMAP) {
+        return c->words;
+    }
+    memset(tmp, 0, BITMAP_BYTES);
+    container__fill(c, tmp);
+    return tmp;
+}
+
+// a & b in out, false if it is empty
+static bool container__and(const Container *a, const Container *b, Container *out) {
+    if (a->type == ARRAY || b->type == ARRAY) {
+        const Container *array = a->type == ARRAY ? a : b;
+        const Container *other = array == a ? b : a;
+        Container c = container__array();
+        container__reserve(&c, array->length);
+        if (other->type == ARRAY && (uint64_t) array->length * 64 < other->length) {
+            uint32_t j = 0;
+            for (uint32_t i = 0; i < array->length && j < other->length; i++) {
+                j = array__gallop(other->values, j, other->length, array->values[i]);
+                if (j < other->length && other->values[j] == array->values[i]) {
+                    c.values[c.length++] = array->values[i];
+                }
+            }
+        } else if (other->type == ARRAY) {
+            uint32_t i = 0, j = 0;
+            while (i < array->length && j < other->length) {
+                if (array->values[i] < other->values[j]) {
+                    i++;
+                } else if (array->values[i] > other->values[j]) {
+                    j++;
+                } else {
+                    c.values[c.length++] = array->values[i];
+                    i++;
+                    j++;
+                }
+            }
+        } else {
+            for (uint32_t i = 0; i < array->length; i++) {
+                if (container__contains(other, array->values[i])) {
+                    c.values[c.length++] = array->values[i];
+                }
+            }
+        }
+        c.cardinality = c.length;
+        *out = c;
+        if (c.cardinality == 0) {
+            container__free(out);
+        }
+        return c.cardinality > 0;
+    }
+    uint64_t tmp[BITMAP_WORDS];
+    uint64_t *words = container__alloc_words();
+    container__fill(a, words);
+    const uint64_t *other = container__words(b, tmp);
+    uint32_t cardinality = 0;
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        words[i] &= other[i];
+        cardinality += __builtin_popcountll(words[i]);
+    }
+    if (cardinality == 0) {
+        free(words);
+        return false;
+    }
+    *out = container__from_words(words, cardinality);
+    return true;
+}
+
+static Container container__or(const Container *a, const Container *b) {
+    if (a->type == ARRAY && b->type == ARRAY && a->length + b->length <= ARRAY_MAX) {
+        Container c = container__array();
+        container__reserve(&c, a->length + b->length);
+        uint32_t i = 0, j = 0;
+        while (i < a->length || j < b->length) {
+            if (j == b->length || (i < a->length && a->values[i] < b->values[j])) {
+                c.values[c.length++] = a->values[i++];
+            } else if (i == a->length || b->values[j] < a->values[i]) {
+                c.values[c.length++] = b->values[j++];
+            } else {
+                c.values[c.length++] = a->values[i];
+                i++;
+                j++;
+            }
+        }
+        c.cardinality = c.length;
+        return c;
+    }
+    uint64_t *words = container__alloc_words();
+    container__fill(a, words);
+    container__fill(b, words);
+    return container__from_words(words, words__popcount(words));
+}
+
+// a & ~b in out, false if it is empty
+static bool container__andnot(const Container *a, const Container *b, Container *out) {
+    if (a->type == ARRAY) {
+        Container c = container__array();
+        container__reserve(&c, a->length);
+        uint32_t j = 0;
+        for (uint32_t i = 0; i < a->length; i++) {
+            if (b->type == ARRAY) {
+                while (j < b->length && b->values[j] < a->values[i]) {
+                    j++;
+                }
+                if (j < b->length && b->values[j] == a->values[i]) {
+                    continue;
+                }
+            } else if (container__contains(b, a->values[i])) {
+                continue;
+            }
+            c.values[c.length++] = a->values[i];
+        }
+        c.cardinality = c.length;
+        *out = c;
+        if (c.cardinality == 0) {
+            container__free(out);
+        }
+        return c.cardinality > 0;
+    }
+    uint64_t *words = container__alloc_words();
+    container__fill(a, words);
+    if (b->type == ARRAY) {
+        for (uint32_t i = 0; i < b->length; i++) {
+            words[b->values[i] / 64] &= ~((uint64_t) 1 << (b->values[i] % 64));
+        }
+    } else {
+        uint64_t tmp[BITMAP_WORDS];
+        const uint64_t *other = container__words(b, tmp);
+        for (int i = 0; i < BITMAP_WORDS; i++) {
+            words[i] &= ~other[i];
+        }
+    }
+    uint32_t cardinality = words__popcount(words);
+    if (cardinality == 0) {
+        free(words);
+        return false;
+    }
+    *out = container__from_words(words, cardinality);
+    return true;
+}
+
+static bool container__subset(const Container *a, const Container *b) {
+    if (a->cardinality > b->cardinality) {
+        return false;
+    }
+    if (a->type == ARRAY && b->type == ARRAY) {
+        uint32_t j = 0;
+        for (uint32_t i = 0; i < a->length; i++) {
+            while (j < b->length && b->values[j] < a->values[i]) {
+                j++;
+            }
+            if (j == b->length || b->values[j] != a->values[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (a->type == ARRAY) {
+        for (uint32_t i = 0; i < a->length; i++) {
+            if (!container__contains(b, a->values[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+    uint64_t tmp_a[BITMAP_WORDS], tmp_b[BITMAP_WORDS];
+    const uint64_t *words_a = container__words(a, tmp_a);
+    const uint64_t *words_b = container__words(b, tmp_b);
+    for (int i = 0; i < BITMAP_WORDS; i++) {
+        if (words_a[i] & ~words_b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// index of the container of key, or where it would be inserted
+static size_t roaring__find(const Roaring *r, uint16_t key) {
+    size_t lo = 0, hi = r->n;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (r->keys[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void roaring__insert(Roaring *r, size_t i, uint16_t key, Container c) {
+    if (r->n == r->capacity) {
+        r->capacity = r->capacity > 0 ? 2 * r->capacity : 4;
+        r->keys = (uint16_t*) realloc(r->keys, r->capacity * sizeof(uint16_t));
+        check_alloc(r->keys);
+        r->containers = (Container*) realloc(r->containers, r->capacity * sizeof(Container));
+        check_alloc(r->containers);
+    }
+    memmove(r->keys + i + 1, r->keys + i, (r->n - i) * sizeof(uint16_t));
+    memmove(r->containers + i + 1, r->containers + i, (r->n - i) * sizeof(Container));
+    r->keys[i] = key;
+    r->containers[i] = c;
+    r->n++;
+}
+
+static void roaring__append(Roaring *r, uint16_t key, Container c) {
+    roaring__insert(r, r->n, key, c);
+    r->size += c.cardinality;
+}
+
+static void roaring__delete(Roaring *r, size_t i) {
+    container__free(&r->containers[i]);
+    memmove(r->keys + i, r->keys + i + 1, (r->n - i - 1) * sizeof(uint16_t));
+    memmove(r->containers + i, r->containers + i + 1, (r->n - i - 1) * sizeof(Container));
+    r->n--;
+}
+
+Roaring* roaring_create(void) {
+    Roaring *r = (Roaring*) malloc(sizeof(Roaring));
+    check_alloc(r);
+    r->keys = NULL;
+    r->containers = NULL;
+    r->n = 0;
+    r->capacity = 0;
+    r->size = 0;
+    return r;
+}
+
+Roaring* roaring_copy(const Roaring *r) {
+    Roaring *copy = roaring_create();
+    for (size_t i = 0; i < r->n; i++) {
+        roaring__append(copy, r->keys[i], container__copy(&r->containers[i]));
+    }
+    return copy;
+}
+
+bool roaring_add(Roaring *r, uint32_t x) {
+    uint16_t key = (uint16_t) (x >> 16);
+    size_t i = roaring__find(r, key);
+    if (i == r->n || r->keys[i] != key) {
+        roaring__insert(r, i, key, container__array());
+    }
+    bool added = container__add(&r->containers[i], (uint16_t) x);
+    r->size += added;
+    return added;
+}
+
+bool roaring_remove(Roaring *r, uint32_t x) {
+    uint16_t key = (uint16_t) (x >> 16);
+    size_t i = roaring__find(r, key);
+    if (i == r->n || r->keys[i] != key || !container__remove(&r->containers[i], (uint16_t) x)) {
+        return false;
+    }
+    r->size--;
+    if (r->containers[i].cardinality == 0) {
+        roaring__delete(r, i);
+    }
+    return true;
+}
+
+bool roaring_contains(const Roaring *r, uint32_t x) {
+    uint16_t key = (uint16_t) (x >> 16);
+    size_t i = roaring__find(r, key);
+    return i < r->n && r->keys[i] == key && container__contains(&r->containers[i], (uint16_t) x);
+}
+
+size_t roaring_size(const Roaring *r) {
+    return r->size;
+}
+
+Roaring* roaring_and(const Roaring *a, const Roaring *b) {
+    Roaring *r = roaring_create();
+    size_t i = 0, j = 0;
+    while (i < a->n && j < b->n) {
+        if (a->keys[i] < b->keys[j]) {
+            i++;
+        } else if (a->keys[i] > b->keys[j]) {
+            j++;
+        } else {
+            Container c;
+            if (container__and(&a->containers[i], &b->containers[j], &c)) {
+                roaring__append(r, a->keys[i], c);
+            }
+            i++;
+            j++;
+        }
+    }
+    return r;
+}
+
+Roaring* roaring_or(const Roaring *a, const Roaring *b) {
+    Roaring *r = roaring_create();
+    size_t i = 0, j = 0;
+    while (i < a->n || j < b->n) {
+        if (j == b->n || (i < a->n && a->keys[i] < b->keys[j])) {
+            roaring__append(r, a->keys[i], container__copy(&a->containers[i]));
+            i++;
+        } else if (i == a->n || b->keys[j] < a->keys[i]) {
+            roaring__append(r, b->keys[j], container__copy(&b->containers[j]));
+            j++;
+        } else {
+            roaring__append(r, a->keys[i], container__or(&a->containers[i], &b->containers[j]));
+            i++;
+            j++;
+        }
+    }
+    return r;
+}
+
+Roaring* roaring_andnot(const Roaring *a, const Roaring *b) {
+    Roaring *r = roaring_create();
+    size_t j = 0;
+    for (size_t i = 0; i < a->n; i++) {
+        while (j < b->n && b->keys[j] < a->keys[i]) {
+            j++;
+        }
+        if (j == b->n || b->keys[j] != a->keys[i]) {
+            roaring__append(r, a->keys[i], container__copy(&a->containers[i]));
+            continue;
+        }
+        Container c;
+        if (container__andnot(&a->containers[i], &b->containers[j], &c)) {
+            roaring__append(r, a->keys[i], c);
+        }
+    }
+    return r;
+}
+
+bool roaring_subset(const Roaring *a, const Roaring *b) {
+    if (a->size > b->size) {
+        return false;
+    }
+    size_t j = 0;
+    for (size_t i = 0; i < a->n; i++) {
+        while (j < b->n && b->keys[j] < a->keys[i]) {
+            j++;
+        }
+        if (j == b->n || b->keys[j] != a->keys[i] || !container__subset(&a->containers[i], &b->containers[j])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool roaring_equal(const Roaring *a, const Roaring *b) {
+    return a->size == b->size && a->n == b->n && roaring_subset(a, b);
+}
+
+void roaring_optimize(Roaring *r) {
+    for (size_t i = 0; i < r->n; i++) {
+        container__optimize(&r->containers[i]);
+    }
+}
+
+size_t roaring_bytes(const Roaring *r) {
+    size_t bytes = sizeof(Roaring) + r->capacity * (sizeof(uint16_t) + sizeof(Container));
+    for (size_t i = 0; i < r->n; i++) {
+        const Container *c = &r->containers[i];
+        bytes += c->capacity * sizeof(uint16_t) + (c->type == BITMAP ? BITMAP_BYTES : 0);
+    }
+    return bytes;
+}
+
+
+static inline void put16(unsigned char *p, uint16_t v) {
+    p[0] = (unsigned char) v;
+    p[1] = (unsigned char) (v >> 8);
+}
+
+static inline void put32(unsigned char *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (unsigned char) (v >> (8 * i));
+    }
+}
+
+static inline void put64(unsigned char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (unsigned char) (v >> (8 * i));
+    }
+}
+
+static inline uint16_t get16(const unsigned char *p) {
+    return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static inline uint32_t get32(const unsigned char *p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static inline uint64_t get64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = v << 8 | p[i];
+    }
+    return v;
+}
+
+static bool roaring__has_runs(const Roaring *r) {
+    for (size_t i = 0; i < r->n; i++) {
+        if (r->containers[i].type == RUN) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t roaring_serialized_size(const Roaring *r) {
+    bool runs = roaring__has_runs(r);
+    size_t bytes = runs ? 4 + (r->n + 7) / 8 : 8;
+    bytes += 4 * r->n; // key and cardinality of each container
+    if (!runs || r->n >= NO_OFFSET_THRESHOLD) {
+        bytes += 4 * r->n;
+    }
+    for (size_t i = 0; i < r->n; i++) {
+        const Container *c = &r->containers[i];
+        bytes += container__bytes(c->type, c->cardinality, c->length);
+    }
+    return bytes;
+}
+
+size_t roaring_serialize(const Roaring *r, void *buffer) {
+    unsigned char *out = (unsigned char*) buffer, *p = out;
+    bool runs = roaring__has_runs(r);
+    if (runs) {
+        put32(p, COOKIE | (uint32_t) (r->n - 1) << 16);
+        p += 4;
+        memset(p, 0, (r->n + 7) / 8);
+        for (size_t i = 0; i < r->n; i++) {
+            p[i / 8] |= (unsigned char) ((r->containers[i].type == RUN) << (i % 8));
+        }
+        p += (r->n + 7) / 8;
+    } else {
+        put32(p, COOKIE_NO_RUN);
+        put32(p + 4, (uint32_t) r->n);
+        p += 8;
+    }
+    for (size_t i = 0; i < r->n; i++) {
+        put16(p, r->keys[i]);
+        put16(p + 2, (uint16_t) (r->containers[i].cardinality - 1));
+        p += 4;
+    }
+    unsigned char *offsets = NULL;
+    if (!runs || r->n >= NO_OFFSET_THRESHOLD) {
+        offsets = p;
+        p += 4 * r->n;
+    }
+    for (size_t i = 0; i < r->n; i++) {
+        const Container *c = &r->containers[i];
+        if (offsets != NULL) {
+            put32(offsets + 4 * i, (uint32_t) (p - out));
+        }
+        switch (c->type) {
+        case ARRAY:
+            for (uint32_t k = 0; k < c->length; k++, p += 2) {
+                put16(p, c->values[k]);
+            }
+            break;
+        case BITMAP:
+            for (int k = 0; k < BITMAP_WORDS; k++, p += 8) {
+                put64(p, c->words[k]);
+            }
+            break;
+        default:
+            put16(p, (uint16_t) c->length);
+            p += 2;
+            for (uint32_t k = 0; k < 2 * c->length; k++, p += 2) {
+                put16(p, c->values[k]);
+            }
+        }
+    }
+    return (size_t) (p - out);
+}
+
+// read a container at *p, checking that it fits before end and is well formed
+static bool roaring__read_container(const unsigned char **p, const unsigned char *end,
+                                    bool run, uint32_t cardinality, Container *c) {
+    const unsigned char *in = *p;
+    *c = container__array();
+    c->cardinality = cardinality;
+    if (run) {
+        if (end - in < 2) {
+            return false;
+        }
+        uint32_t runs = get16(in);
+        in += 2;
+        if ((size_t) (end - in) < 4 * (size_t) runs) {
+            return false;
+        }
+        c->type = RUN;
+        container__reserve(c, 2 * runs);
+        int64_t previous_end = -1;
+        uint32_t total = 0;
+        for (uint32_t k = 0; k < runs; k++, in += 4) {
+            uint32_t start = get16(in), length = get16(in + 2);
+            if ((int64_t) start <= previous_end || start + length > 65535) {
+                return false;
+            }
+            c->values[2 * k] = (uint16_t) start;
+            c->values[2 * k + 1] = (uint16_t) length;
+            c->length++;
+            total += length + 1;
+            previous_end = start + length;
+        }
+        *p = in;
+        return total == cardinality;
+    }
+    if (cardinality > ARRAY_MAX) {
+        if ((size_t) (end - in) < BITMAP_BYTES) {
+            return false;
+        }
+        c->type = BITMAP;
+        c->words = container__alloc_words();
+        for (int k = 0; k < BITMAP_WORDS; k++, in += 8) {
+            c->words[k] = get64(in);
+        }
+        *p = in;
+        return words__popcount(c->words) == cardinality;
+    }
+    if ((size_t) (end - in) < 2 * (size_t) cardinality) {
+        return false;
+    }
+    container__reserve(c, cardinality);
+    for (uint32_t k = 0; k < cardinality; k++, in += 2) {
+        c->values[k] = get16(in);
+        c->length++;
+        if (k > 0 && c->values[k] <= c->values[k - 1]) {
+            return false;
+        }
+    }
+    *p = in;
+    return true;
+}
+
+Roaring* roaring_deserialize(const void *buffer, size_t length) {
+    const unsigned char *p = (const unsigned char*) buffer, *end = p + length;
+    const unsigned char *run_flags = NULL;
+    size_t n;
+    if (length < 4) {
+        return NULL;
+    }
+    uint32_t cookie = get32(p);
+    if ((cookie & 0xffff) == COOKIE) {
+        n = (cookie >> 16) + 1;
+        p += 4;
+        run_flags = p;
+        if ((size_t) (end - p) < (n + 7) / 8) {
+            return NULL;
+        }
+        p += (n + 7) / 8;
+    } else if (cookie == COOKIE_NO_RUN && length >= 8) {
+        n = get32(p + 4);
+        p += 8;
+        if (n > 65536) {
+            return NULL;
+        }
+    } else {
+        return NULL;
+    }
+    const unsigned char *header = p;
+    size_t header_bytes = run_flags == NULL || n >= NO_OFFSET_THRESHOLD ? 8 * n : 4 * n;
+    if ((size_t) (end - p) < header_bytes) {
+        return NULL;
+    }
+    p += header_bytes;
+    Roaring *r = roaring_create();
+    for (size_t i = 0; i < n; i++) {
+        uint16_t key = get16(header + 4 * i);
+        uint32_t cardinality = (uint32_t) get16(header + 4 * i + 2) + 1;
+        bool run = run_flags != NULL && (run_flags[i / 8] >> (i % 8) & 1);
+        if (i > 0 && key <= r->keys[i - 1]) {
+            roaring_free(r);
+            return NULL;
+        }
+        Container c;
+        if (!roaring__read_container(&p, end, run, cardinality, &c)) {
+            container__free(&c);
+            roaring_free(r);
+            return NULL;
+        }
+        roaring__append(r, key, c);
+    }
+    return r;
+}
+
+RoaringCursor roaring_cursor(const Roaring *r) {
+    RoaringCursor c;
+    memset(&c, 0, sizeof(c));
+    c.r = r;
+    return c;
+}
+
+bool roaring_cursor_next(RoaringCursor *c) {
+    const Roaring *r = c->r;
+    while (c->container < r->n) {
+        const Container *k = &r->containers[c->container];
+        uint32_t high = (uint32_t) r->keys[c->container] << 16;
+        switch (k->type) {
+        case ARRAY:
+            if (c->index < k->length) {
+                c->value = high | k->values[c->index++];
+                return true;
+            }
+            break;
+        case BITMAP:
+            while (c->bits == 0 && c->index < BITMAP_WORDS) {
+                c->bits = k->words[c->index++];
+            }
+            if (c->bits != 0) {
+                c->value = high | ((c->index - 1) * 64 + __builtin_ctzll(c->bits));
+                c->bits &= c->bits - 1;
+                return true;
+            }
+            break;
+        default:
+            if (c->next == c->end && c->index < k->length) {
+                c->next = run__start(k, c->index);
+                c->end = run__end(k, c->index) + 1;
+                c->index++;
+            }
+            if (c->next < c->end) {
+                c->value = high | c->next++;
+                return true;
+            }
+        }
+        c->container++;
+        c->index = 0;
+        c->bits = 0;
+        c->next = c->end = 0;
+    }
+    return false;
+}
+
+void roaring_free(Roaring *r) {
+    for (size_t i = 0; i < r->n; i++) {
+        container__free(&r->containers[i]);
+    }
+    free(r->keys);
+    free(r->containers);
+    free(r);
+}
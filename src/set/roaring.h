@@ -0,0 +1,214 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef ROARING_H
+#define ROARING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief A Roaring bitmap: a compressed set of 32-bit integers.
+ *
+ * The integers are split in chunks of 65536 by their 16 high bits, and the
+ * 16 low bits of each chunk are kept in the smallest of three containers:
+ * a sorted array for up to 4096 integers (2 bytes each), a bitmap of 8KB
+ * above that, or a list of runs of consecutive integers (4 bytes per run)
+ * after roaring_optimize(). Sets of millions of integers take from a few
+ * bits to 2 bytes per integer, whatever their density, and are combined a
+ * container at a time: two bitmaps word by word, two arrays by merging.
+ *
+ * @see Chambi et al., Better bitmap performance with Roaring bitmaps, 2016
+ * @see https://github.com/RoaringBitmap/RoaringFormatSpec for the format of
+ * roaring_serialize()
+ */
+typedef struct Roaring Roaring;
+
+/**
+ * @brief Cursor over the integers of a Roaring bitmap, in increasing order.
+ *
+ * Adding or removing integers invalidates the cursor.
+ */
+typedef struct RoaringCursor {
+    const Roaring *r;
+    size_t container;  /**< index of the current container */
+    uint32_t index;    /**< next value, word or run of the container */
+    uint64_t bits;     /**< bits of the current word not visited yet */
+    uint32_t next;     /**< next integer of the current run */
+    uint32_t end;      /**< one past the last integer of the current run */
+    uint32_t value;    /**< current integer */
+} RoaringCursor;
+
+/**
+ * @brief Create an empty Roaring bitmap
+ * @return pointer to the newly created bitmap
+ * @ingroup DataStructureMethods
+ */
+Roaring* roaring_create(void);
+
+/**
+ * @brief Create a copy of the bitmap
+ * @param r bitmap pointer
+ * @return pointer to the newly created bitmap
+ * @ingroup DataStructureMethods
+ */
+Roaring* roaring_copy(const Roaring *r);
+
+/**
+ * @brief Add an integer to the bitmap
+ * @param r bitmap pointer
+ * @param x integer to add
+ * @return true if x was not in the bitmap
+ * @ingroup DataStructureMethods
+ */
+bool roaring_add(Roaring *r, uint32_t x);
+
+/**
+ * @brief Remove an integer from the bitmap
+ * @param r bitmap pointer
+ * @param x integer to remove
+ * @return true if x was in the bitmap
+ * @ingroup DataStructureMethods
+ */
+bool roaring_remove(Roaring *r, uint32_t x);
+
+/**
+ * @brief Check if an integer is in the bitmap
+ * @param r bitmap pointer
+ * @param x integer to look for
+ * @ingroup DataStructureMethods
+ */
+bool roaring_contains(const Roaring *r, uint32_t x);
+
+/**
+ * @brief Get the number of integers in the bitmap
+ * @param r bitmap pointer
+ * @ingroup DataStructureMethods
+ */
+size_t roaring_size(const Roaring *r);
+
+/**
+ * @brief Intersection of bitmaps A and B
+ * @param a bitmap A
+ * @param b bitmap B
+ * @return pointer to the newly created bitmap
+ * @ingroup DataStructureMethods
+ */
+Roaring* roaring_and(const Roaring *a, const Roaring *b);
+
+/**
+ * @brief Union of bitmaps A and B
+ * @param a bitmap A
+ * @param b bitmap B
+ * @return pointer to the newly created bitmap
+ * @ingroup DataStructureMethods
+ */
+Roaring* roaring_or(const Roaring *a, const Roaring *b);
+
+/**
+ * @brief Difference of bitmaps A and B
+ * @param a bitmap A
+ * @param b bitmap B
+ * @return pointer to the newly created bitmap
+ * @ingroup DataStructureMethods
+ */
+Roaring* roaring_andnot(const Roaring *a, const Roaring *b);
+
+/**
+ * @brief Check if bitmap A is a subset of bitmap B
+ * @param a bitmap A
+ * @param b bitmap B
+ * @ingroup DataStructureMethods
+ */
+bool roaring_subset(const Roaring *a, const Roaring *b);
+
+/**
+ * @brief Check if bitmaps A and B hold the same integers
+ * @param a bitmap A
+ * @param b bitmap B
+ * @ingroup DataStructureMethods
+ */
+bool roaring_equal(const Roaring *a, const Roaring *b);
+
+/**
+ * @brief Turn the containers into runs where it saves memory, and back
+ *
+ * Runs are only chosen here: adds and removes keep a run container as such
+ * until it grows larger than the array or bitmap of its integers.
+ * @param r bitmap pointer
+ * @ingroup DataStructureMethods
+ */
+void roaring_optimize(Roaring *r);
+
+/**
+ * @brief Get the memory used by the bitmap
+ * @param r bitmap pointer
+ * @return bytes of the bitmap and its containers
+ * @ingroup DataStructureMethods
+ */
+size_t roaring_bytes(const Roaring *r);
+
+/**
+ * @brief Get the length of the serialization of the bitmap
+ * @param r bitmap pointer
+ * @return bytes written by roaring_serialize()
+ * @ingroup DataStructureMethods
+ */
+size_t roaring_serialized_size(const Roaring *r);
+
+/**
+ * @brief Write the bitmap in the portable Roaring format
+ *
+ * The format is little-endian whatever the machine, and read by the other
+ * Roaring implementations (CRoaring, Java, Go...).
+ * @param r bitmap pointer
+ * @param buffer at least roaring_serialized_size() bytes
+ * @return bytes written
+ * @ingroup DataStructureMethods
+ */
+size_t roaring_serialize(const Roaring *r, void *buffer);
+
+/**
+ * @brief Read a bitmap written in the portable Roaring format
+ * @param buffer serialized bitmap
+ * @param length bytes available in the buffer
+ * @return pointer to the newly created bitmap, NULL if the buffer is not a
+ * valid serialization
+ * @ingroup DataStructureMethods
+ */
+Roaring* roaring_deserialize(const void *buffer, size_t length);
+
+/**
+ * @brief Start a walk over the integers of the bitmap
+ * @param r bitmap pointer
+ * @return a cursor placed before the first integer
+ * @ingroup DataStructureMethods
+ */
+RoaringCursor roaring_cursor(const Roaring *r);
+
+/**
+ * @brief Move the cursor to the next integer
+ * @param c cursor pointer, its value is set to the new integer
+ * @return false when there are no more integers, true otherwise
+ * @ingroup DataStructureMethods
+ */
+bool roaring_cursor_next(RoaringCursor *c);
+
+/**
+ * @brief Free memory of the bitmap
+ * @param r bitmap pointer
+ * @ingroup DataStructureMethods
+ */
+void roaring_free(Roaring *r);
+
+#endif /* ROARING_H */
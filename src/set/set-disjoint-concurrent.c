@@ -0,0 +1,98 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include "set-disjoint-concurrent.h"
+#include "../utils/check_alloc.h"
+
+struct DisjointSetConcurrent {
+    int n;
+    // followed by the parent of each element, accessed atomically
+};
+
+static inline int* set_disjoint_concurrent__parent(DisjointSetConcurrent *ds) {
+    return (int*) (ds + 1);
+}
+
+DisjointSetConcurrent* set_disjoint_concurrent_create(int n) {
+    DisjointSetConcurrent *ds = (DisjointSetConcurrent*) malloc(sizeof(DisjointSetConcurrent) + n * sizeof(int));
+    check_alloc(ds);
+    ds->n = n;
+    int *parent = set_disjoint_concurrent__parent(ds);
+    for (int i = 0; i < n; i++) {
+        parent[i] = i;
+    }
+    return ds;
+}
+
+int set_disjoint_concurrent_find(DisjointSetConcurrent *ds, int i) {
+    int *parent = set_disjoint_concurrent__parent(ds);
+    for (;;) {
+        int p = __atomic_load_n(&parent[i], __ATOMIC_ACQUIRE);
+        if (p == i) {
+            return i;
+        }
+        int grandparent = __atomic_load_n(&parent[p], __ATOMIC_ACQUIRE);
+        if (grandparent != p) {
+            // path halving, lost to any other thread changing the parent of i:
+            // either way, the new parent is an ancestor of i
+            __atomic_compare_exchange_n(&parent[i], &p, grandparent, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+        }
+        i = grandparent;
+    }
+}
+
+bool set_disjoint_concurrent_union(DisjointSetConcurrent *ds, int i, int j) {
+    int *parent = set_disjoint_concurrent__parent(ds);
+    for (;;) {
+        i = set_disjoint_concurrent_find(ds, i);
+        j = set_disjoint_concurrent_find(ds, j);
+        if (i == j) {
+            return false;
+        }
+        if (i < j) {
+            int t = i;
+            i = j;
+            j = t;
+        }
+        // the largest root goes under the smallest one, if still a root
+        int expected = i;
+        if (__atomic_compare_exchange_n(&parent[i], &expected, j, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+    }
+}
+
+bool set_disjoint_concurrent_same(DisjointSetConcurrent *ds, int i, int j) {
+    int *parent = set_disjoint_concurrent__parent(ds);
+    for (;;) {
+        i = set_disjoint_concurrent_find(ds, i);
+        j = set_disjoint_concurrent_find(ds, j);
+        if (i == j) {
+            return true;
+        }
+        // different roots, unless i was linked meanwhile
+        if (__atomic_load_n(&parent[i], __ATOMIC_ACQUIRE) == i) {
+            return false;
+        }
+    }
+}
+
+int set_disjoint_concurrent_size(DisjointSetConcurrent *ds) {
+    return ds->n;
+}
+
+void set_disjoint_concurrent_free(DisjointSetConcurrent *ds) {
+    free(ds);
+}
@@ -0,0 +1,86 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef SET_DISJOINT_CONCURRENT_H
+#define SET_DISJOINT_CONCURRENT_H
+
+#include <stdbool.h>
+
+/**
+ * @brief A thread-safe and lock-free disjoint-set data structure.
+ *
+ * Any number of threads can find and merge sets at the same time, as the
+ * parallel connected components or Kruskal's algorithm do. A union links a
+ * root under another one by a compare-and-swap of its parent, retried from
+ * the new roots when another thread linked it first, and finds halve their
+ * path by compare-and-swap too. Roots are always linked under the smallest
+ * one, so that the representative of a set is its smallest element, whatever
+ * the order of the unions: threads agree on the labels of the sets.
+ *
+ * The number of elements is fixed at creation.
+ * @see Jayanti and Tarjan, Concurrent disjoint set union, 2021
+ */
+typedef struct DisjointSetConcurrent DisjointSetConcurrent;
+
+/**
+ * @brief Create a concurrent disjoint-set of n elements, each one in a set of its own
+ * @param n number of elements
+ * @return pointer to the newly created disjoint-set
+ * @ingroup DataStructureMethods
+ */
+DisjointSetConcurrent* set_disjoint_concurrent_create(int n);
+
+/**
+ * @brief Find the representative of the set containing an element, thread-safe
+ * @param ds disjoint-set pointer
+ * @param i element
+ * @return the smallest element of the set containing i, as of some point of the call
+ * @ingroup DataStructureMethods
+ */
+int set_disjoint_concurrent_find(DisjointSetConcurrent *ds, int i);
+
+/**
+ * @brief Merge the sets containing two elements, thread-safe
+ * @param ds disjoint-set pointer
+ * @param i first element
+ * @param j second element
+ * @return true if this call merged them, false if they were in the same set
+ * @ingroup DataStructureMethods
+ */
+bool set_disjoint_concurrent_union(DisjointSetConcurrent *ds, int i, int j);
+
+/**
+ * @brief Check if two elements are in the same set, thread-safe
+ * @param ds disjoint-set pointer
+ * @param i first element
+ * @param j second element
+ * @ingroup DataStructureMethods
+ */
+bool set_disjoint_concurrent_same(DisjointSetConcurrent *ds, int i, int j);
+
+/**
+ * @brief Get the number of elements of the disjoint-set
+ * @param ds disjoint-set pointer
+ * @ingroup DataStructureMethods
+ */
+int set_disjoint_concurrent_size(DisjointSetConcurrent *ds);
+
+/**
+ * @brief Free memory of the disjoint-set
+ *
+ * No other thread may be using it.
+ * @param ds disjoint-set pointer
+ * @ingroup DataStructureMethods
+ */
+void set_disjoint_concurrent_free(DisjointSetConcurrent *ds);
+
+#endif /* SET_DISJOINT_CONCURRENT_H */
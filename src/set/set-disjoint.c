@@ -4,52 +4,89 @@
 
 struct DisjointSet {
     int *parent;
-    int *rank;
+    int *size;      // elements of the set, for the roots only
     int n;
+    int capacity;
+    int n_sets;
 };
 
 DisjointSet *set_disjoint_create(int n) {
     DisjointSet *ds = (DisjointSet *)malloc(sizeof(DisjointSet));
     check_alloc(ds);
-    ds->n = n;
-    ds->parent = (int *)malloc(sizeof(int) * n);
-    check_alloc(ds->parent);
-    ds->rank = (int *)malloc(sizeof(int) * n);
-    check_alloc(ds->rank);
-    for (int i = 0; i < n; i++) {
-        ds->parent[i] = i;
-        ds->rank[i] = 0;
-    }
+    ds->n = 0;
+    ds->capacity = 0;
+    ds->n_sets = 0;
+    ds->parent = NULL;
+    ds->size = NULL;
+    set_disjoint_grow(ds, n);
     return ds;
 }
 
 void set_disjoint_free(DisjointSet *ds) {
     free(ds->parent);
-    free(ds->rank);
+    free(ds->size);
     free(ds);
 }
 
-// Find with path compression
+void set_disjoint_grow(DisjointSet *ds, int n) {
+    if (n <= ds->n) {
+        return;
+    }
+    if (n > ds->capacity) {
+        int capacity = ds->capacity > 0 ? ds->capacity : 16;
+        while (capacity < n) {
+            capacity *= 2;
+        }
+        ds->parent = (int *)realloc(ds->parent, sizeof(int) * capacity);
+        check_alloc(ds->parent);
+        ds->size = (int *)realloc(ds->size, sizeof(int) * capacity);
+        check_alloc(ds->size);
+        ds->capacity = capacity;
+    }
+    for (int i = ds->n; i < n; i++) {
+        ds->parent[i] = i;
+        ds->size[i] = 1;
+    }
+    ds->n_sets += n - ds->n;
+    ds->n = n;
+}
+
+// Find with path halving: each element visited skips to its grandparent
 int set_disjoint_find(DisjointSet *ds, int i) {
-    if (ds->parent[i] != i) {
-        ds->parent[i] = set_disjoint_find(ds, ds->parent[i]);
+    while (ds->parent[i] != i) {
+        ds->parent[i] = ds->parent[ds->parent[i]];
+        i = ds->parent[i];
     }
-    return ds->parent[i];
+    return i;
 }
 
-// Union by rank
-void set_disjoint_union(DisjointSet *ds, int i, int j) {
+// Union by size
+bool set_disjoint_union(DisjointSet *ds, int i, int j) {
     int root_i = set_disjoint_find(ds, i);
     int root_j = set_disjoint_find(ds, j);
 
-    if (root_i != root_j) {
-        if (ds->rank[root_i] < ds->rank[root_j]) {
-            ds->parent[root_i] = root_j;
-        } else if (ds->rank[root_i] > ds->rank[root_j]) {
-            ds->parent[root_j] = root_i;
-        } else {
-            ds->parent[root_j] = root_i;
-            ds->rank[root_i]++;
-        }
+    if (root_i == root_j) {
+        return false;
+    }
+    if (ds->size[root_i] < ds->size[root_j]) {
+        int root = root_i;
+        root_i = root_j;
+        root_j = root;
     }
+    ds->parent[root_j] = root_i;
+    ds->size[root_i] += ds->size[root_j];
+    ds->n_sets--;
+    return true;
+}
+
+int set_disjoint_set_size(DisjointSet *ds, int i) {
+    return ds->size[set_disjoint_find(ds, i)];
+}
+
+int set_disjoint_size(DisjointSet *ds) {
+    return ds->n;
+}
+
+int set_disjoint_count(DisjointSet *ds) {
+    return ds->n_sets;
 }
@@ -1,8 +1,18 @@
 #ifndef SET_DISJOINT_H
 #define SET_DISJOINT_H
 
+#include <stdbool.h>
+
 /**
  * @brief A disjoint-set data structure.
+ *
+ * The elements are the integers from 0 to set_disjoint_size() - 1, each
+ * set being a tree of them. Finds halve the path to the root as they walk
+ * it, without recursion, and unions link the root of the smallest set under
+ * the other one, so that trees stay shallow. Elements can be added at any
+ * time by set_disjoint_grow(), as new ids come in.
+ *
+ * A thread-safe variant is in set-disjoint-concurrent.h.
  * @see https://en.wikipedia.org/wiki/Disjoint-set_data_structure
  */
 typedef struct DisjointSet DisjointSet;
@@ -22,6 +32,15 @@ DisjointSet *set_disjoint_create(int n);
  */
 void set_disjoint_free(DisjointSet *ds);
 
+/**
+ * @brief Adds elements, each one in a set of its own.
+ *
+ * @param[in,out] ds The disjoint-set.
+ * @param[in] n The number of elements wanted, nothing is done if the
+ * disjoint-set has as many already.
+ */
+void set_disjoint_grow(DisjointSet *ds, int n);
+
 /**
  * @brief Finds the representative of the set containing element i.
  *
@@ -37,7 +56,30 @@ int set_disjoint_find(DisjointSet *ds, int i);
  * @param[in,out] ds The disjoint-set.
  * @param[in] i The first element.
  * @param[in] j The second element.
+ * @return true if they were in different sets, false otherwise.
+ */
+bool set_disjoint_union(DisjointSet *ds, int i, int j);
+
+/**
+ * @brief Number of elements of the set containing element i.
+ *
+ * @param[in] ds The disjoint-set.
+ * @param[in] i The element.
+ */
+int set_disjoint_set_size(DisjointSet *ds, int i);
+
+/**
+ * @brief Number of elements of the disjoint-set.
+ *
+ * @param[in] ds The disjoint-set.
+ */
+int set_disjoint_size(DisjointSet *ds);
+
+/**
+ * @brief Number of disjoint sets.
+ *
+ * @param[in] ds The disjoint-set.
  */
-void set_disjoint_union(DisjointSet *ds, int i, int j);
+int set_disjoint_count(DisjointSet *ds);
 
 #endif /* SET_DISJOINT_H */
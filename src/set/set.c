@@ -1,40 +1,455 @@
+#define _POSIX_C_SOURCE 200112L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <limits.h>
 #include "../hash-table/hash-table.h"
 #include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+#include "roaring.h"
 #include "set.h"
 
-#define SET_DEFAULT_HASH_MAP_SIZE 128
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define SET_DEFAULT_HASH_MAP_SIZE 16
 #define SET_DEFAULT_HASH_MAP_VALUE 1
 
+#define WORD_BITS 64
+#define LINE_WORDS 8      // words of a cache line, the bitset grows by powers of two from it
+#define CACHE_LINE 64
+#define SPARSE_BITS (4 * SET_BITSET_DENSITY)
+#define PARALLEL_TASKS 4  // tasks of a parallel operation per thread, to balance the load
+
 struct Set {
-    HashTable *memory;
+    SetType type;
+    HashTable *memory;      // elements and values of a hash table
+    Roaring *roaring;
+    uint64_t *words;        // bit e % 64 of word e / 64 for the element e, aligned to a cache line
+    size_t n_words;
+    size_t size;            // elements of the bitset or of the small set
+    bool automatic;         // switch between both as the density changes
+    size_t next_check;      // size of the hash table checked next for a promotion
+    HashTableFilter filter; // of the hash table, kept when it is dropped
+    int keys[SET_SMALL_CAPACITY];   // elements of the small set, increasing
+    int values[SET_SMALL_CAPACITY]; // and their values
 };
 
+typedef enum SetOp { SET_OR, SET_AND, SET_AND_NOT } SetOp;
 
-Set* set_create() {
+
+static Set* set__alloc(bool automatic) {
     Set *set = (Set*) malloc(sizeof(Set));
     check_alloc(set);
+    set->type = SET_HASH_TABLE;
+    set->memory = NULL;
+    set->roaring = NULL;
+    set->words = NULL;
+    set->n_words = 0;
+    set->size = 0;
+    set->automatic = automatic;
+    set->next_check = SET_BITSET_MIN_SIZE;
+    set->filter = HASH_TABLE_FILTER_NONE;
+    memset(set->keys, 0, sizeof(set->keys));
+    memset(set->values, 0, sizeof(set->values));
+    return set;
+}
+
+static uint64_t* set__alloc_words(size_t n_words) {
+    void *words = NULL;
+    if (posix_memalign(&words, CACHE_LINE, n_words * sizeof(uint64_t)) != 0) {
+        words = NULL;
+    }
+    check_alloc(words);
+    return (uint64_t*) words;
+}
+
+// words to hold the element, a power of two of at least a cache line
+static size_t set__words_for(int element) {
+    size_t n = hash_round_pow2((size_t) element / WORD_BITS + 1);
+    return n > LINE_WORDS ? n : LINE_WORDS;
+}
+
+static void set__grow(Set *set, size_t n_words) {
+    uint64_t *words = set__alloc_words(n_words);
+    if (set->n_words > 0) {
+        memcpy(words, set->words, set->n_words * sizeof(uint64_t));
+    }
+    memset(words + set->n_words, 0, (n_words - set->n_words) * sizeof(uint64_t));
+    free(set->words);
+    set->words = words;
+    set->n_words = n_words;
+}
+
+static inline bool set__bit(const Set *set, int element) {
+    size_t i = (size_t) element / WORD_BITS;
+    return element >= 0 && i < set->n_words && (set->words[i] >> (element % WORD_BITS) & 1);
+}
+
+static size_t set__popcount(const uint64_t *words, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        count += __builtin_popcountll(words[i]);
+    }
+    return count;
+}
+
+static void set__to_bitset(Set *set, int max) {
+    set->n_words = 0;
+    set->words = NULL;
+    set__grow(set, set__words_for(max));
+    HashTableCursor c = hash_table_cursor(set->memory);
+    while (hash_table_cursor_next(&c)) {
+        set->words[c.key / WORD_BITS] |= (uint64_t) 1 << (c.key % WORD_BITS);
+    }
+    set->size = hash_table_size(set->memory);
+    hash_table_free(set->memory);
+    set->memory = NULL;
+    set->type = SET_BITSET;
+}
+
+// a bitset, Roaring or small set turned into a hash table of its elements
+static void set__to_hash_table(Set *set) {
+    size_t size = (size_t) set_size(set);
+    HashTable *memory = hash_table_create(size > SET_DEFAULT_HASH_MAP_SIZE ? size : SET_DEFAULT_HASH_MAP_SIZE);
+    SetCursor c = set_cursor(set);
+    while (set_cursor_next(&c)) {
+        hash_table_put(memory, c.key, c.value);
+    }
+    if (set->filter != HASH_TABLE_FILTER_NONE) {
+        hash_table_use_filter(memory, set->filter);
+    }
+    if (set->roaring != NULL) {
+        roaring_free(set->roaring);
+    }
+    free(set->words);
+    set->words = NULL;
+    set->n_words = 0;
+    set->roaring = NULL;
+    set->memory = memory;
+    set->type = SET_HASH_TABLE;
+    set->next_check = 2 * size > SET_BITSET_MIN_SIZE ? 2 * size : SET_BITSET_MIN_SIZE;
+}
+
+// check the hash table at each doubling of its size, so that the walk is
+// amortized over the insertions
+static void set__try_promote(Set *set) {
+    size_t size = hash_table_size(set->memory);
+    if (!set->automatic || size < set->next_check) {
+        return;
+    }
+    set->next_check = 2 * size;
+    int max = 0;
+    HashTableCursor c = hash_table_cursor(set->memory);
+    while (hash_table_cursor_next(&c)) {
+        if (c.key < 0 || c.value != SET_DEFAULT_HASH_MAP_VALUE) {
+            return;
+        }
+        max = c.key > max ? c.key : max;
+    }
+    if ((size_t) max < SET_BITSET_DENSITY * size) {
+        set__to_bitset(set, max);
+    }
+}
+
+// an automatic bitset much larger than its elements goes back to a hash table
+static void set__try_demote(Set *set) {
+    if (set->automatic && set->n_words > LINE_WORDS && set->n_words * WORD_BITS > SPARSE_BITS * set->size) {
+        set__to_hash_table(set);
+    }
+}
+
+static Set* set__create_bitset(size_t n_words, bool automatic) {
+    Set *set = set__alloc(automatic);
+    set->type = SET_BITSET;
+    set->n_words = n_words > LINE_WORDS ? n_words : LINE_WORDS;
+    set->words = set__alloc_words(set->n_words);
+    memset(set->words, 0, set->n_words * sizeof(uint64_t));
+    return set;
+}
+
+static inline uint64_t set__op(uint64_t a, uint64_t b, SetOp op) {
+    switch (op) {
+    case SET_OR:
+        return a | b;
+    case SET_AND:
+        return a & b;
+    default:
+        return a & ~b;
+    }
+}
+
+#ifdef __AVX2__
+static inline __m256i set__op256(__m256i a, __m256i b, SetOp op) {
+    switch (op) {
+    case SET_OR:
+        return _mm256_or_si256(a, b);
+    case SET_AND:
+        return _mm256_and_si256(a, b);
+    default:
+        return _mm256_andnot_si256(b, a);
+    }
+}
+
+// bits set in each 64-bit lane, counted by nibbles with a lookup table
+static inline __m256i set__popcount256(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+    __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+#endif
+
+// out = a op b over n words, returning the bits set in out; the words are
+// aligned to a cache line and n is a multiple of LINE_WORDS
+static inline size_t set__combine(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t n, SetOp op) {
+    size_t count = 0;
+#ifdef __AVX2__
+    __m256i counts = _mm256_setzero_si256();
+    for (size_t i = 0; i < n; i += 4) {
+        __m256i x = set__op256(_mm256_load_si256((const __m256i*) (a + i)),
+                               _mm256_load_si256((const __m256i*) (b + i)), op);
+        _mm256_store_si256((__m256i*) (out + i), x);
+        counts = _mm256_add_epi64(counts, set__popcount256(x));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*) lanes, counts);
+    count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#else
+    for (size_t i = 0; i < n; i++) {
+        out[i] = set__op(a[i], b[i], op);
+        count += __builtin_popcountll(out[i]);
+    }
+#endif
+    return count;
+}
+
+// whether no bit of a is missing from b, over n words as in set__combine()
+static bool set__words_subset(const uint64_t *a, const uint64_t *b, size_t n) {
+#ifdef __AVX2__
+    for (size_t i = 0; i < n; i += 4) {
+        if (!_mm256_testc_si256(_mm256_load_si256((const __m256i*) (b + i)),
+                                _mm256_load_si256((const __m256i*) (a + i)))) {
+            return false;
+        }
+    }
+#else
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] & ~b[i]) {
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+static bool set__words_zero(const uint64_t *words, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        if (words[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// a op b of two bitsets, the words of the longest one beyond the other are
+// copied for OR and for the a of AND_NOT
+static Set* set__bitset_op(Set *set_a, Set *set_b, SetOp op) {
+    size_t n = set_a->n_words < set_b->n_words ? set_a->n_words : set_b->n_words;
+    Set *longest = set_a->n_words > set_b->n_words ? set_a : set_b;
+    size_t n_words = op == SET_OR ? longest->n_words : op == SET_AND ? n : set_a->n_words;
+    Set *set_new = set__create_bitset(n_words, set_a->automatic);
+    set_new->size = set__combine(set_new->words, set_a->words, set_b->words, n, op);
+    if (n_words > n) {
+        const uint64_t *rest = (op == SET_OR ? longest : set_a)->words + n;
+        memcpy(set_new->words + n, rest, (n_words - n) * sizeof(uint64_t));
+        set_new->size += set__popcount(rest, n_words - n);
+    }
+    set__try_demote(set_new);
+    return set_new;
+}
+
+// index of the element in the small set, its size when it is not there
+static inline size_t set__small_index(const Set *set, int element) {
+#if defined(__SSE2__) && SET_SMALL_CAPACITY % 4 == 0 && SET_SMALL_CAPACITY < 32
+    __m128i x = _mm_set1_epi32(element);
+    unsigned mask = 0;
+    for (size_t i = 0; i < SET_SMALL_CAPACITY; i += 4) {
+        __m128i keys = _mm_loadu_si128((const __m128i*) (set->keys + i));
+        mask |= (unsigned) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(keys, x))) << i;
+    }
+    mask &= (1u << set->size) - 1;
+    return mask != 0 ? (size_t) __builtin_ctz(mask) : set->size;
+#else
+    size_t i = 0;
+    while (i < set->size && set->keys[i] != element) {
+        i++;
+    }
+    return i;
+#endif
+}
+
+// put the element in order in the small set, false when it is full
+static bool set__small_put(Set *set, int element, int value) {
+    size_t i = set__small_index(set, element);
+    if (i < set->size) {
+        set->values[i] = value;
+        return true;
+    }
+    if (set->size == SET_SMALL_CAPACITY) {
+        return false;
+    }
+    for (i = set->size; i > 0 && set->keys[i - 1] > element; i--) {
+        set->keys[i] = set->keys[i - 1];
+        set->values[i] = set->values[i - 1];
+    }
+    set->keys[i] = element;
+    set->values[i] = value;
+    set->size++;
+    return true;
+}
+
+static void set__small_remove(Set *set, int element) {
+    size_t i = set__small_index(set, element);
+    if (i == set->size) {
+        return;
+    }
+    set->size--;
+    memmove(set->keys + i, set->keys + i + 1, (set->size - i) * sizeof(int));
+    memmove(set->values + i, set->values + i + 1, (set->size - i) * sizeof(int));
+}
+
+static Set* set__create_roaring(Roaring *r) {
+    Set *set = set__alloc(false);
+    set->type = SET_ROARING;
+    set->roaring = r;
+    return set;
+}
+
+// the elements of any set as a new Roaring bitmap
+static Roaring* set__roaring_of(Set *set) {
+    if (set->type == SET_ROARING) {
+        return roaring_copy(set->roaring);
+    }
+    Roaring *r = roaring_create();
+    SetCursor c = set_cursor(set);
+    while (set_cursor_next(&c)) {
+        roaring_add(r, (uint32_t) c.key);
+    }
+    return r;
+}
+
+
+Set* set_create() {
+    Set *set = set__alloc(true);
     set->memory = hash_table_create(SET_DEFAULT_HASH_MAP_SIZE);
     return set;
 }
 
+Set* set_create_with_type(SetType type) {
+    if (type == SET_BITSET) {
+        return set__create_bitset(LINE_WORDS, false);
+    }
+    if (type == SET_ROARING) {
+        return set__create_roaring(roaring_create());
+    }
+    if (type == SET_SMALL) {
+        Set *set = set__alloc(true);
+        set->type = SET_SMALL;
+        return set;
+    }
+    Set *set = set__alloc(false);
+    set->memory = hash_table_create(SET_DEFAULT_HASH_MAP_SIZE);
+    return set;
+}
+
+SetType set_type(Set *set) {
+    return set->type;
+}
+
 int set_size(Set *set) {
-    return hash_table_size(set->memory);
+    switch (set->type) {
+    case SET_BITSET:
+    case SET_SMALL:
+        return (int) set->size;
+    case SET_ROARING:
+        return (int) roaring_size(set->roaring);
+    default:
+        return hash_table_size(set->memory);
+    }
 }
 
 Set* set_copy(Set *set) {
-    Set *set_new = set_create();
-    hash_table_free(set_new->memory);
-    set_new->memory = hash_table_copy(set->memory);
+    Set *set_new = set__alloc(set->automatic);
+    set_new->type = set->type;
+    set_new->next_check = set->next_check;
+    set_new->filter = set->filter;
+    if (set->type == SET_HASH_TABLE) {
+        set_new->memory = hash_table_copy(set->memory);
+        return set_new;
+    }
+    if (set->type == SET_ROARING) {
+        set_new->roaring = roaring_copy(set->roaring);
+        return set_new;
+    }
+    if (set->type == SET_SMALL) {
+        memcpy(set_new->keys, set->keys, sizeof(set->keys));
+        memcpy(set_new->values, set->values, sizeof(set->values));
+        set_new->size = set->size;
+        return set_new;
+    }
+    set_new->words = set__alloc_words(set->n_words);
+    memcpy(set_new->words, set->words, set->n_words * sizeof(uint64_t));
+    set_new->n_words = set->n_words;
+    set_new->size = set->size;
     return set_new;
 }
 
 
 void set_add_with_value(Set *set, int element, int value) {
+    if (set->type == SET_SMALL) {
+        if (set__small_put(set, element, value)) {
+            return;
+        }
+        set__to_hash_table(set);
+    }
+    if (set->type == SET_ROARING) {
+        if (value == SET_DEFAULT_HASH_MAP_VALUE) {
+            roaring_add(set->roaring, (uint32_t) element);
+            return;
+        }
+        set__to_hash_table(set);
+    }
+    if (set->type == SET_BITSET) {
+        if (element >= 0 && value == SET_DEFAULT_HASH_MAP_VALUE) {
+            if ((size_t) element / WORD_BITS >= set->n_words) {
+                size_t n_words = set__words_for(element);
+                if (set->automatic && n_words * WORD_BITS > SPARSE_BITS * (set->size + 1)) {
+                    set__to_hash_table(set);
+                    hash_table_put(set->memory, element, value);
+                    return;
+                }
+                set__grow(set, n_words);
+            }
+            uint64_t *word = &set->words[element / WORD_BITS];
+            uint64_t bit = (uint64_t) 1 << (element % WORD_BITS);
+            set->size += (*word & bit) == 0;
+            *word |= bit;
+            return;
+        }
+        set__to_hash_table(set);
+    }
     hash_table_put(set->memory, element, value);
+    set__try_promote(set);
 }
 
 void set_add(Set *set, int element) {
@@ -42,6 +457,13 @@ void set_add(Set *set, int element) {
 }
 
 int set_get_value(Set *set, int element) {
+    if (set->type == SET_SMALL) {
+        size_t i = set__small_index(set, element);
+        return i < set->size ? set->values[i] : 0;
+    }
+    if (set->type != SET_HASH_TABLE) {
+        return set_contains(set, element) ? SET_DEFAULT_HASH_MAP_VALUE : 0;
+    }
     bool exists;
     int value = hash_table_get(set->memory, element, &exists);
     if (exists) {
@@ -65,26 +487,26 @@ Set* set_init(int set_size,...) {
 }
 
 bool set_subset(Set *set_a, Set *set_b) {
-    List* keys_begin = hash_table_keys(set_a->memory);
-    List* keys = keys_begin;
-    bool checking = true;
-    while (!list_empty(keys)) {
-        bool exists;
-        int element = keys->data;
-        hash_table_get(set_b->memory, element, &exists);
-        if (!exists) {
-            checking = false;
-            break;
+    if (set_a->type == SET_ROARING && set_b->type == SET_ROARING) {
+        return roaring_subset(set_a->roaring, set_b->roaring);
+    }
+    if (set_a->type == SET_BITSET && set_b->type == SET_BITSET) {
+        size_t n = set_a->n_words < set_b->n_words ? set_a->n_words : set_b->n_words;
+        return set__words_subset(set_a->words, set_b->words, n)
+            && set__words_zero(set_a->words + n, set_a->n_words - n);
+    }
+    SetCursor c = set_cursor(set_a);
+    while (set_cursor_next(&c)) {
+        if (!set_contains(set_b, c.key)) {
+            return false;
         }
-        keys = keys->next;
     }
-    list_free(keys_begin);
-    return checking;
+    return true;
 }
 
 
 bool set_equal(Set *set_a, Set *set_b) {
-    if (hash_table_size(set_a->memory) != hash_table_size(set_b->memory)) {
+    if (set_size(set_a) != set_size(set_b)) {
         return false;
     }
     return set_subset(set_a, set_b);
@@ -92,94 +514,557 @@ bool set_equal(Set *set_a, Set *set_b) {
 
 
 Set* set_intersection(Set *set_a, Set *set_b) {
+    if (set_a->type == SET_ROARING && set_b->type == SET_ROARING) {
+        return set__create_roaring(roaring_and(set_a->roaring, set_b->roaring));
+    }
+    if (set_a->type == SET_BITSET && set_b->type == SET_BITSET) {
+        return set__bitset_op(set_a, set_b, SET_AND);
+    }
     Set* set_new = set_create();
-    List* keys_begin = hash_table_keys(set_a->memory);
-    List* keys = keys_begin;
-    while (!list_empty(keys)) {
-        bool exists;
-        int element = keys->data;
-        hash_table_get(set_b->memory, element, &exists);
-        if (exists) {
-            set_add(set_new, element);
-        }
-        keys = keys->next;
-    }
-    list_free(keys_begin);
+    SetCursor c = set_cursor(set_a);
+    while (set_cursor_next(&c)) {
+        if (set_contains(set_b, c.key)) {
+            set_add(set_new, c.key);
+        }
+    }
     return set_new;
 }
 
 
 Set* set_union(Set *set_a, Set *set_b) {
-    List* keys_a = hash_table_keys(set_a->memory);
-    List* keys_b = hash_table_keys(set_b->memory);
-    List* keys_begin = list_concat(keys_a, keys_b);
-    List* keys = keys_begin;
+    if (set_a->type == SET_ROARING && set_b->type == SET_ROARING) {
+        return set__create_roaring(roaring_or(set_a->roaring, set_b->roaring));
+    }
+    if (set_a->type == SET_BITSET && set_b->type == SET_BITSET) {
+        return set__bitset_op(set_a, set_b, SET_OR);
+    }
     Set* set_new = set_create();
-    while (!list_empty(keys)) {
-        set_add(set_new, keys->data);
-        keys = keys->next;
+    SetCursor c = set_cursor(set_a);
+    while (set_cursor_next(&c)) {
+        set_add(set_new, c.key);
+    }
+    c = set_cursor(set_b);
+    while (set_cursor_next(&c)) {
+        set_add(set_new, c.key);
     }
-    list_free(keys_a);
-    list_free(keys_b);
-    list_free(keys_begin);
     return set_new;
 }
 
 
 Set* set_difference(Set *set_a, Set *set_b) {
+    if (set_a->type == SET_ROARING && set_b->type == SET_ROARING) {
+        return set__create_roaring(roaring_andnot(set_a->roaring, set_b->roaring));
+    }
+    if (set_a->type == SET_BITSET && set_b->type == SET_BITSET) {
+        return set__bitset_op(set_a, set_b, SET_AND_NOT);
+    }
     Set* set_new = set_create();
-    List* keys_begin = hash_table_keys(set_a->memory);
-    List* keys = keys_begin;
-    while (!list_empty(keys)) {
-        bool exists;
-        int element = keys->data;
-        hash_table_get(set_b->memory, element, &exists);
-        keys = keys->next;
-        if (exists) {
-            continue;
-        }
-        set_add(set_new, element);
-    }
-    list_free(keys_begin);
+    SetCursor c = set_cursor(set_a);
+    while (set_cursor_next(&c)) {
+        if (!set_contains(set_b, c.key)) {
+            set_add(set_new, c.key);
+        }
+    }
     return set_new;
 }
 
 
 void set_remove(Set *set, int element) {
+    if (set->type == SET_ROARING) {
+        roaring_remove(set->roaring, (uint32_t) element);
+        return;
+    }
+    if (set->type == SET_BITSET) {
+        if (set__bit(set, element)) {
+            set->words[element / WORD_BITS] &= ~((uint64_t) 1 << (element % WORD_BITS));
+            set->size--;
+            set__try_demote(set);
+        }
+        return;
+    }
+    if (set->type == SET_SMALL) {
+        set__small_remove(set, element);
+        return;
+    }
     hash_table_remove(set->memory, element);
 }
 
 
 bool set_contains(Set *set, int element) {
+    if (set->type == SET_ROARING) {
+        return roaring_contains(set->roaring, (uint32_t) element);
+    }
+    if (set->type == SET_BITSET) {
+        return set__bit(set, element);
+    }
+    if (set->type == SET_SMALL) {
+        return set__small_index(set, element) < set->size;
+    }
     bool exists;
     hash_table_get(set->memory, element, &exists);
     return exists;
 }
 
 
+void set_contains_many(Set *set, const int *elements, size_t n, bool *contains) {
+    if (set->type != SET_HASH_TABLE) {
+        for (size_t i = 0; i < n; i++) {
+            contains[i] = set_contains(set, elements[i]);
+        }
+        return;
+    }
+    hash_table_get_many(set->memory, elements, n, NULL, contains);
+}
+
+void set_use_filter(Set *set, HashTableFilter filter) {
+    set->filter = filter;
+    if (set->type == SET_HASH_TABLE) {
+        hash_table_use_filter(set->memory, filter);
+    }
+}
+
+HashTableStats set_stats(Set *set) {
+    if (set->type == SET_HASH_TABLE) {
+        return hash_table_stats(set->memory);
+    }
+    HashTableStats stats;
+    memset(&stats, 0, sizeof(stats));
+    stats.type = HASH_TABLE_CHAINING;
+    stats.size = (size_t) set_size(set);
+    if (set->type == SET_ROARING) {
+        stats.bytes = sizeof(Set) + roaring_bytes(set->roaring);
+        return stats;
+    }
+    if (set->type == SET_SMALL) {
+        stats.n_buckets = 1;
+        stats.max_length = set->size;
+        stats.load_factor = (double) set->size / SET_SMALL_CAPACITY;
+        stats.bytes = sizeof(Set);
+        return stats;
+    }
+    stats.n_buckets = set->n_words;
+    stats.load_factor = (double) set->size / (set->n_words * WORD_BITS);
+    stats.bytes = sizeof(Set) + set->n_words * sizeof(uint64_t);
+    return stats;
+}
+
+void set_optimize(Set *set) {
+    if (set->type == SET_ROARING) {
+        roaring_optimize(set->roaring);
+    }
+}
+
+size_t set_serialized_size(Set *set) {
+    if (set->type == SET_ROARING) {
+        return roaring_serialized_size(set->roaring);
+    }
+    Roaring *r = set__roaring_of(set);
+    size_t size = roaring_serialized_size(r);
+    roaring_free(r);
+    return size;
+}
+
+size_t set_serialize(Set *set, void *buffer) {
+    if (set->type == SET_ROARING) {
+        return roaring_serialize(set->roaring, buffer);
+    }
+    Roaring *r = set__roaring_of(set);
+    size_t size = roaring_serialize(r, buffer);
+    roaring_free(r);
+    return size;
+}
+
+Set* set_deserialize(const void *buffer, size_t length) {
+    Roaring *r = roaring_deserialize(buffer, length);
+    return r != NULL ? set__create_roaring(r) : NULL;
+}
+
+
 void set_print(Set *set) {
-    hash_table_print_keys(set->memory);
+    List *elements = list_create();
+    SetCursor c = set_cursor(set);
+    while (set_cursor_next(&c)) {
+        elements = list_insert(elements, c.key);
+    }
+    list_println_reverse(elements);
+    list_free(elements);
 }
 
 
 void set_print_items(Set *set) {
-    hash_table_print_items(set->memory);
+    if (set->type == SET_HASH_TABLE) {
+        hash_table_print_items(set->memory);
+        return;
+    }
+    printf("{");
+    size_t k = 0;
+    SetCursor c = set_cursor(set);
+    while (set_cursor_next(&c)) {
+        printf("%d->%d", c.key, c.value);
+        if (++k < (size_t) set_size(set)) {
+            printf(", ");
+        }
+    }
+    printf("}\n");
 }
 
 
 void set_free(Set *set) {
-    hash_table_free(set->memory);
+    if (set->memory != NULL) {
+        hash_table_free(set->memory);
+    }
+    if (set->roaring != NULL) {
+        roaring_free(set->roaring);
+    }
+    free(set->words);
     free(set);
 }
 
+SetCursor set_cursor(Set *s) {
+    SetCursor c;
+    memset(&c, 0, sizeof(c));
+    c.type = s->type;
+    if (s->type == SET_HASH_TABLE) {
+        c.table = hash_table_cursor(s->memory);
+    } else if (s->type == SET_ROARING) {
+        c.roaring = roaring_cursor(s->roaring);
+    } else if (s->type == SET_SMALL) {
+        c.keys = s->keys;
+        c.values = s->values;
+        c.n_keys = s->size;
+    } else {
+        c.words = s->words;
+        c.n_words = s->n_words;
+    }
+    return c;
+}
+
+bool set_cursor_next(SetCursor *c) {
+    if (c->type == SET_HASH_TABLE) {
+        if (!hash_table_cursor_next(&c->table)) {
+            return false;
+        }
+        c->key = c->table.key;
+        c->value = c->table.value;
+        return true;
+    }
+    if (c->type == SET_ROARING) {
+        if (!roaring_cursor_next(&c->roaring)) {
+            return false;
+        }
+        c->key = (int) c->roaring.value;
+        c->value = SET_DEFAULT_HASH_MAP_VALUE;
+        return true;
+    }
+    if (c->type == SET_SMALL) {
+        if (c->index == c->n_keys) {
+            return false;
+        }
+        c->key = c->keys[c->index];
+        c->value = c->values[c->index++];
+        return true;
+    }
+    while (c->bits == 0) {
+        if (c->index == c->n_words) {
+            return false;
+        }
+        c->bits = c->words[c->index++];
+    }
+    c->key = (int) ((c->index - 1) * WORD_BITS + __builtin_ctzll(c->bits));
+    c->value = SET_DEFAULT_HASH_MAP_VALUE;
+    c->bits &= c->bits - 1;
+    return true;
+}
+
+SetCursor set_cursor_part(Set *s, size_t part, size_t parts) {
+    SetCursor c = set_cursor(s);
+    if (s->type == SET_HASH_TABLE) {
+        c.table = hash_table_cursor_part(s->memory, part, parts);
+    } else if (s->type == SET_BITSET) {
+        c.index = s->n_words * part / parts;
+        c.n_words = s->n_words * (part + 1) / parts;
+    } else if (part > 0) {
+        // an empty walk
+        c.type = SET_SMALL;
+        c.keys = NULL;
+        c.values = NULL;
+        c.n_keys = 0;
+    }
+    return c;
+}
+
+// growable array of the elements kept by a task of a parallel operation
+typedef struct SetKeys {
+    int *keys;
+    size_t n;
+    size_t capacity;
+} SetKeys;
+
+static void set__keys_push(SetKeys *k, int key) {
+    if (k->n == k->capacity) {
+        k->capacity = k->capacity > 0 ? 2 * k->capacity : 256;
+        k->keys = (int*) realloc(k->keys, k->capacity * sizeof(int));
+        check_alloc(k->keys);
+    }
+    k->keys[k->n++] = key;
+}
+
+// a parallel operation: the tasks keep the elements of the parts of the
+// operands, then dispatch them to the groups of buckets of the result,
+// filled each by one task
+typedef struct SetParallel {
+    Set *a;
+    Set *b;
+    SetOp op;
+    size_t parts;    // parts of each operand
+    size_t n_tasks;  // parts, twice for a union: the elements of b not in a
+    SetKeys *kept;   // elements kept by each task
+    int *min;        // smallest element kept by each task
+    int *max;        // largest element kept by each task
+    size_t n_groups;
+    SetKeys *groups; // elements kept by the task t for the group g at t * n_groups + g
+    size_t *counts;  // bits set by each part, when both sets are bitsets
+    Set *result;
+} SetParallel;
+
+static void set__parallel_keep(void *context, size_t task) {
+    SetParallel *p = (SetParallel*) context;
+    bool second = task >= p->parts;
+    Set *walked = second ? p->b : p->a;
+    Set *other = second ? p->a : p->b;
+    bool keep_all = p->op == SET_OR && !second;
+    bool keep_found = p->op == SET_AND;
+    SetKeys *kept = &p->kept[task];
+    int min = INT_MAX, max = INT_MIN;
+    SetCursor c = set_cursor_part(walked, task % p->parts, p->parts);
+    while (set_cursor_next(&c)) {
+        if (keep_all || set_contains(other, c.key) == keep_found) {
+            set__keys_push(kept, c.key);
+            min = c.key < min ? c.key : min;
+            max = c.key > max ? c.key : max;
+        }
+    }
+    p->min[task] = min;
+    p->max[task] = max;
+}
+
+// the elements of a task by group of buckets, counted first so that each
+// group is allocated once
+static void set__parallel_scatter(void *context, size_t task) {
+    SetParallel *p = (SetParallel*) context;
+    SetKeys *kept = &p->kept[task];
+    SetKeys *groups = p->groups + task * p->n_groups;
+    HashTable *memory = p->result->memory;
+    for (size_t i = 0; i < kept->n; i++) {
+        groups[hash_table_group(memory, kept->keys[i], p->n_groups)].capacity++;
+    }
+    for (size_t g = 0; g < p->n_groups; g++) {
+        groups[g].keys = (int*) malloc((groups[g].capacity + 1) * sizeof(int));
+        check_alloc(groups[g].keys);
+    }
+    for (size_t i = 0; i < kept->n; i++) {
+        SetKeys *group = &groups[hash_table_group(memory, kept->keys[i], p->n_groups)];
+        group->keys[group->n++] = kept->keys[i];
+    }
+    free(kept->keys);
+    kept->keys = NULL;
+}
+
+// the elements of a group, in the order of the tasks
+static void set__parallel_fill(void *context, size_t group) {
+    SetParallel *p = (SetParallel*) context;
+    for (size_t task = 0; task < p->n_tasks; task++) {
+        SetKeys *keys = &p->groups[task * p->n_groups + group];
+        hash_table_put_group(p->result->memory, keys->keys, keys->n, SET_DEFAULT_HASH_MAP_VALUE);
+        free(keys->keys);
+    }
+}
+
+static void set__parallel_set_bits(void *context, size_t task) {
+    SetParallel *p = (SetParallel*) context;
+    SetKeys *kept = &p->kept[task];
+    uint64_t *words = p->result->words;
+    for (size_t i = 0; i < kept->n; i++) {
+        int key = kept->keys[i];
+        __atomic_fetch_or(&words[key / WORD_BITS], (uint64_t) 1 << (key % WORD_BITS), __ATOMIC_RELAXED);
+    }
+    free(kept->keys);
+    kept->keys = NULL;
+}
+
+// a range of whole cache lines of the words of the result, as in set__bitset_op()
+static void set__parallel_combine(void *context, size_t part) {
+    SetParallel *p = (SetParallel*) context;
+    Set *a = p->a, *b = p->b, *result = p->result;
+    size_t n_lines = result->n_words / LINE_WORDS;
+    size_t from = n_lines * part / p->parts * LINE_WORDS;
+    size_t to = n_lines * (part + 1) / p->parts * LINE_WORDS;
+    size_t n = a->n_words < b->n_words ? a->n_words : b->n_words;
+    size_t mid = to < n ? to : (from > n ? from : n);
+    size_t count = 0;
+    if (from < mid) {
+        count += set__combine(result->words + from, a->words + from, b->words + from, mid - from, p->op);
+    }
+    if (mid < to) {
+        const uint64_t *rest = (p->op == SET_OR && b->n_words > a->n_words ? b : a)->words;
+        memcpy(result->words + mid, rest + mid, (to - mid) * sizeof(uint64_t));
+        count += set__popcount(rest + mid, to - mid);
+    }
+    p->counts[part] = count;
+}
+
+static Set* set__parallel_bitsets(SetParallel *p, ThreadPool *pool) {
+    size_t n = p->a->n_words < p->b->n_words ? p->a->n_words : p->b->n_words;
+    size_t longest = p->a->n_words > p->b->n_words ? p->a->n_words : p->b->n_words;
+    size_t n_words = p->op == SET_OR ? longest : p->op == SET_AND ? n : p->a->n_words;
+    p->result = set__create_bitset(n_words, p->a->automatic);
+    p->counts = (size_t*) calloc(p->parts, sizeof(size_t));
+    check_alloc(p->counts);
+    thread_pool_run(pool, &set__parallel_combine, p, p->parts);
+    for (size_t part = 0; part < p->parts; part++) {
+        p->result->size += p->counts[part];
+    }
+    free(p->counts);
+    set__try_demote(p->result);
+    return p->result;
+}
+
+static Set* set__parallel_op(Set *set_a, Set *set_b, SetOp op, ThreadPool *pool) {
+    SetParallel p;
+    memset(&p, 0, sizeof(p));
+    p.a = set_a;
+    p.b = set_b;
+    p.op = op;
+    p.parts = thread_pool_size(pool) * PARALLEL_TASKS;
+    if (set_a->type == SET_BITSET && set_b->type == SET_BITSET) {
+        return set__parallel_bitsets(&p, pool);
+    }
+
+    p.n_tasks = op == SET_OR ? 2 * p.parts : p.parts;
+    p.kept = (SetKeys*) calloc(p.n_tasks, sizeof(SetKeys));
+    p.min = (int*) malloc(p.n_tasks * sizeof(int));
+    p.max = (int*) malloc(p.n_tasks * sizeof(int));
+    check_alloc(p.kept);
+    check_alloc(p.min);
+    check_alloc(p.max);
+    thread_pool_run(pool, &set__parallel_keep, &p, p.n_tasks);
+    size_t size = 0;
+    int min = INT_MAX, max = INT_MIN;
+    for (size_t task = 0; task < p.n_tasks; task++) {
+        size += p.kept[task].n;
+        min = p.min[task] < min ? p.min[task] : min;
+        max = p.max[task] > max ? p.max[task] : max;
+    }
+
+    // the representation set_create() would end up with
+    if (size >= SET_BITSET_MIN_SIZE && min >= 0 && (size_t) max < SET_BITSET_DENSITY * size) {
+        p.result = set__create_bitset(set__words_for(max), true);
+        p.result->size = size;
+        thread_pool_run(pool, &set__parallel_set_bits, &p, p.n_tasks);
+    } else {
+        p.result = set__alloc(true);
+        // filled by groups of buckets, which only chaining tables have
+        p.result->memory = hash_table_create_with_type(size > SET_DEFAULT_HASH_MAP_SIZE ? size : SET_DEFAULT_HASH_MAP_SIZE,
+                                                       HASH_TABLE_CHAINING);
+        p.result->next_check = 2 * size > SET_BITSET_MIN_SIZE ? 2 * size : SET_BITSET_MIN_SIZE;
+        p.n_groups = thread_pool_size(pool) * PARALLEL_TASKS;
+        p.groups = (SetKeys*) calloc(p.n_tasks * p.n_groups, sizeof(SetKeys));
+        check_alloc(p.groups);
+        thread_pool_run(pool, &set__parallel_scatter, &p, p.n_tasks);
+        thread_pool_run(pool, &set__parallel_fill, &p, p.n_groups);
+        free(p.groups);
+    }
+    free(p.kept);
+    free(p.min);
+    free(p.max);
+    return p.result;
+}
+
+// whether an operation is worth splitting between the threads
+static bool set__parallel(Set *set_a, Set *set_b, ThreadPool *pool) {
+    return thread_pool_size(pool) > 1
+        && (size_t) set_size(set_a) + (size_t) set_size(set_b) >= SET_PARALLEL_MIN_SIZE
+        && !(set_a->type == SET_ROARING && set_b->type == SET_ROARING);
+}
+
+Set* set_union_parallel(Set *set_a, Set *set_b, ThreadPool *pool) {
+    if (!set__parallel(set_a, set_b, pool)) {
+        return set_union(set_a, set_b);
+    }
+    return set__parallel_op(set_a, set_b, SET_OR, pool);
+}
+
+Set* set_intersection_parallel(Set *set_a, Set *set_b, ThreadPool *pool) {
+    if (!set__parallel(set_a, set_b, pool)) {
+        return set_intersection(set_a, set_b);
+    }
+    return set__parallel_op(set_a, set_b, SET_AND, pool);
+}
+
+Set* set_difference_parallel(Set *set_a, Set *set_b, ThreadPool *pool) {
+    if (!set__parallel(set_a, set_b, pool)) {
+        return set_difference(set_a, set_b);
+    }
+    return set__parallel_op(set_a, set_b, SET_AND_NOT, pool);
+}
+
+// state of an iterator: the cursor and the storage of the current element
+typedef struct SetIteratorState {
+    SetCursor cursor;
+    List pair;     // element and value returned by iterator_next()
+    bool has_next; // the cursor already stands on the next element
+} SetIteratorState;
+
+static List* set_iterator__advance(Iterator *it) {
+    SetIteratorState *state = (SetIteratorState*) it->container;
+    if (!state->has_next) {
+        return NULL;
+    }
+    state->pair.key = state->cursor.key;
+    state->pair.data = state->cursor.value;
+    state->has_next = set_cursor_next(&state->cursor);
+    return &state->pair;
+}
+
+static void* set_iterator_next_key(Iterator *it) {
+    List *pair = set_iterator__advance(it);
+    return pair != NULL ? &pair->key : NULL;
+}
+
+static void* set_iterator_next_item(Iterator *it) {
+    return set_iterator__advance(it);
+}
+
+static bool set_iterator_done(Iterator *it) {
+    return !((SetIteratorState*) it->container)->has_next;
+}
+
+static void set_iterator_free(Iterator *it) {
+    free(it->begin);
+    free(it);
+}
+
+static Iterator* set_iterator__create(Set *s, void* (*next)(Iterator*)) {
+    SetIteratorState *state = (SetIteratorState*) malloc(sizeof(SetIteratorState));
+    check_alloc(state);
+    state->cursor = set_cursor(s);
+    state->pair.next = NULL;
+    state->has_next = set_cursor_next(&state->cursor);
+    return iterator_create(state, next, &set_iterator_free, &set_iterator_done);
+}
+
 Iterator* set_iterator(Set *s) {
-    Iterator *it = hash_table_iterator_keys(s->memory);
-    return it;
+    if (s->type == SET_HASH_TABLE) {
+        return hash_table_iterator_keys(s->memory);
+    }
+    return set_iterator__create(s, &set_iterator_next_key);
 }
 
 Iterator* set_iterator_items(Set *s) {
-    Iterator *it = hash_table_iterator_items(s->memory);
-    return it;
+    if (s->type == SET_HASH_TABLE) {
+        return hash_table_iterator_items(s->memory);
+    }
+    return set_iterator__create(s, &set_iterator_next_item);
 }
 
 
@@ -14,25 +14,120 @@
 #define SET_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include "../list/single/list.h"
 #include "../iterator/iterator.h"
+#include "../hash-table/hash-table.h"
+#include "roaring.h"
+#include "thread-pool.h"
+
+/**
+ * @brief Smallest hash table set checked for a promotion to a bitset.
+ */
+#ifndef SET_BITSET_MIN_SIZE
+#define SET_BITSET_MIN_SIZE 64
+#endif
+
+/**
+ * @brief Bits per element under which a set is dense enough for a bitset.
+ *
+ * A hash table set is promoted when its largest element is below
+ * SET_BITSET_DENSITY times its size, the bitset then takes at most
+ * SET_BITSET_DENSITY / 8 bytes per element, against about 40 bytes of
+ * bucket and node. A bitset grown or emptied to 4 times that is turned back
+ * into a hash table.
+ */
+#ifndef SET_BITSET_DENSITY
+#define SET_BITSET_DENSITY 64
+#endif
+
+/**
+ * @brief Elements held in place by a small set, see SET_SMALL.
+ *
+ * A multiple of 4, so that a lookup compares them 4 at a time with SSE2.
+ */
+#ifndef SET_SMALL_CAPACITY
+#define SET_SMALL_CAPACITY 8
+#endif
+
+/**
+ * @brief Elements of both sets under which a parallel operation runs on the
+ * calling thread alone.
+ */
+#ifndef SET_PARALLEL_MIN_SIZE
+#define SET_PARALLEL_MIN_SIZE 65536
+#endif
 
 /**
  * @brief A basic implementation of a Set.
  *
  * This implementation uses a hash table to store the elements, which allows
- * for efficient insertion, deletion, and membership testing.
+ * for efficient insertion, deletion, and membership testing. Sets of small
+ * non-negative elements are kept as a bitset instead, see SetType.
  */
 typedef struct Set Set;
 
+/**
+ * @brief Representations of a set.
+ *
+ * A bitset holds the elements from 0 to its largest one, one bit each, and
+ * combines two sets a 64-bit word (or 256 bits with AVX2, build with
+ * -mavx2 or -march=native) at a time. It has no values: an element it
+ * cannot hold, negative or added with a value other than the default one,
+ * turns the set into a hash table.
+ *
+ * A Roaring bitmap compresses the elements by chunks of 65536, as sorted
+ * arrays, bitmaps or runs, from a few bits to 2 bytes per element whatever
+ * their density, see Roaring. Negative elements are held as their unsigned
+ * 32-bit value, so they come after the others in a walk. It has no values
+ * either, and a value other than the default one turns it into a hash
+ * table.
+ *
+ * A small set keeps up to SET_SMALL_CAPACITY elements and their values in
+ * the set itself, in increasing order, found by a scan of the whole array:
+ * no hash table, which takes about a kilobyte even when empty. It suits the
+ * many tiny sets of a sparse structure, such as the neighbors of the nodes
+ * of a Graph. The element that does not fit turns it into a hash table, as
+ * made by set_create(), for good.
+ */
+typedef enum SetType {
+    SET_HASH_TABLE, /**< hash table of the elements and their values */
+    SET_BITSET,     /**< one bit per integer up to the largest element */
+    SET_ROARING,    /**< Roaring bitmap of the elements */
+    SET_SMALL       /**< array of at most SET_SMALL_CAPACITY elements */
+} SetType;
+
 /**
  * @brief Create a new set instance
+ *
+ * The set starts as a hash table, promoted to a bitset when its elements
+ * are dense (see SET_BITSET_DENSITY), and back when they are not anymore.
  * @return pointer to the newly created set
  * @ingroup DataStructureMethods
  */
 Set* set_create();
 
+/**
+ * @brief Create a new set instance of a given representation
+ *
+ * The representation is kept whatever the density of the elements, but a
+ * bitset still turns into a hash table for the elements it cannot hold, and
+ * a small set once it outgrows SET_SMALL_CAPACITY.
+ * @param type representation of the set
+ * @return pointer to the newly created set
+ * @ingroup DataStructureMethods
+ */
+Set* set_create_with_type(SetType type);
+
+/**
+ * @brief Get the current representation of the set
+ * @param set pointer
+ * @return SET_HASH_TABLE, SET_BITSET, SET_ROARING or SET_SMALL
+ * @ingroup DataStructureMethods
+ */
+SetType set_type(Set *set);
+
 /**
  * @brief Create a new set instance with elements
  * @param set_size number of elements in initialization
@@ -115,6 +210,51 @@ Set* set_union(Set *set_a, Set *set_b);
    */
 Set* set_difference(Set *set_a, Set *set_b);
 
+/**
+ * @brief Union of set A and B computed by a pool of threads
+ *
+ * The sets are split into parts, ranges of buckets of a hash table or of
+ * words of a bitset, and each thread walks some of them and keeps the
+ * elements of the result. The kept elements are then dispatched by their
+ * bucket in the result, and each thread fills its own range of buckets: no
+ * lock is taken, and the tasks are merged in the order of the parts, so the
+ * result and its walk are the same whatever the number of threads and the
+ * scheduling. Two bitsets are combined by ranges of words. The elements of
+ * a Roaring or small set are walked by a single thread, two Roaring sets
+ * and sets of less than SET_PARALLEL_MIN_SIZE elements are combined as by
+ * set_union(). The sets must not be modified meanwhile.
+ * @param set_a set A
+ * @param set_b set B
+ * @param pool threads to run on
+ * @return pointer to the newly created set, the same elements as set_union()
+ * @ingroup DataStructureMethods
+ */
+Set* set_union_parallel(Set *set_a, Set *set_b, ThreadPool *pool);
+
+/**
+ * @brief Intersection of set A and B computed by a pool of threads
+ *
+ * See set_union_parallel().
+ * @param set_a set A
+ * @param set_b set B
+ * @param pool threads to run on
+ * @return pointer to the newly created set
+ * @ingroup DataStructureMethods
+ */
+Set* set_intersection_parallel(Set *set_a, Set *set_b, ThreadPool *pool);
+
+/**
+ * @brief Difference of set A and B computed by a pool of threads
+ *
+ * See set_union_parallel().
+ * @param set_a set A
+ * @param set_b set B
+ * @param pool threads to run on
+ * @return pointer to the newly created set
+ * @ingroup DataStructureMethods
+ */
+Set* set_difference_parallel(Set *set_a, Set *set_b, ThreadPool *pool);
+
 /**
  * @brief Check if set A and B are equals
  * @param set_a set A
@@ -140,6 +280,84 @@ void set_remove(Set *set, int element);
    */
 bool set_contains(Set *set, int element);
 
+/**
+ * @brief Check the membership of an array of elements
+ *
+ * Batched set_contains(), see hash_table_get_many().
+ * @param set pointer
+ * @param elements array of n integers to check
+ * @param n number of elements
+ * @param contains output array of n flags, true if the element is in the set
+ * @ingroup DataStructureMethods
+ */
+void set_contains_many(Set *set, const int *elements, size_t n, bool *contains);
+
+/**
+ * @brief Keep a filter of the elements in front of the set
+ *
+ * Membership tests of elements rejected by the filter return right away,
+ * which pays off when most of them miss, see hash_table_use_filter().
+ * A bitset has no use for it: the filter is only built while the set is a
+ * hash table.
+ * @param set pointer
+ * @param filter kind of filter, HASH_TABLE_FILTER_NONE to drop the filter
+ * @ingroup DataStructureMethods
+ */
+void set_use_filter(Set *set, HashTableFilter filter);
+
+/**
+ * @brief Measure the hash table holding the set
+ *
+ * Tells apart a bad hashing of the elements from an undersized table,
+ * see hash_table_stats() and hash_table_stats_print(). A bitset reports its
+ * words as buckets, the fraction of bits set as load factor and its bytes,
+ * a Roaring bitmap its containers and bytes, a small set its array as a
+ * single bucket.
+ * @param set pointer
+ * @return the stats of the hash table of the set
+ * @ingroup DataStructureMethods
+ */
+HashTableStats set_stats(Set *set);
+
+/**
+ * @brief Compress a Roaring set further with runs of consecutive elements
+ *
+ * See roaring_optimize(), the other representations are left as they are.
+ * @param set pointer
+ * @ingroup DataStructureMethods
+ */
+void set_optimize(Set *set);
+
+/**
+ * @brief Get the length of the serialization of the set
+ * @param set pointer
+ * @return bytes written by set_serialize()
+ * @ingroup DataStructureMethods
+ */
+size_t set_serialized_size(Set *set);
+
+/**
+ * @brief Write the elements of the set in the portable Roaring format
+ *
+ * Any representation is written as a Roaring bitmap (see
+ * roaring_serialize()), the values of the elements are not.
+ * @param set pointer
+ * @param buffer at least set_serialized_size() bytes
+ * @return bytes written
+ * @ingroup DataStructureMethods
+ */
+size_t set_serialize(Set *set, void *buffer);
+
+/**
+ * @brief Read a set written by set_serialize() or another Roaring library
+ * @param buffer serialized set
+ * @param length bytes available in the buffer
+ * @return pointer to the newly created Roaring set, NULL if the buffer is
+ * not a valid serialization
+ * @ingroup DataStructureMethods
+ */
+Set* set_deserialize(const void *buffer, size_t length);
+
 /**
  * @brief Print all elements of the set
  * @param set pointer
@@ -161,9 +379,64 @@ void set_print_items(Set *set);
  */
 void set_free(Set *set);
 
+/**
+ * @brief Cursor over the elements of a set.
+ *
+ * Walks the set in place without allocation: key is the element and value
+ * its inner value. A bitset, a Roaring bitmap or a small set is walked in
+ * increasing order. Adding or removing elements of the set invalidates the cursor, see
+ * HashTableCursor.
+ */
+typedef struct SetCursor {
+    SetType type;
+    HashTableCursor table;  /**< walk of a hash table */
+    RoaringCursor roaring;  /**< walk of a Roaring bitmap */
+    const uint64_t *words;  /**< words of a bitset */
+    size_t n_words;
+    size_t index;           /**< next word to load */
+    uint64_t bits;          /**< bits of the current word not visited yet */
+    const int *keys;        /**< elements of a small set */
+    const int *values;      /**< values of a small set */
+    size_t n_keys;
+    int key;                /**< current element */
+    int value;              /**< value of the current element */
+} SetCursor;
+
+/**
+ * @brief Start a walk over the elements of the set
+ * @param s The set to iterate over.
+ * @return a cursor placed before the first element
+ * @ingroup DataStructureMethods
+ */
+SetCursor set_cursor(Set *s);
+
+/**
+ * @brief Start a walk over a part of the elements of a set
+ *
+ * The buckets of a hash table or the words of a bitset are split into
+ * parts ranges, so that the cursors of the parts 0 to parts - 1 walk each
+ * element once, and may do so from different threads. A Roaring or small
+ * set is walked whole by the part 0, the other parts are empty.
+ * @param s The set to iterate over.
+ * @param part index of the part, below parts
+ * @param parts number of parts
+ * @return a cursor placed before the first element of the part
+ * @ingroup DataStructureMethods
+ */
+SetCursor set_cursor_part(Set *s, size_t part, size_t parts);
+
+/**
+ * @brief Move the cursor to the next element
+ * @param c cursor pointer, its key is set to the new element
+ * @return false when there are no more elements, true otherwise
+ * @ingroup DataStructureMethods
+ */
+bool set_cursor_next(SetCursor *c);
+
 /**
  * @brief Creates an iterator for the key elements of set.
  *
+ * The set is walked in place, as by a SetCursor.
  * @param s The set to iterate over.
  * @return A pointer to the new iterator.
  */
@@ -0,0 +1,259 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "sorted-set.h"
+#include "../utils/check_alloc.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+struct SortedSet {
+    size_t size;
+    // followed by the size elements, in increasing order
+};
+
+static inline int* sorted_set__elements(const SortedSet *s) {
+    return (int*) (s + 1);
+}
+
+static SortedSet* sorted_set__alloc(size_t size) {
+    SortedSet *s = (SortedSet*) malloc(sizeof(SortedSet) + size * sizeof(int));
+    check_alloc(s);
+    s->size = size;
+    return s;
+}
+
+static int sorted_set__compare(const void *a, const void *b) {
+    int x = *(const int*) a, y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+// sort the elements unless they already are, and drop the repeated ones
+static SortedSet* sorted_set__build(SortedSet *s) {
+    int *elements = sorted_set__elements(s);
+    bool sorted = true;
+    for (size_t i = 1; i < s->size && sorted; i++) {
+        sorted = elements[i - 1] < elements[i];
+    }
+    if (sorted) {
+        return s;
+    }
+    qsort(elements, s->size, sizeof(int), &sorted_set__compare);
+    size_t n = s->size > 0 ? 1 : 0;
+    for (size_t i = 1; i < s->size; i++) {
+        if (elements[i] != elements[n - 1]) {
+            elements[n++] = elements[i];
+        }
+    }
+    s->size = n;
+    return s;
+}
+
+// index of the first element from `from` on which is not below x, found by
+// steps doubling from there, then a binary search
+static size_t sorted_set__gallop(const int *elements, size_t from, size_t n, int x) {
+    size_t lo = from, hi = from, step = 1;
+    while (hi < n && elements[hi] < x) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = hi < n ? hi : n;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (elements[mid] < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// out = a & b, of at most min(na, nb) elements, returning their number
+static size_t sorted_set__intersect(const int *a, size_t na, const int *b, size_t nb, int *out) {
+    if (na > nb) {
+        const int *t = a;
+        a = b;
+        b = t;
+        size_t nt = na;
+        na = nb;
+        nb = nt;
+    }
+    size_t i = 0, j = 0, n = 0;
+    if (na * SORTED_SET_GALLOP_RATIO < nb) {
+        for (; i < na && j < nb; i++) {
+            j = sorted_set__gallop(b, j, nb, a[i]);
+            if (j < nb && b[j] == a[i]) {
+                out[n++] = a[i];
+            }
+        }
+        return n;
+    }
+#ifdef __SSE2__
+    // blocks of 4 compared all against all: b against its 4 rotations
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i*) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*) (b + j));
+        __m128i eq = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        for (int mask = _mm_movemask_ps(_mm_castsi128_ps(eq)); mask != 0; mask &= mask - 1) {
+            out[n++] = a[i + __builtin_ctz(mask)];
+        }
+        int a_max = a[i + 3], b_max = b[j + 3];
+        i += a_max <= b_max ? 4 : 0;
+        j += b_max <= a_max ? 4 : 0;
+    }
+#endif
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            out[n++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    return n;
+}
+
+SortedSet* sorted_set_from_set(Set *set) {
+    SortedSet *s = sorted_set__alloc((size_t) set_size(set));
+    int *elements = sorted_set__elements(s);
+    size_t n = 0;
+    SetCursor c = set_cursor(set);
+    while (set_cursor_next(&c)) {
+        elements[n++] = c.key;
+    }
+    return sorted_set__build(s);
+}
+
+SortedSet* sorted_set_from_iterator(Iterator *it) {
+    size_t capacity = 16, n = 0;
+    SortedSet *s = sorted_set__alloc(capacity);
+    while (!iterator_done(it)) {
+        if (n == capacity) {
+            capacity *= 2;
+            s = (SortedSet*) realloc(s, sizeof(SortedSet) + capacity * sizeof(int));
+            check_alloc(s);
+        }
+        sorted_set__elements(s)[n++] = *(int*) iterator_next(it);
+    }
+    s->size = n;
+    return sorted_set__build(s);
+}
+
+SortedSet* sorted_set_from_array(const int *elements, size_t n) {
+    SortedSet *s = sorted_set__alloc(n);
+    if (n > 0) {
+        memcpy(sorted_set__elements(s), elements, n * sizeof(int));
+    }
+    return sorted_set__build(s);
+}
+
+Set* sorted_set_to_set(const SortedSet *s) {
+    Set *set = set_create();
+    const int *elements = sorted_set__elements(s);
+    for (size_t i = 0; i < s->size; i++) {
+        set_add(set, elements[i]);
+    }
+    return set;
+}
+
+size_t sorted_set_size(const SortedSet *s) {
+    return s->size;
+}
+
+const int* sorted_set_elements(const SortedSet *s) {
+    return sorted_set__elements(s);
+}
+
+bool sorted_set_contains(const SortedSet *s, int element) {
+    const int *elements = sorted_set__elements(s);
+    size_t i = sorted_set__gallop(elements, 0, s->size, element);
+    return i < s->size && elements[i] == element;
+}
+
+SortedSet* sorted_set_intersection(const SortedSet *a, const SortedSet *b) {
+    SortedSet *s = sorted_set__alloc(a->size < b->size ? a->size : b->size);
+    s->size = sorted_set__intersect(sorted_set__elements(a), a->size, sorted_set__elements(b), b->size,
+                                    sorted_set__elements(s));
+    return s;
+}
+
+static int sorted_set__compare_size(const void *a, const void *b) {
+    size_t x = (*(const SortedSet *const*) a)->size, y = (*(const SortedSet *const*) b)->size;
+    return (x > y) - (x < y);
+}
+
+SortedSet* sorted_set_intersection_many(const SortedSet *const *sets, size_t k) {
+    const SortedSet **order = (const SortedSet**) malloc(k * sizeof(SortedSet*));
+    check_alloc(order);
+    memcpy(order, sets, k * sizeof(SortedSet*));
+    qsort(order, k, sizeof(SortedSet*), &sorted_set__compare_size);
+
+    // the intersection so far, shorter than any set left, goes back and
+    // forth between two buffers
+    size_t n = order[0]->size;
+    int *current = (int*) malloc((2 * n + 1) * sizeof(int));
+    check_alloc(current);
+    int *next = current + n;
+    int *buffer = current;
+    if (n > 0) {
+        memcpy(current, sorted_set__elements(order[0]), n * sizeof(int));
+    }
+    for (size_t t = 1; t < k && n > 0; t++) {
+        n = sorted_set__intersect(current, n, sorted_set__elements(order[t]), order[t]->size, next);
+        int *swap = current;
+        current = next;
+        next = swap;
+    }
+    SortedSet *s = sorted_set__alloc(n);
+    if (n > 0) {
+        memcpy(sorted_set__elements(s), current, n * sizeof(int));
+    }
+    free(buffer);
+    free(order);
+    return s;
+}
+
+bool sorted_set_subset(const SortedSet *a, const SortedSet *b) {
+    if (a->size > b->size) {
+        return false;
+    }
+    const int *ea = sorted_set__elements(a), *eb = sorted_set__elements(b);
+    size_t j = 0;
+    for (size_t i = 0; i < a->size; i++, j++) {
+        j = sorted_set__gallop(eb, j, b->size, ea[i]);
+        if (j == b->size || eb[j] != ea[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sorted_set_equal(const SortedSet *a, const SortedSet *b) {
+    return a->size == b->size
+        && memcmp(sorted_set__elements(a), sorted_set__elements(b), a->size * sizeof(int)) == 0;
+}
+
+void sorted_set_free(SortedSet *s) {
+    free(s);
+}
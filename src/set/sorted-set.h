@@ -0,0 +1,148 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef SORTED_SET_H
+#define SORTED_SET_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "../iterator/iterator.h"
+#include "set.h"
+
+/**
+ * @brief Length ratio from which an intersection gallops through the longest set.
+ */
+#ifndef SORTED_SET_GALLOP_RATIO
+#define SORTED_SET_GALLOP_RATIO 32
+#endif
+
+/**
+ * @brief An immutable set of integers as a sorted array.
+ *
+ * Built once from a Set or an Iterator, for read-heavy workloads such as the
+ * posting lists of an inverted index. Membership is a binary search, and
+ * intersections walk both arrays: blocks of 4 elements of each one are
+ * compared all against all with SSE2, and an array much shorter than the
+ * other one (see SORTED_SET_GALLOP_RATIO) looks its elements up by
+ * galloping, exponential steps then a binary search, so that the cost grows
+ * with the shortest array only. Intersections of many sets start from the
+ * shortest ones.
+ *
+ * @see Lemire et al., SIMD compression and the intersection of sorted integers, 2016
+ */
+typedef struct SortedSet SortedSet;
+
+/**
+ * @brief Create a sorted set of the elements of a set
+ * @param set pointer
+ * @return pointer to the newly created sorted set
+ * @ingroup DataStructureMethods
+ */
+SortedSet* sorted_set_from_set(Set *set);
+
+/**
+ * @brief Create a sorted set of the integers of an iterator
+ *
+ * Repeated integers are kept once.
+ * @param it iterator of int pointers, consumed
+ * @return pointer to the newly created sorted set
+ * @ingroup DataStructureMethods
+ */
+SortedSet* sorted_set_from_iterator(Iterator *it);
+
+/**
+ * @brief Create a sorted set of an array of integers
+ *
+ * Repeated integers are kept once.
+ * @param elements array of n integers, in any order
+ * @param n number of integers
+ * @return pointer to the newly created sorted set
+ * @ingroup DataStructureMethods
+ */
+SortedSet* sorted_set_from_array(const int *elements, size_t n);
+
+/**
+ * @brief Create a set of the elements of a sorted set
+ * @param s sorted set pointer
+ * @return pointer to the newly created set
+ * @ingroup DataStructureMethods
+ */
+Set* sorted_set_to_set(const SortedSet *s);
+
+/**
+ * @brief Get the number of elements of the sorted set
+ * @param s sorted set pointer
+ * @ingroup DataStructureMethods
+ */
+size_t sorted_set_size(const SortedSet *s);
+
+/**
+ * @brief Get the elements of the sorted set
+ * @param s sorted set pointer
+ * @return sorted_set_size() integers in increasing order, owned by the set
+ * @ingroup DataStructureMethods
+ */
+const int* sorted_set_elements(const SortedSet *s);
+
+/**
+ * @brief Check if an element is in the sorted set
+ * @param s sorted set pointer
+ * @param element integer to look for
+ * @ingroup DataStructureMethods
+ */
+bool sorted_set_contains(const SortedSet *s, int element);
+
+/**
+ * @brief Intersection of sorted sets A and B
+ * @param a sorted set A
+ * @param b sorted set B
+ * @return pointer to the newly created sorted set
+ * @ingroup DataStructureMethods
+ */
+SortedSet* sorted_set_intersection(const SortedSet *a, const SortedSet *b);
+
+/**
+ * @brief Intersection of k sorted sets
+ *
+ * The sets are intersected from the shortest one, and the intersection
+ * stops as soon as it is empty.
+ * @param sets array of k sorted sets
+ * @param k number of sets, at least 1
+ * @return pointer to the newly created sorted set
+ * @ingroup DataStructureMethods
+ */
+SortedSet* sorted_set_intersection_many(const SortedSet *const *sets, size_t k);
+
+/**
+ * @brief Check if sorted set A is a subset of sorted set B
+ * @param a sorted set A
+ * @param b sorted set B
+ * @ingroup DataStructureMethods
+ */
+bool sorted_set_subset(const SortedSet *a, const SortedSet *b);
+
+/**
+ * @brief Check if sorted sets A and B have the same elements
+ * @param a sorted set A
+ * @param b sorted set B
+ * @ingroup DataStructureMethods
+ */
+bool sorted_set_equal(const SortedSet *a, const SortedSet *b);
+
+/**
+ * @brief Free memory of the sorted set
+ * @param s sorted set pointer
+ * @ingroup DataStructureMethods
+ */
+void sorted_set_free(SortedSet *s);
+
+#endif /* SORTED_SET_H */
@@ -1,7 +1,11 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include "set.h"
 #include "set-disjoint.h"
+#include "set-disjoint-concurrent.h"
+#include "roaring.h"
+#include "sorted-set.h"
 
 void test_set_contains() {
     printf("\n== test set_contains\n\n");
@@ -133,6 +137,489 @@ void test_set_iterator() {
     iterator_free(it);
 }
 
+void test_set_cursor() {
+    printf("\n== test set_cursor\n\n");
+    Set *set = set_create();
+    for (int i = 0; i < 1000; i++) {
+        set_add_with_value(set, i, 2 * i);
+    }
+
+    int count = 0;
+    SetCursor c = set_cursor(set);
+    while (set_cursor_next(&c)) {
+        assert(set_contains(set, c.key));
+        assert(c.value == 2 * c.key);
+        count++;
+    }
+    assert(count == set_size(set));
+    set_free(set);
+}
+
+void test_set_contains_many() {
+    printf("\n== test set_contains_many\n\n");
+    Set *set = set_init(4, 0, 3, 6, 9);
+    int elements[40];
+    bool contains[40];
+    for (int i = 0; i < 40; i++) {
+        elements[i] = i - 20;
+    }
+    set_contains_many(set, elements, 40, contains);
+    for (int i = 0; i < 40; i++) {
+        assert(contains[i] == set_contains(set, elements[i]));
+    }
+    set_free(set);
+}
+
+void test_set_stats() {
+    printf("\n== test set_stats\n\n");
+    Set *set = set_init(4, 0, 3, 6, 9);
+    HashTableStats stats = set_stats(set);
+    assert(stats.size == 4);
+    assert(stats.load_factor > 0);
+    // a key in its home slot is probed 0 times, a chain holds at least it
+    assert(stats.max_length >= (stats.type == HASH_TABLE_CHAINING ? 1u : 0u));
+    hash_table_stats_print(&stats, HASH_TABLE_STATS_JSON, stdout);
+    set_free(set);
+}
+
+void test_set_use_filter() {
+    printf("\n== test set_use_filter\n\n");
+    Set *set = set_init(4, 0, 3, 6, 9);
+    set_use_filter(set, HASH_TABLE_FILTER_CUCKOO);
+    set_add(set, 12);
+    set_remove(set, 3);
+    Set *expected = set_init(4, 0, 6, 9, 12);
+    assert(set_equal(set, expected));
+    for (int i = 0; i < 100; i++) {
+        assert(set_contains(set, i) == (i % 3 == 0 && i <= 12 && i != 3));
+    }
+    set_free(expected);
+    set_free(set);
+}
+
+// the same elements in a hash table and in a bitset
+static void fill_both(Set *hash, Set *bitset, int n, int step, int offset) {
+    for (int i = 0; i < n; i++) {
+        set_add(hash, offset + i * step);
+        set_add(bitset, offset + i * step);
+    }
+}
+
+void test_set_bitset() {
+    printf("\n== test set_bitset\n\n");
+    Set *hash_a = set_create_with_type(SET_HASH_TABLE);
+    Set *hash_b = set_create_with_type(SET_HASH_TABLE);
+    Set *bits_a = set_create_with_type(SET_BITSET);
+    Set *bits_b = set_create_with_type(SET_BITSET);
+    fill_both(hash_a, bits_a, 3000, 2, 0);
+    fill_both(hash_b, bits_b, 500, 3, 1000);
+    assert(set_type(hash_a) == SET_HASH_TABLE && set_type(bits_a) == SET_BITSET);
+    assert(set_size(bits_a) == 3000 && set_size(bits_b) == 500);
+    assert(set_equal(hash_a, bits_a) && set_equal(bits_a, hash_a));
+
+    Set *(*ops[3])(Set*, Set*) = {set_union, set_intersection, set_difference};
+    for (int i = 0; i < 3; i++) {
+        Set *expected = ops[i](hash_a, hash_b);
+        Set *result = ops[i](bits_a, bits_b);
+        assert(set_type(result) == SET_BITSET);
+        assert(set_size(result) == set_size(expected));
+        assert(set_equal(result, expected));
+        set_free(expected);
+        set_free(result);
+    }
+    Set *small = set_intersection(bits_a, bits_b);
+    assert(set_subset(small, bits_a) && set_subset(small, bits_b));
+    assert(!set_subset(bits_b, bits_a) && !set_subset(bits_a, small));
+    set_free(small);
+
+    int previous = -1;
+    SetCursor c = set_cursor(bits_b);
+    while (set_cursor_next(&c)) {
+        assert(c.key > previous && c.value == 1 && set_contains(hash_b, c.key));
+        previous = c.key;
+    }
+    Iterator *it = set_iterator(bits_b);
+    Set *from_iterator = set_from_iterator(it);
+    assert(set_equal(from_iterator, hash_b));
+    iterator_free(it);
+    set_free(from_iterator);
+
+    printf("A negative element or a value turn a bitset into a hash table\n");
+    set_remove(bits_b, 1000);
+    set_add(bits_b, -1);
+    assert(set_type(bits_b) == SET_HASH_TABLE);
+    assert(set_contains(bits_b, -1) && !set_contains(bits_b, 1000) && set_size(bits_b) == 500);
+    set_add_with_value(bits_a, 7, 42);
+    assert(set_type(bits_a) == SET_HASH_TABLE && set_get_value(bits_a, 7) == 42);
+    assert(set_size(bits_a) == 3001 && set_get_value(bits_a, 2) == 1);
+
+    set_free(hash_a); set_free(hash_b); set_free(bits_a); set_free(bits_b);
+}
+
+void test_set_bitset_promotion() {
+    printf("\n== test set_bitset_promotion\n\n");
+    Set *set = set_create();
+    for (int i = 0; i < SET_BITSET_MIN_SIZE - 1; i++) {
+        set_add(set, 2 * i);
+    }
+    assert(set_type(set) == SET_HASH_TABLE);
+    set_add(set, 1);
+    printf("Dense elements promote the set to a bitset\n");
+    assert(set_type(set) == SET_BITSET);
+    assert(set_size(set) == SET_BITSET_MIN_SIZE && set_contains(set, 1) && set_contains(set, 2));
+    Set *copy = set_copy(set);
+    HashTableStats stats = set_stats(set);
+    assert(stats.size == SET_BITSET_MIN_SIZE && stats.bytes > 0);
+
+    printf("A far element turns it back into a hash table\n");
+    set_add(set, 1 << 24);
+    assert(set_type(set) == SET_HASH_TABLE && set_size(set) == SET_BITSET_MIN_SIZE + 1);
+    set_remove(set, 1 << 24);
+    assert(set_equal(set, copy));
+
+    printf("So does emptying a large bitset\n");
+    for (int i = 0; i < 1 << 14; i++) {
+        set_add(copy, i);
+    }
+    assert(set_type(copy) == SET_BITSET);
+    for (int i = 1; i < 1 << 14; i++) {
+        set_remove(copy, i);
+    }
+    assert(set_type(copy) == SET_HASH_TABLE);
+    assert(set_size(copy) == 1 && set_contains(copy, 0));
+
+    printf("Elements with values are never promoted\n");
+    Set *valued = set_create();
+    for (int i = 0; i < 4 * SET_BITSET_MIN_SIZE; i++) {
+        set_add_with_value(valued, i, i);
+    }
+    assert(set_type(valued) == SET_HASH_TABLE);
+    set_free(set); set_free(copy); set_free(valued);
+}
+
+// n elements in each chunk of 65536 of [0, chunks * 65536) as a Roaring
+// bitmap and a hash table set, in runs of consecutive elements
+static Roaring* roaring_fill(Set *reference, int chunks, int n, int run, unsigned seed) {
+    Roaring *r = roaring_create();
+    srand(seed);
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        for (int i = 0; i < n; i += run) {
+            uint32_t start = (uint32_t) chunk << 16 | (uint32_t) (rand() % 65536);
+            for (int k = 0; k < run && (start + k) >> 16 == (uint32_t) chunk; k++) {
+                roaring_add(r, start + k);
+                set_add(reference, (int) (start + k));
+            }
+        }
+    }
+    return r;
+}
+
+static bool roaring_matches(const Roaring *r, Set *reference) {
+    if (roaring_size(r) != (size_t) set_size(reference)) {
+        return false;
+    }
+    int64_t previous = -1;
+    RoaringCursor c = roaring_cursor(r);
+    while (roaring_cursor_next(&c)) {
+        if ((int64_t) c.value <= previous || !set_contains(reference, (int) c.value)) {
+            return false;
+        }
+        previous = c.value;
+    }
+    return true;
+}
+
+void test_roaring() {
+    printf("\n== test roaring\n\n");
+    // arrays, bitmaps and, after optimize, runs in the same bitmaps
+    Set *ref_a = set_create_with_type(SET_HASH_TABLE);
+    Set *ref_b = set_create_with_type(SET_HASH_TABLE);
+    Roaring *a = roaring_fill(ref_a, 4, 6000, 1, 1);
+    Roaring *b = roaring_fill(ref_b, 6, 300, 50, 2);
+    assert(roaring_matches(a, ref_a) && roaring_matches(b, ref_b));
+    for (int pass = 0; pass < 2; pass++) {
+        printf("%s containers\n", pass == 0 ? "array and bitmap" : "run");
+        Roaring *(*ops[3])(const Roaring*, const Roaring*) = {roaring_and, roaring_or, roaring_andnot};
+        Set *(*set_ops[3])(Set*, Set*) = {set_intersection, set_union, set_difference};
+        for (int i = 0; i < 3; i++) {
+            Roaring *r = ops[i](a, b);
+            Set *expected = set_ops[i](ref_a, ref_b);
+            assert(roaring_matches(r, expected));
+            assert(roaring_subset(r, i == 1 ? r : a));
+            roaring_free(r);
+            set_free(expected);
+        }
+        Roaring *both = roaring_and(a, b);
+        assert(roaring_subset(both, b) && !roaring_subset(a, b) && !roaring_equal(both, a));
+
+        size_t length = roaring_serialized_size(a);
+        unsigned char *buffer = (unsigned char*) malloc(length);
+        size_t written = roaring_serialize(a, buffer);
+        assert(written == length);
+        Roaring *read = roaring_deserialize(buffer, length);
+        assert(read != NULL && roaring_equal(read, a));
+        assert(roaring_deserialize(buffer, length - 1) == NULL);
+        roaring_free(read);
+        free(buffer);
+        roaring_free(both);
+
+        size_t bytes = roaring_bytes(b);
+        roaring_optimize(a);
+        roaring_optimize(b);
+        assert(roaring_matches(a, ref_a) && roaring_matches(b, ref_b));
+        assert(pass == 1 || roaring_bytes(b) < bytes);
+    }
+
+    printf("add and remove in run containers\n");
+    for (uint32_t x = 65536 + 100; x < 65536 + 200; x++) {
+        roaring_add(b, x);
+        set_add(ref_b, (int) x);
+    }
+    assert(roaring_matches(b, ref_b));
+    for (uint32_t x = 65536 + 100; x < 65536 + 200; x += 7) {
+        bool removed = roaring_remove(b, x);
+        assert(removed == set_contains(ref_b, (int) x));
+        set_remove(ref_b, (int) x);
+        bool added = roaring_add(b, x + 1);
+        assert(added != set_contains(ref_b, (int) x + 1));
+        set_add(ref_b, (int) x + 1);
+    }
+    assert(roaring_matches(b, ref_b));
+
+    printf("the portable format of a known bitmap\n");
+    Roaring *known = roaring_create();
+    roaring_add(known, 1);
+    roaring_add(known, 2);
+    roaring_add(known, 0x10000);
+    unsigned char expected[] = {0x3a, 0x30, 0, 0, 2, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0,
+                                24, 0, 0, 0, 28, 0, 0, 0, 1, 0, 2, 0, 0, 0};
+    unsigned char buffer[sizeof(expected)];
+    assert(roaring_serialized_size(known) == sizeof(expected));
+    roaring_serialize(known, buffer);
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        assert(buffer[i] == expected[i]);
+    }
+    roaring_free(known);
+
+    roaring_free(a); roaring_free(b);
+    set_free(ref_a); set_free(ref_b);
+}
+
+void test_set_roaring() {
+    printf("\n== test set_roaring\n\n");
+    Set *hash = set_create_with_type(SET_HASH_TABLE);
+    Set *set = set_create_with_type(SET_ROARING);
+    fill_both(hash, set, 20000, 7, -1000);
+    assert(set_type(set) == SET_ROARING && set_size(set) == 20000);
+    assert(set_equal(set, hash) && set_equal(hash, set));
+    assert(set_contains(set, -1000) && !set_contains(set, -999));
+
+    Set *other = set_create_with_type(SET_ROARING);
+    for (int i = 0; i < 50000; i += 3) {
+        set_add(other, i);
+    }
+    Set *(*ops[3])(Set*, Set*) = {set_union, set_intersection, set_difference};
+    for (int i = 0; i < 3; i++) {
+        Set *result = ops[i](set, other);
+        Set *expected = ops[i](hash, other);
+        assert(set_type(result) == SET_ROARING && set_equal(result, expected));
+        set_free(result);
+        set_free(expected);
+    }
+
+    printf("serialize a hash table set and read it back as a Roaring set\n");
+    size_t length = set_serialized_size(hash);
+    unsigned char *buffer = (unsigned char*) malloc(length);
+    size_t written = set_serialize(hash, buffer);
+    assert(written == length);
+    Set *read = set_deserialize(buffer, length);
+    assert(read != NULL && set_type(read) == SET_ROARING && set_equal(read, hash));
+    free(buffer);
+    set_optimize(read);
+    assert(set_equal(read, hash));
+
+    printf("A value turns a Roaring set into a hash table\n");
+    set_add_with_value(read, 3, 9);
+    assert(set_type(read) == SET_HASH_TABLE && set_get_value(read, 3) == 9);
+    assert(set_size(read) == 20001 && set_contains(read, -1000));
+    set_free(set); set_free(hash); set_free(other); set_free(read);
+}
+
+// n random elements of [-range, range) in a set
+static Set* random_set(int n, int range) {
+    Set *set = set_create_with_type(SET_HASH_TABLE);
+    for (int i = 0; i < n; i++) {
+        set_add(set, rand() % (2 * range) - range);
+    }
+    return set;
+}
+
+void test_sorted_set() {
+    printf("\n== test sorted_set\n\n");
+    srand(3);
+    int sizes[] = {0, 3, 100, 1000, 5000, 100000};
+    Set *sets[6];
+    SortedSet *sorted[6];
+    for (int i = 0; i < 6; i++) {
+        sets[i] = random_set(sizes[i], 20000);
+        sorted[i] = sorted_set_from_set(sets[i]);
+        assert(sorted_set_size(sorted[i]) == (size_t) set_size(sets[i]));
+        const int *elements = sorted_set_elements(sorted[i]);
+        for (size_t k = 1; k < sorted_set_size(sorted[i]); k++) {
+            assert(elements[k - 1] < elements[k]);
+        }
+    }
+    printf("Intersections merged by blocks and by galloping\n");
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            SortedSet *both = sorted_set_intersection(sorted[i], sorted[j]);
+            Set *expected = set_intersection(sets[i], sets[j]);
+            Set *result = sorted_set_to_set(both);
+            assert(set_equal(result, expected));
+            assert(sorted_set_subset(both, sorted[i]) && sorted_set_subset(both, sorted[j]));
+            assert(sorted_set_equal(both, sorted[i]) == set_equal(expected, sets[i]));
+            for (int x = -20; x < 20; x++) {
+                assert(sorted_set_contains(both, x) == set_contains(expected, x));
+            }
+            sorted_set_free(both);
+            set_free(expected);
+            set_free(result);
+        }
+    }
+    printf("Intersection of many sets\n");
+    const SortedSet *many[4] = {sorted[5], sorted[4], sorted[3], sorted[5]};
+    SortedSet *all = sorted_set_intersection_many(many, 4);
+    Set *expected = set_intersection(sets[5], sets[4]);
+    Set *partial = set_intersection(expected, sets[3]);
+    Set *result = sorted_set_to_set(all);
+    assert(set_equal(result, partial));
+    sorted_set_free(all);
+    set_free(expected); set_free(partial); set_free(result);
+    const SortedSet *with_empty[3] = {sorted[5], sorted[0], sorted[4]};
+    all = sorted_set_intersection_many(with_empty, 3);
+    assert(sorted_set_size(all) == 0);
+    sorted_set_free(all);
+
+    printf("From an iterator or an array, with repeated elements\n");
+    int elements[] = {5, -1, 5, 3, 3, -1, 9};
+    SortedSet *from_array = sorted_set_from_array(elements, 7);
+    assert(sorted_set_size(from_array) == 4 && sorted_set_elements(from_array)[0] == -1);
+    Iterator *it = set_iterator(sets[3]);
+    SortedSet *from_iterator = sorted_set_from_iterator(it);
+    assert(sorted_set_equal(from_iterator, sorted[3]));
+    iterator_free(it);
+    sorted_set_free(from_array);
+    sorted_set_free(from_iterator);
+    for (int i = 0; i < 6; i++) {
+        set_free(sets[i]);
+        sorted_set_free(sorted[i]);
+    }
+}
+
+void test_set_small() {
+    printf("\n== test set_small\n\n");
+    Set *set = set_create_with_type(SET_SMALL);
+    Set *expected = set_create_with_type(SET_HASH_TABLE);
+    for (int i = SET_SMALL_CAPACITY - 1; i >= 0; i--) {
+        set_add_with_value(set, 3 * i - 5, i);
+        set_add_with_value(expected, 3 * i - 5, i);
+    }
+    set_add(set, 1);
+    set_add(expected, 1);
+    assert(set_type(set) == SET_SMALL && set_size(set) == SET_SMALL_CAPACITY);
+    assert(set_equal(set, expected) && set_get_value(set, 1) == 1 && set_get_value(set, 4) == 3);
+    assert(!set_contains(set, 0) && set_get_value(set, 0) == 0);
+    printf("Elements are walked in increasing order: ");
+    set_print(set);
+    SetCursor c = set_cursor(set);
+    int last = -6;
+    while (set_cursor_next(&c)) {
+        assert(c.key > last && c.value == set_get_value(expected, c.key));
+        last = c.key;
+    }
+
+    Set *copy = set_copy(set);
+    set_remove(copy, -5);
+    set_remove(copy, 100);
+    assert(set_type(copy) == SET_SMALL && set_size(copy) == SET_SMALL_CAPACITY - 1);
+    assert(!set_contains(copy, -5) && set_contains(set, -5));
+    Set *difference = set_difference(set, copy);
+    assert(set_size(difference) == 1 && set_contains(difference, -5));
+
+    printf("One more element turns it into a hash table, values kept\n");
+    set_add_with_value(set, 1000, 7);
+    assert(set_type(set) == SET_HASH_TABLE && set_size(set) == SET_SMALL_CAPACITY + 1);
+    assert(set_get_value(set, 1000) == 7 && set_get_value(set, 4) == 3 && set_subset(expected, set));
+    set_free(set); set_free(expected); set_free(copy); set_free(difference);
+}
+
+// whether both sets are walked in the same order
+static bool same_walk(Set *a, Set *b) {
+    SetCursor ca = set_cursor(a), cb = set_cursor(b);
+    for (;;) {
+        bool more_a = set_cursor_next(&ca), more_b = set_cursor_next(&cb);
+        if (more_a != more_b || (more_a && ca.key != cb.key)) {
+            return false;
+        }
+        if (!more_a) {
+            return true;
+        }
+    }
+}
+
+void test_set_parallel() {
+    printf("\n== test set_parallel\n\n");
+    srand(5);
+    ThreadPool *pools[2] = {thread_pool_create(2), thread_pool_create(4)};
+    Set *sparse_a = random_set(60000, 1 << 24), *sparse_b = random_set(60000, 1 << 24);
+    SetCursor c = set_cursor(sparse_a);
+    for (int i = 0; set_cursor_next(&c); i++) {
+        if (i % 2 == 0) {
+            set_add(sparse_b, c.key);
+        }
+    }
+    Set *dense_a = set_create(), *dense_b = set_create();
+    Set *hash_dense = set_create_with_type(SET_HASH_TABLE);
+    Set *roaring = set_create_with_type(SET_ROARING);
+    Set *small = set_create_with_type(SET_SMALL);
+    for (int i = 0; i < 200000; i++) {
+        if (i % 3 != 0) set_add(dense_a, i);
+        if (i % 5 != 0) set_add(dense_b, i);
+        if (i % 2 == 0 && i < 100000) set_add(hash_dense, i);
+        if (i % 4 == 0) set_add(roaring, 7 * i);
+    }
+    set_add(small, -3);
+    set_add(small, 10);
+    assert(set_type(dense_a) == SET_BITSET && set_type(small) == SET_SMALL);
+
+    Set *pairs[][2] = {{sparse_a, sparse_b}, {dense_a, dense_b}, {hash_dense, dense_a}, {dense_b, sparse_a},
+                       {sparse_a, roaring}, {roaring, hash_dense}, {small, sparse_a}, {sparse_b, small}};
+    Set* (*serial[3])(Set*, Set*) = {set_union, set_intersection, set_difference};
+    Set* (*parallel[3])(Set*, Set*, ThreadPool*) = {set_union_parallel, set_intersection_parallel,
+                                                    set_difference_parallel};
+    for (size_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+        for (int op = 0; op < 3; op++) {
+            Set *expected = serial[op](pairs[k][0], pairs[k][1]);
+            Set *two = parallel[op](pairs[k][0], pairs[k][1], pools[0]);
+            Set *four = parallel[op](pairs[k][0], pairs[k][1], pools[1]);
+            assert(set_equal(two, expected));
+            assert(set_type(two) == set_type(four) && same_walk(two, four));
+            if (k == 1) {
+                assert(set_type(two) == SET_BITSET);
+            }
+            set_free(expected); set_free(two); set_free(four);
+        }
+    }
+    printf("Results match the sequential ones and do not depend on the threads\n");
+
+    Set *sum = set_union_parallel(small, small, pools[1]);
+    assert(set_size(sum) == 2);
+    set_free(sum);
+    set_free(sparse_a); set_free(sparse_b); set_free(dense_a); set_free(dense_b);
+    set_free(hash_dense); set_free(roaring); set_free(small);
+    thread_pool_free(pools[0]);
+    thread_pool_free(pools[1]);
+}
 
 void test_set_disjoint() {
     printf("\n== test set_disjoint\n\n");
@@ -182,10 +669,82 @@ void test_set_disjoint() {
     // Check that 8 and 9 are still separate
     assert(set_disjoint_find(ds, 8) == set_disjoint_find(ds, 9));
     assert(set_disjoint_find(ds, 0) != set_disjoint_find(ds, 8));
+    assert(set_disjoint_set_size(ds, 3) == 8);
+    assert(set_disjoint_count(ds) == 2);
+    assert(!set_disjoint_union(ds, 1, 7));
+
+    // new ids streaming in, chained one after the other
+    for (int i = n; i < 1000000; i++) {
+        set_disjoint_grow(ds, i + 1);
+        assert(set_disjoint_find(ds, i) == i);
+        bool joined = set_disjoint_union(ds, i, i - 1);
+        assert(joined);
+    }
+    assert(set_disjoint_size(ds) == 1000000);
+    assert(set_disjoint_count(ds) == 2);
+    assert(set_disjoint_find(ds, 999999) == set_disjoint_find(ds, 8));
+    assert(set_disjoint_set_size(ds, 0) == 8);
 
     set_disjoint_free(ds);
 }
 
+typedef struct DisjointSetTest {
+    DisjointSetConcurrent *ds;
+    const int *edges;    // pairs of elements
+    size_t n_edges;
+    size_t parts;
+} DisjointSetTest;
+
+static void union_part(void *context, size_t part) {
+    DisjointSetTest *t = (DisjointSetTest*) context;
+    for (size_t e = part; e < t->n_edges; e += t->parts) {
+        set_disjoint_concurrent_union(t->ds, t->edges[2 * e], t->edges[2 * e + 1]);
+    }
+}
+
+void test_set_disjoint_concurrent() {
+    printf("\n== test set_disjoint_concurrent\n\n");
+    int n = 100000;
+    size_t n_edges = 80000;
+    int *edges = (int*) malloc(2 * n_edges * sizeof(int));
+    srand(7);
+    for (size_t e = 0; e < 2 * n_edges; e++) {
+        edges[e] = rand() % n;
+    }
+    DisjointSet *expected = set_disjoint_create(n);
+    for (size_t e = 0; e < n_edges; e++) {
+        set_disjoint_union(expected, edges[2 * e], edges[2 * e + 1]);
+    }
+
+    ThreadPool *pool = thread_pool_create(4);
+    DisjointSetTest t = {set_disjoint_concurrent_create(n), edges, n_edges, 64};
+    thread_pool_run(pool, &union_part, &t, t.parts);
+    assert(set_disjoint_concurrent_size(t.ds) == n);
+
+    // the same partition, labelled by the smallest element of each set
+    int *smallest = (int*) malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        smallest[i] = n;
+    }
+    for (int i = 0; i < n; i++) {
+        int root = set_disjoint_find(expected, i);
+        smallest[root] = i < smallest[root] ? i : smallest[root];
+    }
+    for (int i = 0; i < n; i++) {
+        assert(set_disjoint_concurrent_find(t.ds, i) == smallest[set_disjoint_find(expected, i)]);
+    }
+    assert(set_disjoint_concurrent_same(t.ds, edges[0], edges[1]));
+    assert(!set_disjoint_concurrent_union(t.ds, edges[0], edges[1]));
+    printf("%d unions on %zu threads give %d sets, as the sequential ones\n",
+           (int) n_edges, thread_pool_size(pool), set_disjoint_count(expected));
+
+    free(smallest);
+    free(edges);
+    set_disjoint_free(expected);
+    set_disjoint_concurrent_free(t.ds);
+    thread_pool_free(pool);
+}
+
 
 int main(void) {
     printf("== Tests over Set data stucture");
@@ -197,6 +756,18 @@ int main(void) {
     test_set_union();
     test_set_difference();
     test_set_iterator();
+    test_set_cursor();
+    test_set_contains_many();
+    test_set_stats();
+    test_set_use_filter();
+    test_set_bitset();
+    test_set_bitset_promotion();
+    test_roaring();
+    test_set_roaring();
+    test_sorted_set();
+    test_set_small();
+    test_set_parallel();
     test_set_disjoint();
+    test_set_disjoint_concurrent();
     return 0;
 }
@@ -0,0 +1,135 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "thread-pool.h"
+#include "../utils/check_alloc.h"
+
+struct ThreadPool {
+    size_t n_threads;
+    pthread_t *threads;     // the n_threads - 1 started by the pool
+    pthread_mutex_t lock;
+    pthread_cond_t start;   // a batch began, or the pool stops
+    pthread_cond_t done;    // the last thread left the batch
+    size_t batch;           // batches begun, under lock
+    size_t busy;            // started threads still in the batch, under lock
+    bool stop;
+    ThreadPoolTask task;    // of the current batch, set under lock
+    void *context;
+    size_t n_tasks;
+    size_t next;            // atomic, next task to hand out
+};
+
+// run the tasks of the batch until none is left
+static void thread_pool__work(ThreadPool *pool) {
+    size_t i;
+    while ((i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED)) < pool->n_tasks) {
+        pool->task(pool->context, i);
+    }
+}
+
+static void* thread_pool__thread(void *arg) {
+    ThreadPool *pool = (ThreadPool*) arg;
+    size_t batch = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->batch == batch) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        batch = pool->batch;
+        pthread_mutex_unlock(&pool->lock);
+        thread_pool__work(pool);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+ThreadPool* thread_pool_create(size_t n_threads) {
+    if (n_threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads = online > 0 ? (size_t) online : 1;
+    }
+    ThreadPool *pool = (ThreadPool*) malloc(sizeof(ThreadPool));
+    check_alloc(pool);
+    pool->n_threads = n_threads;
+    pool->threads = (pthread_t*) malloc(n_threads * sizeof(pthread_t));
+    check_alloc(pool->threads);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->batch = 0;
+    pool->busy = 0;
+    pool->stop = false;
+    pool->task = NULL;
+    pool->context = NULL;
+    pool->n_tasks = 0;
+    pool->next = 0;
+    for (size_t i = 0; i + 1 < n_threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, &thread_pool__thread, pool) != 0) {
+            puts("Thread creation error.");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return pool;
+}
+
+size_t thread_pool_size(ThreadPool *pool) {
+    return pool->n_threads;
+}
+
+void thread_pool_run(ThreadPool *pool, ThreadPoolTask task, void *context, size_t n_tasks) {
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->n_tasks = n_tasks;
+    pool->next = 0;
+    pool->busy = pool->n_threads - 1;
+    pool->batch++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    thread_pool__work(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void thread_pool_free(ThreadPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 0; i + 1 < pool->n_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->threads);
+    free(pool);
+}
@@ -0,0 +1,69 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h>
+
+/**
+ * @brief A fixed set of threads running batches of tasks.
+ *
+ * thread_pool_run() hands the tasks 0 to n_tasks - 1 of a batch to the
+ * threads, the calling one included, as each of them gets free, and returns
+ * when all of them are done: splitting the work into a few more tasks than
+ * threads balances the load. The threads wait between batches, started once
+ * for the life of the pool. A pool runs one batch at a time.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * @brief Task of a batch
+ * @param context pointer given to thread_pool_run()
+ * @param task index of the task in the batch
+ */
+typedef void (*ThreadPoolTask)(void *context, size_t task);
+
+/**
+ * @brief Create a pool of threads
+ * @param n_threads threads running the tasks, the caller of thread_pool_run()
+ * included, so n_threads - 1 are started; 0 for one per online processor
+ * @return pointer to the newly created pool
+ * @ingroup DataStructureMethods
+ */
+ThreadPool* thread_pool_create(size_t n_threads);
+
+/**
+ * @brief Get the number of threads running the tasks
+ * @param pool pointer
+ * @ingroup DataStructureMethods
+ */
+size_t thread_pool_size(ThreadPool *pool);
+
+/**
+ * @brief Run a batch of tasks and wait for all of them
+ * @param pool pointer
+ * @param task function run once for each index from 0 to n_tasks - 1
+ * @param context passed to each task
+ * @param n_tasks number of tasks of the batch
+ * @ingroup DataStructureMethods
+ */
+void thread_pool_run(ThreadPool *pool, ThreadPoolTask task, void *context, size_t n_tasks);
+
+/**
+ * @brief Stop the threads and free the pool
+ * @param pool pointer
+ * @ingroup DataStructureMethods
+ */
+void thread_pool_free(ThreadPool *pool);
+
+#endif /* THREAD_POOL_H */
@@ -0,0 +1,129 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+/*
+ * Sketches against the exact structures they replace, on a stream of
+ * STREAM_LENGTH integers: half of them of skewed frequencies, the key x
+ * occurring about 1/x times as often as the key 1, and half of them drawn
+ * uniformly from a large range, the long tail of keys seen once or twice. The number of distinct keys is counted by
+ * a Set and by HyperLogLog, the occurrences by a HashTable of counters and by
+ * Count-Min, and the most frequent keys are found by sorting the counters of
+ * the HashTable and by Space-Saving.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "hyperloglog.h"
+#include "count-min.h"
+#include "space-saving.h"
+#include "../set/set.h"
+#include "../hash-table/hash-table.h"
+
+#define STREAM_LENGTH (1 << 22)
+#define UNIVERSE (1 << 24)
+#define TOP 10
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int compare_counts(const void *a, const void *b) {
+    const SpaceSavingCounter *x = (const SpaceSavingCounter*) a, *y = (const SpaceSavingCounter*) b;
+    return (x->count < y->count) - (x->count > y->count);
+}
+
+int main(void) {
+    int *stream = (int*) malloc(STREAM_LENGTH * sizeof(int));
+    srand(42);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        int r = rand() % UNIVERSE;
+        stream[i] = i % 2 == 0 ? UNIVERSE / (1 + r) : UNIVERSE + r;
+    }
+
+    printf("structure;seconds;bytes;result\n");
+    double start = now_seconds();
+    Set *set = set_create();
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        set_add(set, stream[i]);
+    }
+    int distinct = set_size(set);
+    printf("set;%.3f;%zu;%d distinct\n", now_seconds() - start, set_stats(set).bytes, distinct);
+
+    start = now_seconds();
+    HyperLogLog *h = hyperloglog_create(HYPERLOGLOG_PRECISION);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        hyperloglog_add(h, stream[i]);
+    }
+    size_t count = hyperloglog_count(h);
+    printf("hyperloglog;%.3f;%zu;%zu distinct (%+.2f%%)\n", now_seconds() - start, hyperloglog_bytes(h), count,
+           100.0 * ((double) count - distinct) / distinct);
+
+    start = now_seconds();
+    HashTable *counters = hash_table_create_with_type(1024, HASH_TABLE_OPEN_ADDRESSING);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        bool exists;
+        int c = hash_table_get(counters, stream[i], &exists);
+        hash_table_put(counters, stream[i], exists ? c + 1 : 1);
+    }
+    SpaceSavingCounter *all = (SpaceSavingCounter*) malloc(distinct * sizeof(SpaceSavingCounter));
+    HashTableCursor cursor = hash_table_cursor(counters);
+    int n = 0;
+    while (hash_table_cursor_next(&cursor)) {
+        SpaceSavingCounter c = {cursor.key, (uint64_t) cursor.value, 0};
+        all[n++] = c;
+    }
+    qsort(all, n, sizeof(SpaceSavingCounter), &compare_counts);
+    printf("hash-table;%.3f;%zu;top key %d counted %llu\n", now_seconds() - start,
+           hash_table_stats(counters).bytes, all[0].key, (unsigned long long) all[0].count);
+
+    start = now_seconds();
+    CountMin *cm = count_min_create_with_error(1e-4, 1e-3);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        count_min_add(cm, stream[i], 1);
+    }
+    double seconds = now_seconds() - start;
+    uint64_t worst = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t over = count_min_estimate(cm, all[i].key) - all[i].count;
+        worst = over > worst ? over : worst;
+    }
+    printf("count-min;%.3f;%zu;top key counted %llu, at most %llu over\n", seconds, count_min_bytes(cm),
+           (unsigned long long) count_min_estimate(cm, all[0].key), (unsigned long long) worst);
+
+    start = now_seconds();
+    SpaceSaving *s = space_saving_create(1000);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        space_saving_add(s, stream[i], 1);
+    }
+    SpaceSavingCounter top[TOP];
+    space_saving_top(s, top, TOP);
+    int matches = 0;
+    for (int i = 0; i < TOP; i++) {
+        matches += top[i].key == all[i].key;
+    }
+    printf("space-saving;%.3f;%zu;%d of the top %d keys in order\n", now_seconds() - start,
+           space_saving_bytes(s), matches, TOP);
+
+    free(all);
+    free(stream);
+    set_free(set);
+    hash_table_free(counters);
+    hyperloglog_free(h);
+    count_min_free(cm);
+    space_saving_free(s);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "count-min.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+struct CountMin {
+    size_t width;   // power of two
+    size_t depth;
+    uint64_t total;
+    // followed by the depth rows of width counters
+};
+
+static inline uint64_t* count_min__counters(const CountMin *cm) {
+    return (uint64_t*) (cm + 1);
+}
+
+// counter of the key in the row: the rows combine two halves of one hash
+static inline size_t count_min__index(const CountMin *cm, uint64_t hash, size_t row) {
+    uint32_t h1 = (uint32_t) hash, h2 = (uint32_t) (hash >> 32) | 1;
+    return row * cm->width + ((h1 + (uint32_t) row * h2) & (cm->width - 1));
+}
+
+CountMin* count_min_create(size_t width, size_t depth) {
+    width = hash_round_pow2(width > 0 ? width : 1);
+    depth = depth > 0 ? depth : 1;
+    CountMin *cm = (CountMin*) calloc(1, sizeof(CountMin) + width * depth * sizeof(uint64_t));
+    check_alloc(cm);
+    cm->width = width;
+    cm->depth = depth;
+    return cm;
+}
+
+CountMin* count_min_create_with_error(double epsilon, double delta) {
+    return count_min_create((size_t) ceil(exp(1.0) / epsilon), (size_t) ceil(log(1 / delta)));
+}
+
+CountMin* count_min_copy(const CountMin *cm) {
+    size_t bytes = count_min_bytes(cm);
+    CountMin *copy = (CountMin*) malloc(bytes);
+    check_alloc(copy);
+    memcpy(copy, cm, bytes);
+    return copy;
+}
+
+void count_min_add(CountMin *cm, int key, uint64_t count) {
+    uint64_t hash = hash_mix(key);
+    uint64_t *counters = count_min__counters(cm);
+    for (size_t row = 0; row < cm->depth; row++) {
+        counters[count_min__index(cm, hash, row)] += count;
+    }
+    cm->total += count;
+}
+
+void count_min_add_iterator(CountMin *cm, Iterator *it) {
+    while (!iterator_done(it)) {
+        count_min_add(cm, *(int*) iterator_next(it), 1);
+    }
+}
+
+uint64_t count_min_estimate(const CountMin *cm, int key) {
+    uint64_t hash = hash_mix(key);
+    const uint64_t *counters = count_min__counters(cm);
+    uint64_t estimate = UINT64_MAX;
+    for (size_t row = 0; row < cm->depth; row++) {
+        uint64_t count = counters[count_min__index(cm, hash, row)];
+        estimate = count < estimate ? count : estimate;
+    }
+    return estimate;
+}
+
+uint64_t count_min_total(const CountMin *cm) {
+    return cm->total;
+}
+
+bool count_min_merge(CountMin *cm, const CountMin *other) {
+    if (cm->width != other->width || cm->depth != other->depth) {
+        return false;
+    }
+    uint64_t *a = count_min__counters(cm);
+    const uint64_t *b = count_min__counters(other);
+    for (size_t i = 0; i < cm->width * cm->depth; i++) {
+        a[i] += b[i];
+    }
+    cm->total += other->total;
+    return true;
+}
+
+size_t count_min_bytes(const CountMin *cm) {
+    return sizeof(CountMin) + cm->width * cm->depth * sizeof(uint64_t);
+}
+
+void count_min_free(CountMin *cm) {
+    free(cm);
+}
@@ -0,0 +1,124 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef COUNT_MIN_H
+#define COUNT_MIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../iterator/iterator.h"
+
+/**
+ * @brief Estimate of the frequencies of the integers of a stream.
+ *
+ * A Count-Min sketch is a table of depth rows of width counters: each row
+ * hashes a key to one of its counters, and a key is counted in its counter
+ * of every row. Other keys add to the same counters, so the smallest of
+ * them never underestimates the frequency of the key and, with width
+ * e / epsilon and depth ln(1 / delta), overestimates it by more than
+ * epsilon times the length of the stream with a probability below delta.
+ * The memory is fixed, instead of a HashTable of a counter per key.
+ *
+ * Sketches of the same dimensions merge into the sketch of both streams by
+ * adding their counters.
+ *
+ * @see Cormode and Muthukrishnan, An improved data stream summary: the count-min sketch and its applications, 2005
+ */
+typedef struct CountMin CountMin;
+
+/**
+ * @brief Create an empty Count-Min sketch
+ * @param width counters per row, rounded up to a power of two
+ * @param depth number of rows
+ * @return pointer to the newly created sketch
+ * @ingroup DataStructureMethods
+ */
+CountMin* count_min_create(size_t width, size_t depth);
+
+/**
+ * @brief Create an empty Count-Min sketch for an error bound
+ * @param epsilon overestimate, as a fraction of the length of the stream
+ * @param delta probability of a larger overestimate
+ * @return pointer to the newly created sketch
+ * @ingroup DataStructureMethods
+ */
+CountMin* count_min_create_with_error(double epsilon, double delta);
+
+/**
+ * @brief Create a copy of the sketch
+ * @param cm sketch pointer
+ * @return pointer to the newly created sketch
+ * @ingroup DataStructureMethods
+ */
+CountMin* count_min_copy(const CountMin *cm);
+
+/**
+ * @brief Count occurrences of a key
+ * @param cm sketch pointer
+ * @param key integer key
+ * @param count number of occurrences
+ * @ingroup DataStructureMethods
+ */
+void count_min_add(CountMin *cm, int key, uint64_t count);
+
+/**
+ * @brief Count one occurrence of each integer of an iterator
+ * @param cm sketch pointer
+ * @param it iterator of int pointers, consumed
+ * @ingroup DataStructureMethods
+ */
+void count_min_add_iterator(CountMin *cm, Iterator *it);
+
+/**
+ * @brief Estimate the number of occurrences of a key
+ * @param cm sketch pointer
+ * @param key integer key
+ * @return at least the number of occurrences counted
+ * @ingroup DataStructureMethods
+ */
+uint64_t count_min_estimate(const CountMin *cm, int key);
+
+/**
+ * @brief Get the number of occurrences counted, of all keys
+ * @param cm sketch pointer
+ * @ingroup DataStructureMethods
+ */
+uint64_t count_min_total(const CountMin *cm);
+
+/**
+ * @brief Merge a sketch into another one
+ *
+ * cm then counts the occurrences counted by either sketch.
+ * @param cm sketch pointer, updated
+ * @param other sketch pointer
+ * @return false if the sketches have different dimensions, cm is unchanged
+ * @ingroup DataStructureMethods
+ */
+bool count_min_merge(CountMin *cm, const CountMin *other);
+
+/**
+ * @brief Get the memory used by the sketch
+ * @param cm sketch pointer
+ * @return bytes of the sketch and its counters
+ * @ingroup DataStructureMethods
+ */
+size_t count_min_bytes(const CountMin *cm);
+
+/**
+ * @brief Free memory of the sketch
+ * @param cm sketch pointer
+ * @ingroup DataStructureMethods
+ */
+void count_min_free(CountMin *cm);
+
+#endif /* COUNT_MIN_H */
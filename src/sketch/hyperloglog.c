@@ -0,0 +1,133 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "hyperloglog.h"
+#include "../utils/check_alloc.h"
+#include "../utils/hash.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define MIN_PRECISION 4
+#define MAX_PRECISION 18
+
+struct HyperLogLog {
+    int precision;
+    size_t m;  // registers, 2^precision
+    // followed by the m registers of a byte
+};
+
+static inline uint8_t* hyperloglog__registers(const HyperLogLog *h) {
+    return (uint8_t*) (h + 1);
+}
+
+HyperLogLog* hyperloglog_create(int precision) {
+    if (precision < MIN_PRECISION || precision > MAX_PRECISION) {
+        printf("HyperLogLog precision must be from %d to %d.\n", MIN_PRECISION, MAX_PRECISION);
+        exit(EXIT_FAILURE);
+    }
+    size_t m = (size_t) 1 << precision;
+    HyperLogLog *h = (HyperLogLog*) calloc(1, sizeof(HyperLogLog) + m);
+    check_alloc(h);
+    h->precision = precision;
+    h->m = m;
+    return h;
+}
+
+HyperLogLog* hyperloglog_copy(const HyperLogLog *h) {
+    size_t bytes = hyperloglog_bytes(h);
+    HyperLogLog *copy = (HyperLogLog*) malloc(bytes);
+    check_alloc(copy);
+    memcpy(copy, h, bytes);
+    return copy;
+}
+
+void hyperloglog_add(HyperLogLog *h, int key) {
+    uint64_t hash = hash_mix(key);
+    size_t index = hash >> (64 - h->precision);
+    // the guard bit bounds the rank when the remaining bits are all zero
+    uint64_t rest = hash << h->precision | (uint64_t) 1 << (h->precision - 1);
+    uint8_t rank = (uint8_t) (__builtin_clzll(rest) + 1);
+    uint8_t *registers = hyperloglog__registers(h);
+    if (rank > registers[index]) {
+        registers[index] = rank;
+    }
+}
+
+void hyperloglog_add_iterator(HyperLogLog *h, Iterator *it) {
+    while (!iterator_done(it)) {
+        hyperloglog_add(h, *(int*) iterator_next(it));
+    }
+}
+
+size_t hyperloglog_count(const HyperLogLog *h) {
+    const uint8_t *registers = hyperloglog__registers(h);
+    double m = (double) h->m, sum = 0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < h->m; i++) {
+        sum += ldexp(1.0, -registers[i]);
+        zeros += registers[i] == 0;
+    }
+    double alpha = h->m == 16 ? 0.673 : h->m == 32 ? 0.697 : h->m == 64 ? 0.709 : 0.7213 / (1 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log(m / zeros);
+    }
+    return (size_t) (estimate + 0.5);
+}
+
+bool hyperloglog_merge(HyperLogLog *h, const HyperLogLog *other) {
+    if (h->precision != other->precision) {
+        return false;
+    }
+    uint8_t *a = hyperloglog__registers(h);
+    const uint8_t *b = hyperloglog__registers(other);
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= h->m; i += 32) {
+        __m256i x = _mm256_max_epu8(_mm256_loadu_si256((const __m256i*) (a + i)),
+                                    _mm256_loadu_si256((const __m256i*) (b + i)));
+        _mm256_storeu_si256((__m256i*) (a + i), x);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= h->m; i += 16) {
+        __m128i x = _mm_max_epu8(_mm_loadu_si128((const __m128i*) (a + i)),
+                                 _mm_loadu_si128((const __m128i*) (b + i)));
+        _mm_storeu_si128((__m128i*) (a + i), x);
+    }
+#endif
+    for (; i < h->m; i++) {
+        a[i] = a[i] > b[i] ? a[i] : b[i];
+    }
+    return true;
+}
+
+int hyperloglog_precision(const HyperLogLog *h) {
+    return h->precision;
+}
+
+size_t hyperloglog_bytes(const HyperLogLog *h) {
+    return sizeof(HyperLogLog) + h->m;
+}
+
+void hyperloglog_free(HyperLogLog *h) {
+    free(h);
+}
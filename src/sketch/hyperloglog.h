@@ -0,0 +1,121 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef HYPERLOGLOG_H
+#define HYPERLOGLOG_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "../iterator/iterator.h"
+
+/**
+ * @brief Default precision of a HyperLogLog: 2^14 registers of a byte.
+ *
+ * The standard error of the count is about 1.04 / sqrt(2^precision):
+ * 0.81% with 16 KB at 14, 1.6% with 4 KB at 12.
+ */
+#ifndef HYPERLOGLOG_PRECISION
+#define HYPERLOGLOG_PRECISION 14
+#endif
+
+/**
+ * @brief Estimate of the number of distinct integers of a stream.
+ *
+ * Each key is hashed, the first precision bits of the hash pick a register
+ * which keeps the longest run of leading zeros seen in the other bits. The
+ * registers take a fixed memory, 2^precision bytes, whatever the length of
+ * the stream and the number of distinct keys, instead of a Set of all of
+ * them. Small counts are estimated by linear counting of the empty
+ * registers.
+ *
+ * Sketches of the same precision merge into the sketch of both streams,
+ * register by register (32 at a time with AVX2, 16 with SSE2): each thread
+ * can count a part of a stream in its own sketch.
+ *
+ * @see Flajolet et al., HyperLogLog: the analysis of a near-optimal cardinality estimation algorithm, 2007
+ */
+typedef struct HyperLogLog HyperLogLog;
+
+/**
+ * @brief Create an empty HyperLogLog
+ * @param precision log2 of the number of registers, from 4 to 18, as
+ * HYPERLOGLOG_PRECISION
+ * @return pointer to the newly created sketch
+ * @ingroup DataStructureMethods
+ */
+HyperLogLog* hyperloglog_create(int precision);
+
+/**
+ * @brief Create a copy of the sketch
+ * @param h sketch pointer
+ * @return pointer to the newly created sketch
+ * @ingroup DataStructureMethods
+ */
+HyperLogLog* hyperloglog_copy(const HyperLogLog *h);
+
+/**
+ * @brief Add a key to the sketch
+ * @param h sketch pointer
+ * @param key integer key
+ * @ingroup DataStructureMethods
+ */
+void hyperloglog_add(HyperLogLog *h, int key);
+
+/**
+ * @brief Add the integers of an iterator to the sketch
+ * @param h sketch pointer
+ * @param it iterator of int pointers, consumed
+ * @ingroup DataStructureMethods
+ */
+void hyperloglog_add_iterator(HyperLogLog *h, Iterator *it);
+
+/**
+ * @brief Estimate the number of distinct keys added
+ * @param h sketch pointer
+ * @ingroup DataStructureMethods
+ */
+size_t hyperloglog_count(const HyperLogLog *h);
+
+/**
+ * @brief Merge a sketch into another one
+ *
+ * h then counts the keys added to either sketch.
+ * @param h sketch pointer, updated
+ * @param other sketch pointer
+ * @return false if the sketches have different precisions, h is unchanged
+ * @ingroup DataStructureMethods
+ */
+bool hyperloglog_merge(HyperLogLog *h, const HyperLogLog *other);
+
+/**
+ * @brief Get the precision of the sketch
+ * @param h sketch pointer
+ * @ingroup DataStructureMethods
+ */
+int hyperloglog_precision(const HyperLogLog *h);
+
+/**
+ * @brief Get the memory used by the sketch
+ * @param h sketch pointer
+ * @return bytes of the sketch and its registers
+ * @ingroup DataStructureMethods
+ */
+size_t hyperloglog_bytes(const HyperLogLog *h);
+
+/**
+ * @brief Free memory of the sketch
+ * @param h sketch pointer
+ * @ingroup DataStructureMethods
+ */
+void hyperloglog_free(HyperLogLog *h);
+
+#endif /* HYPERLOGLOG_H */
@@ -0,0 +1,209 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "space-saving.h"
+#include "../hash-table/hash-table.h"
+#include "../utils/check_alloc.h"
+
+struct SpaceSaving {
+    size_t k;
+    size_t size;               // keys monitored
+    uint64_t total;
+    SpaceSavingCounter *heap;  // k counters, the least count at the root
+    HashTable *index;          // position of each key monitored in the heap
+};
+
+static HashTable* space_saving__index_create(size_t k) {
+    return hash_table_create_with_type(2 * k, HASH_TABLE_OPEN_ADDRESSING);
+}
+
+SpaceSaving* space_saving_create(size_t k) {
+    SpaceSaving *s = (SpaceSaving*) malloc(sizeof(SpaceSaving));
+    check_alloc(s);
+    s->k = k > 0 ? k : 1;
+    s->size = 0;
+    s->total = 0;
+    s->heap = (SpaceSavingCounter*) malloc(s->k * sizeof(SpaceSavingCounter));
+    check_alloc(s->heap);
+    s->index = space_saving__index_create(s->k);
+    return s;
+}
+
+SpaceSaving* space_saving_copy(const SpaceSaving *s) {
+    SpaceSaving *copy = (SpaceSaving*) malloc(sizeof(SpaceSaving));
+    check_alloc(copy);
+    *copy = *s;
+    copy->heap = (SpaceSavingCounter*) malloc(s->k * sizeof(SpaceSavingCounter));
+    check_alloc(copy->heap);
+    memcpy(copy->heap, s->heap, s->size * sizeof(SpaceSavingCounter));
+    copy->index = hash_table_copy(s->index);
+    return copy;
+}
+
+// move the counter at i down to its place, the index follows the counters moved
+static void space_saving__sift_down(SpaceSaving *s, size_t i) {
+    SpaceSavingCounter c = s->heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= s->size) {
+            break;
+        }
+        if (child + 1 < s->size && s->heap[child + 1].count < s->heap[child].count) {
+            child++;
+        }
+        if (s->heap[child].count >= c.count) {
+            break;
+        }
+        s->heap[i] = s->heap[child];
+        hash_table_put(s->index, s->heap[i].key, (int) i);
+        i = child;
+    }
+    s->heap[i] = c;
+    hash_table_put(s->index, c.key, (int) i);
+}
+
+static void space_saving__sift_up(SpaceSaving *s, size_t i) {
+    SpaceSavingCounter c = s->heap[i];
+    while (i > 0 && s->heap[(i - 1) / 2].count > c.count) {
+        s->heap[i] = s->heap[(i - 1) / 2];
+        hash_table_put(s->index, s->heap[i].key, (int) i);
+        i = (i - 1) / 2;
+    }
+    s->heap[i] = c;
+    hash_table_put(s->index, c.key, (int) i);
+}
+
+void space_saving_add(SpaceSaving *s, int key, uint64_t count) {
+    s->total += count;
+    bool exists;
+    int i = hash_table_get(s->index, key, &exists);
+    if (exists) {
+        s->heap[i].count += count;
+        space_saving__sift_down(s, (size_t) i);
+        return;
+    }
+    if (s->size < s->k) {
+        SpaceSavingCounter c = {key, count, 0};
+        s->heap[s->size++] = c;
+        space_saving__sift_up(s, s->size - 1);
+        return;
+    }
+    // the least counted key gives its counter away, its count bounds the
+    // occurrences of the new key missed so far
+    SpaceSavingCounter *least = &s->heap[0];
+    hash_table_remove(s->index, least->key);
+    least->key = key;
+    least->error = least->count;
+    least->count += count;
+    space_saving__sift_down(s, 0);
+}
+
+void space_saving_add_iterator(SpaceSaving *s, Iterator *it) {
+    while (!iterator_done(it)) {
+        space_saving_add(s, *(int*) iterator_next(it), 1);
+    }
+}
+
+// count of a key missing from a summary: the least count once it is full
+static uint64_t space_saving__least(const SpaceSaving *s) {
+    return s->size == s->k ? s->heap[0].count : 0;
+}
+
+uint64_t space_saving_estimate(const SpaceSaving *s, int key, uint64_t *error) {
+    bool exists;
+    int i = hash_table_get(s->index, key, &exists);
+    uint64_t count = exists ? s->heap[i].count : space_saving__least(s);
+    if (error != NULL) {
+        *error = exists ? s->heap[i].error : count;
+    }
+    return count;
+}
+
+// increasing count, then decreasing key
+static int space_saving__compare(const void *a, const void *b) {
+    const SpaceSavingCounter *x = (const SpaceSavingCounter*) a, *y = (const SpaceSavingCounter*) b;
+    if (x->count != y->count) {
+        return x->count < y->count ? -1 : 1;
+    }
+    return (x->key < y->key) - (x->key > y->key);
+}
+
+size_t space_saving_top(const SpaceSaving *s, SpaceSavingCounter *top, size_t n) {
+    SpaceSavingCounter *sorted = (SpaceSavingCounter*) malloc((s->size + 1) * sizeof(SpaceSavingCounter));
+    check_alloc(sorted);
+    memcpy(sorted, s->heap, s->size * sizeof(SpaceSavingCounter));
+    qsort(sorted, s->size, sizeof(SpaceSavingCounter), &space_saving__compare);
+    n = n < s->size ? n : s->size;
+    for (size_t i = 0; i < n; i++) {
+        top[i] = sorted[s->size - 1 - i];
+    }
+    free(sorted);
+    return n;
+}
+
+size_t space_saving_size(const SpaceSaving *s) {
+    return s->size;
+}
+
+uint64_t space_saving_total(const SpaceSaving *s) {
+    return s->total;
+}
+
+void space_saving_merge(SpaceSaving *s, const SpaceSaving *other) {
+    uint64_t least = space_saving__least(s), other_least = space_saving__least(other);
+    size_t n = s->size;
+    SpaceSavingCounter *all = (SpaceSavingCounter*) malloc((s->size + other->size + 1) * sizeof(SpaceSavingCounter));
+    check_alloc(all);
+    // the counters of s keep their position in the heap, as in the index
+    for (size_t i = 0; i < s->size; i++) {
+        all[i] = s->heap[i];
+        all[i].count += other_least;
+        all[i].error += other_least;
+    }
+    for (size_t j = 0; j < other->size; j++) {
+        const SpaceSavingCounter *c = &other->heap[j];
+        bool exists;
+        int i = hash_table_get(s->index, c->key, &exists);
+        if (exists) {
+            all[i].count += c->count - other_least;
+            all[i].error += c->error - other_least;
+        } else {
+            SpaceSavingCounter merged = {c->key, c->count + least, c->error + least};
+            all[n++] = merged;
+        }
+    }
+
+    // the k largest counts, in increasing order: already a heap
+    qsort(all, n, sizeof(SpaceSavingCounter), &space_saving__compare);
+    size_t first = n > s->k ? n - s->k : 0;
+    s->size = n - first;
+    memcpy(s->heap, all + first, s->size * sizeof(SpaceSavingCounter));
+    hash_table_free(s->index);
+    s->index = space_saving__index_create(s->k);
+    for (size_t i = 0; i < s->size; i++) {
+        hash_table_put(s->index, s->heap[i].key, (int) i);
+    }
+    s->total += other->total;
+    free(all);
+}
+
+size_t space_saving_bytes(const SpaceSaving *s) {
+    return sizeof(SpaceSaving) + s->k * sizeof(SpaceSavingCounter) + hash_table_stats(s->index).bytes;
+}
+
+void space_saving_free(SpaceSaving *s) {
+    hash_table_free(s->index);
+    free(s->heap);
+    free(s);
+}
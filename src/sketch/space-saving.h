@@ -0,0 +1,146 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef SPACE_SAVING_H
+#define SPACE_SAVING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../iterator/iterator.h"
+
+/**
+ * @brief Counter of a key monitored by a SpaceSaving summary.
+ *
+ * The key occurred from count - error to count times.
+ */
+typedef struct SpaceSavingCounter {
+    int key;
+    uint64_t count;  /**< occurrences counted, at least the real ones */
+    uint64_t error;  /**< most by which count exceeds the real occurrences */
+} SpaceSavingCounter;
+
+/**
+ * @brief The most frequent integers of a stream, the heavy hitters.
+ *
+ * A Space-Saving summary monitors k keys with a counter each. A key not
+ * monitored takes the counter of the least counted key, and inherits its
+ * count as error: every key occurring more than 1/k of the stream is
+ * monitored, and its count exceeds its occurrences by at most the length of
+ * the stream divided by k. The counters are kept in a min-heap indexed by
+ * a HashTable, the memory is fixed by k instead of a counter per key.
+ *
+ * Summaries merge into a summary of both streams, keeping the k largest
+ * counts, with the error bounds of both.
+ *
+ * @see Metwally et al., Efficient computation of frequent and top-k elements in data streams, 2005
+ * @see Agarwal et al., Mergeable summaries, 2012
+ */
+typedef struct SpaceSaving SpaceSaving;
+
+/**
+ * @brief Create an empty Space-Saving summary
+ * @param k number of keys monitored
+ * @return pointer to the newly created summary
+ * @ingroup DataStructureMethods
+ */
+SpaceSaving* space_saving_create(size_t k);
+
+/**
+ * @brief Create a copy of the summary
+ * @param s summary pointer
+ * @return pointer to the newly created summary
+ * @ingroup DataStructureMethods
+ */
+SpaceSaving* space_saving_copy(const SpaceSaving *s);
+
+/**
+ * @brief Count occurrences of a key
+ * @param s summary pointer
+ * @param key integer key
+ * @param count number of occurrences
+ * @ingroup DataStructureMethods
+ */
+void space_saving_add(SpaceSaving *s, int key, uint64_t count);
+
+/**
+ * @brief Count one occurrence of each integer of an iterator
+ * @param s summary pointer
+ * @param it iterator of int pointers, consumed
+ * @ingroup DataStructureMethods
+ */
+void space_saving_add_iterator(SpaceSaving *s, Iterator *it);
+
+/**
+ * @brief Estimate the number of occurrences of a key
+ * @param s summary pointer
+ * @param key integer key
+ * @param error if not NULL, set to the most by which the estimate exceeds
+ * the occurrences
+ * @return at least the occurrences of the key: its count if monitored,
+ * the least count of the full summary otherwise
+ * @ingroup DataStructureMethods
+ */
+uint64_t space_saving_estimate(const SpaceSaving *s, int key, uint64_t *error);
+
+/**
+ * @brief Get the most counted keys
+ * @param s summary pointer
+ * @param top array of at least n counters, filled by decreasing count
+ * @param n number of keys wanted
+ * @return number of counters written, at most the keys monitored
+ * @ingroup DataStructureMethods
+ */
+size_t space_saving_top(const SpaceSaving *s, SpaceSavingCounter *top, size_t n);
+
+/**
+ * @brief Get the number of keys monitored, at most k
+ * @param s summary pointer
+ * @ingroup DataStructureMethods
+ */
+size_t space_saving_size(const SpaceSaving *s);
+
+/**
+ * @brief Get the number of occurrences counted, of all keys
+ * @param s summary pointer
+ * @ingroup DataStructureMethods
+ */
+uint64_t space_saving_total(const SpaceSaving *s);
+
+/**
+ * @brief Merge a summary into another one
+ *
+ * s then summarizes the occurrences counted by either summary, with the k
+ * of s. A key monitored by one summary only is counted in the other one as
+ * the least count of the other one, if full.
+ * @param s summary pointer, updated
+ * @param other summary pointer
+ * @ingroup DataStructureMethods
+ */
+void space_saving_merge(SpaceSaving *s, const SpaceSaving *other);
+
+/**
+ * @brief Get the memory used by the summary
+ * @param s summary pointer
+ * @return bytes of the summary, its counters and their index
+ * @ingroup DataStructureMethods
+ */
+size_t space_saving_bytes(const SpaceSaving *s);
+
+/**
+ * @brief Free memory of the summary
+ * @param s summary pointer
+ * @ingroup DataStructureMethods
+ */
+void space_saving_free(SpaceSaving *s);
+
+#endif /* SPACE_SAVING_H */
@@ -0,0 +1,223 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <assert.h>
+#include "hyperloglog.h"
+#include "count-min.h"
+#include "space-saving.h"
+#include "../list/single/list.h"
+
+#define N_KEYS 100000
+#define N_HEAVY 10
+
+static double relative_error(size_t estimate, size_t real) {
+    return fabs((double) estimate - (double) real) / (double) real;
+}
+
+// the stream of the frequency tests: the heavy key i occurs 1000 * (i + 1)
+// times, the others once, in an order mixing both
+static int stream_key(int i) {
+    int heavy_part = 1000 * N_HEAVY * (N_HEAVY + 1) / 2;
+    if (i % 2 == 0 && i / 2 < heavy_part) {
+        int j = i / 2, key = 0;
+        while (j >= 1000 * (key + 1)) {
+            j -= 1000 * (key + 1);
+            key++;
+        }
+        return key;
+    }
+    return N_HEAVY + i;
+}
+
+static uint64_t stream_count(int key, int n) {
+    if (key < N_HEAVY) {
+        return 1000 * (uint64_t) (key + 1);
+    }
+    return key - N_HEAVY < n && stream_key(key - N_HEAVY) == key;
+}
+
+#define STREAM_LENGTH (2 * 1000 * N_HEAVY * (N_HEAVY + 1) / 2 + 20000)
+
+void test_hyperloglog() {
+    puts("== hyperloglog: count, merge and iterator adapter");
+    HyperLogLog *h = hyperloglog_create(HYPERLOGLOG_PRECISION);
+    HyperLogLog *even = hyperloglog_create(HYPERLOGLOG_PRECISION);
+    HyperLogLog *odd = hyperloglog_create(HYPERLOGLOG_PRECISION);
+    assert(hyperloglog_count(h) == 0);
+    for (int i = 0; i < 1000; i++) {
+        hyperloglog_add(h, i);
+    }
+    printf("1000 keys counted as %zu\n", hyperloglog_count(h));
+    assert(relative_error(hyperloglog_count(h), 1000) < 0.02);
+    for (int r = 0; r < 2; r++) {
+        for (int i = 0; i < N_KEYS; i++) {
+            hyperloglog_add(h, i);
+            hyperloglog_add(i % 2 == 0 ? even : odd, i);
+        }
+    }
+    size_t count = hyperloglog_count(h);
+    printf("%d keys counted as %zu in %zu bytes\n", N_KEYS, count, hyperloglog_bytes(h));
+    assert(relative_error(count, N_KEYS) < 0.03);
+
+    // registers of a merge are those of the sketch of both streams
+    assert(relative_error(hyperloglog_count(even), N_KEYS / 2) < 0.03);
+    bool merged = hyperloglog_merge(even, odd);
+    assert(merged && hyperloglog_count(even) == count);
+    HyperLogLog *other = hyperloglog_create(HYPERLOGLOG_PRECISION - 1);
+    assert(!hyperloglog_merge(even, other));
+    hyperloglog_free(other);
+
+    HyperLogLog *copy = hyperloglog_copy(h);
+    List *l = list_create();
+    for (int i = 0; i < 1000; i++) {
+        l = list_insert(l, -(i % 500) - 1);
+    }
+    Iterator *it = list_iterator_data(l);
+    hyperloglog_add_iterator(copy, it);
+    iterator_free(it);
+    for (int i = 0; i < 500; i++) {
+        hyperloglog_add(h, -i - 1);
+    }
+    assert(hyperloglog_count(copy) == hyperloglog_count(h));
+    list_free(l);
+    hyperloglog_free(copy);
+    hyperloglog_free(h);
+    hyperloglog_free(even);
+    hyperloglog_free(odd);
+}
+
+void test_count_min() {
+    puts("== count-min: overestimates bounded by the error, merge and iterator adapter");
+    double epsilon = 0.001, delta = 0.01;
+    CountMin *cm = count_min_create_with_error(epsilon, delta);
+    CountMin *first = count_min_copy(cm), *second = count_min_copy(cm);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        count_min_add(cm, stream_key(i), 1);
+        count_min_add(i < STREAM_LENGTH / 2 ? first : second, stream_key(i), 1);
+    }
+    assert(count_min_total(cm) == STREAM_LENGTH);
+    int over_bound = 0, n_keys = STREAM_LENGTH;
+    for (int key = 0; key < N_HEAVY + n_keys; key++) {
+        uint64_t real = stream_count(key, n_keys), estimate = count_min_estimate(cm, key);
+        assert(estimate >= real);
+        over_bound += estimate > real + epsilon * STREAM_LENGTH;
+    }
+    printf("%d of %d keys over the error bound, %zu bytes\n", over_bound, N_HEAVY + n_keys, count_min_bytes(cm));
+    assert(over_bound <= delta * (N_HEAVY + n_keys));
+
+    bool merged = count_min_merge(first, second);
+    assert(merged);
+    for (int key = 0; key < N_HEAVY + 1000; key++) {
+        assert(count_min_estimate(first, key) == count_min_estimate(cm, key));
+    }
+    assert(count_min_total(first) == STREAM_LENGTH);
+    CountMin *other = count_min_create(16, 2);
+    assert(!count_min_merge(first, other));
+    count_min_free(other);
+
+    // the adapter counts what the adds would
+    CountMin *direct = count_min_create(64, 4), *adapted = count_min_create(64, 4);
+    List *l = list_create();
+    for (int i = 0; i < 100; i++) {
+        l = list_insert(l, i % 3);
+        count_min_add(direct, i % 3, 1);
+    }
+    Iterator *it = list_iterator_data(l);
+    count_min_add_iterator(adapted, it);
+    iterator_free(it);
+    for (int key = 0; key < 3; key++) {
+        assert(count_min_estimate(adapted, key) == count_min_estimate(direct, key));
+    }
+    list_free(l);
+    count_min_free(direct);
+    count_min_free(adapted);
+    count_min_free(cm);
+    count_min_free(first);
+    count_min_free(second);
+}
+
+// the k counters are the heavy keys by decreasing count, with bounds holding
+// their occurrences
+static void check_heavy_hitters(const SpaceSaving *s) {
+    SpaceSavingCounter top[N_HEAVY];
+    assert(space_saving_top(s, top, N_HEAVY) == N_HEAVY);
+    for (int i = 0; i < N_HEAVY; i++) {
+        int key = N_HEAVY - 1 - i;
+        uint64_t real = stream_count(key, STREAM_LENGTH), error;
+        assert(top[i].key == key);
+        assert(space_saving_estimate(s, key, &error) == top[i].count);
+        assert(top[i].count >= real && top[i].count - top[i].error <= real);
+        assert(error == top[i].error);
+    }
+    for (int key = N_HEAVY; key < N_HEAVY + 1000; key++) {
+        uint64_t error, estimate = space_saving_estimate(s, key, &error);
+        assert(estimate >= stream_count(key, STREAM_LENGTH));
+        assert(estimate - error <= stream_count(key, STREAM_LENGTH));
+    }
+}
+
+void test_space_saving() {
+    puts("== space-saving: heavy hitters, merge and iterator adapter");
+    size_t k = 200;
+    SpaceSaving *s = space_saving_create(k);
+    SpaceSaving *first = space_saving_create(k), *second = space_saving_create(k);
+    SpaceSavingCounter top[N_HEAVY];
+    assert(space_saving_top(s, top, N_HEAVY) == 0);
+    for (int i = 0; i < STREAM_LENGTH; i++) {
+        space_saving_add(s, stream_key(i), 1);
+        space_saving_add(i % 2 == 0 ? first : second, stream_key(i), 1);
+    }
+    assert(space_saving_size(s) == k);
+    assert(space_saving_total(s) == STREAM_LENGTH);
+    printf("%d occurrences summarized in %zu bytes\n", STREAM_LENGTH, space_saving_bytes(s));
+    check_heavy_hitters(s);
+
+    SpaceSaving *copy = space_saving_copy(first);
+    space_saving_merge(first, second);
+    assert(space_saving_size(first) == k);
+    assert(space_saving_total(first) == STREAM_LENGTH);
+    check_heavy_hitters(first);
+
+    // a summary not full merges exactly
+    SpaceSaving *small = space_saving_create(k);
+    List *l = list_create();
+    for (int i = 0; i < 30; i++) {
+        l = list_insert(l, -(i % 3) - 1);
+    }
+    Iterator *it = list_iterator_data(l);
+    space_saving_add_iterator(small, it);
+    iterator_free(it);
+    space_saving_merge(small, small);
+    uint64_t error;
+    assert(space_saving_size(small) == 3);
+    assert(space_saving_estimate(small, -2, &error) == 20 && error == 0);
+    assert(space_saving_estimate(small, 5, &error) == 0 && error == 0);
+    space_saving_merge(copy, small);
+    assert(space_saving_estimate(copy, -1, NULL) >= 20);
+
+    list_free(l);
+    space_saving_free(small);
+    space_saving_free(copy);
+    space_saving_free(s);
+    space_saving_free(first);
+    space_saving_free(second);
+}
+
+int main(void) {
+    test_hyperloglog();
+    test_count_min();
+    test_space_saving();
+    return 0;
+}
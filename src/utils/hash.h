@@ -0,0 +1,93 @@
+/**
+ * ================================================
+ *
+ *         Copyright 2025 Manoel Vilela
+ *
+ *         Author: Manoel Vilela
+ *        Contact: manoel_vilela@engineer.com
+ *   Organization: ITA
+ *
+ * ===============================================
+ */
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief A hash function of integer keys.
+ *
+ * Hash tables index buckets with the low bits of the hash (the number of
+ * buckets is always a power of two), so every bit of the output should
+ * depend on every bit of the key.
+ */
+typedef uint64_t (*HashFunction)(int key);
+
+/**
+ * @brief MurmurHash3 finalizer of a 64-bit word, a bijection.
+ *
+ * Each input bit flips about half of the output bits.
+ * @see https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+ */
+static inline uint64_t hash_mix64(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * @brief Default hash: avalanche mixer of an integer key.
+ *
+ * This is the finalizer of MurmurHash3: each input bit flips about half of
+ * the output bits, so sequential and strided keys spread over all buckets.
+ * Negative keys, including INT_MIN, are hashed by their bit pattern.
+ */
+static inline uint64_t hash_mix(int key) {
+    return hash_mix64((uint32_t) key);
+}
+
+/**
+ * @brief Identity hash of an integer key.
+ *
+ * Cheapest option, it keeps dense keys in order and in separate buckets,
+ * but strided keys collide on the same few buckets.
+ */
+static inline uint64_t hash_identity(int key) {
+    return (uint32_t) key;
+}
+
+/**
+ * @brief Hash with the default mixer when \p hash is NULL.
+ *
+ * Tables store NULL for the default, so the default hash is inlined
+ * instead of called through a pointer.
+ */
+static inline uint64_t hash_apply(HashFunction hash, int key) {
+    return hash == NULL ? hash_mix(key) : hash(key);
+}
+
+/**
+ * @brief Map a 32-bit hash to [0, n) with a multiplication instead of a modulo.
+ * @see https://lemire.me/blog/2016/06/27/a-fast-alternative-to-the-modulo-reduction/
+ */
+static inline size_t hash_range(uint32_t h, uint32_t n) {
+    return (size_t)(((uint64_t) h * n) >> 32);
+}
+
+/**
+ * @brief Round \p n up to a power of two (minimum 1).
+ */
+static inline size_t hash_round_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+#endif